@@ -80,6 +80,9 @@ extern "C" int main(void)
     uint32_t lastSendTime = 0;
     while (1)
     {
+        // 处理接收队列（回调在这里执行，不在中断里）
+        g_wireless.poll();
+
         // 每秒发送一次心跳消息
         if (HAL_GetTick() - lastSendTime > 1000)
         {
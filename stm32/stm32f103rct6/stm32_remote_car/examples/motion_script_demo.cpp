@@ -0,0 +1,234 @@
+/**
+ * @file    motion_script_demo.cpp
+ * @brief   运动脚本示例 - 非阻塞执行固定动作序列，同时巡线和接收蓝牙
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * 与 drive_train_demo.cpp / spot_turn_tuning.cpp 中 drive() + HAL_Delay() 的写法不同，
+ * 这里的动作序列是字节码，由 MotionScript 在每个控制周期推进一步，
+ * 主循环始终在读传感器、巡线、处理蓝牙数据。
+ *
+ * 操作：
+ * 1. 先用主程序完成传感器校准（EEPROM 0x40）
+ * 2. 上电后若EEPROM中有脚本（0xC0）则使用它，否则使用下面内置的 DEMO_SCRIPT
+ * 3. 短按按钮（PD2）开始/中止脚本；脚本未运行时小车正常巡线
+ * 4. 通过蓝牙（USART2）上传新脚本：
+ *      python tools/motion_script_asm.py my.ms --port COM5 --save --run
+ */
+
+#include "bluetooth_control.hpp"
+#include "button.hpp"
+#include "debug.hpp"
+#include "drive_train.hpp"
+#include "e49_wireless.hpp"
+#include "eeprom.hpp"
+#include "gpio.h"
+#include "adc.h"
+#include "i2c.h"
+#include "line_follower_pid.hpp"
+#include "line_sensor.hpp"
+#include "motion_arbiter.hpp"
+#include "motion_script.hpp"
+#include "motor.hpp"
+#include "motor_calibration.hpp"
+#include "pose_estimator.hpp"
+#include "remote_control.hpp"
+#include "spot_turn_calibration.hpp"
+#include "stm32f1xx_hal.h"
+#include "supply_monitor.hpp"
+#include "tim.h"
+#include "usart.h"
+
+extern "C" {
+void SystemClock_Config(void);
+}
+
+/* ========== HAL回调 ========== */
+
+/**
+ * @brief 串口接收事件（DMA半满/满/空闲线）：转发给蓝牙控制
+ */
+extern "C" void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef* huart, uint16_t Size) {
+    BluetoothControl* bt = BluetoothControl::instance();
+    if (bt != nullptr) {
+        bt->onRxEventFromISR(huart, Size);
+    }
+}
+
+/**
+ * @brief 串口错误：蓝牙串口重新启动DMA接收，其他串口在这里各自处理
+ */
+extern "C" void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart) {
+    BluetoothControl* bt = BluetoothControl::instance();
+    if (bt != nullptr) {
+        bt->onRxErrorFromISR(huart);
+    }
+}
+
+/* ========== 内置脚本（Flash） ========== */
+
+/**
+ * 巡线到第一个标记 → 前进离开标记 → 原地左转找到下一条线 → 巡线到标记 → 重复2次 → 后退停车
+ *
+ * 源码（tools/motion_script_asm.py）：
+ *   REPEAT 2
+ *     FOLLOW_TO_MARKER 20000
+ *     DRIVE_DIST 30 0 80
+ *     SPOT_UNTIL_LINE 35 4000
+ *   NEXT
+ *   WAIT 500
+ *   DRIVE_TIME -30 0 800
+ *   END
+ */
+static const uint8_t DEMO_SCRIPT[] = {
+    0x07, 0x02,                    // REPEAT 2
+    0x05, 0x20, 0x4E,              //   FOLLOW_TO_MARKER 20000ms
+    0x02, 0x1E, 0x00, 0x50, 0x00,  //   DRIVE_DIST 30% 80mm
+    0x04, 0x23, 0xA0, 0x0F,        //   SPOT_UNTIL_LINE 35% 4000ms
+    0x08,                          // NEXT
+    0x06, 0xF4, 0x01,              // WAIT 500ms
+    0x01, 0xE2, 0x00, 0x20, 0x03,  // DRIVE_TIME -30% 800ms
+    0x00,                          // END
+};
+
+/// 同时在线上的传感器数达到该值视为标记（横线）
+constexpr uint8_t MARKER_MIN_SENSORS = 6;
+
+/* ========== 全局对象 ========== */
+
+Motor motor_lf, motor_lr, motor_rf, motor_rr;
+LineSensor line_sensor;
+EEPROM eeprom;
+Button button(GPIOD, GPIO_PIN_2, ButtonMode::PULL_UP, 200);
+PoseEstimator pose;
+SupplyMonitor supply;
+
+/**
+ * @brief 由巡线控制器本周期的二值化结果生成脚本输入
+ */
+MotionScript::Inputs readScriptInputs(const LineFollowerPID& follower) {
+    bool binary[8];
+    follower.getLastBinaryData(binary);
+    uint8_t on_line = 0;
+    for (bool b : binary) {
+        on_line += b ? 1 : 0;
+    }
+    MotionScript::Inputs inputs;
+    inputs.line_seen = on_line > 0;
+    inputs.marker = on_line >= MARKER_MIN_SENSORS;
+    return inputs;
+}
+
+/* ========== 主程序 ========== */
+
+extern "C" int main(void) {
+    HAL_Init();
+    SystemClock_Config();
+
+    MX_GPIO_Init();
+    MX_TIM3_Init();
+    MX_I2C2_Init();
+    MX_USART1_UART_Init();
+    MX_USART2_UART_Init();
+    MX_ADC1_Init();
+
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_1);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_2);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_3);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_4);
+
+    motor_lf.init(&htim3, TIM_CHANNEL_1);
+    motor_lr.init(&htim3, TIM_CHANNEL_3);
+    motor_rf.init(&htim3, TIM_CHANNEL_2);
+    motor_rr.init(&htim3, TIM_CHANNEL_4);
+
+    button.init();
+    eeprom.init();
+
+    MotorCalibrationData motor_calib;
+    if (MotorCalibration::load(eeprom, motor_calib)) {
+        MotorCalibration::apply(motor_calib, motor_lf);
+        MotorCalibration::apply(motor_calib, motor_lr);
+        MotorCalibration::apply(motor_calib, motor_rf);
+        MotorCalibration::apply(motor_calib, motor_rr);
+    }
+    if (!line_sensor.loadCalibration(eeprom)) {
+        Debug_Printf("请先用主程序校准传感器\r\n");
+    }
+
+    // 运动输出：巡线、蓝牙、脚本都经仲裁器
+    DriveTrain drive_train(motor_lf, motor_lr, motor_rf, motor_rr);
+    supply.init();
+    drive_train.setSupplyMonitor(&supply);
+    MotionArbiter arbiter(drive_train);
+
+    LineFollowerPID follower(line_sensor, motor_lf, motor_lr, motor_rf, motor_rr);
+    follower.setLineMode(LineSensor::LineMode::BLACK_ON_WHITE);
+    follower.setOutputSink(&arbiter);
+    follower.init();
+    follower.start();
+
+    E49_Wireless e49;
+    RemoteControl remote(drive_train, e49);
+    remote.init();
+    remote.attachArbiter(&arbiter);
+
+    MotionScript script(arbiter, pose);
+    SpotTurnCalibrationData spot_model;
+    if (SpotTurnCalibration::load(eeprom, spot_model)) {
+        SpotTurnCalibration::apply(spot_model, drive_train);
+        script.setSpotTurnModel(spot_model);
+    }
+    if (!script.loadFromEEPROM(eeprom)) {
+        script.load(DEMO_SCRIPT, sizeof(DEMO_SCRIPT));
+    }
+
+    BluetoothControl bluetooth(remote);
+    bluetooth.init();
+    bluetooth.setScriptEngine(&script, &eeprom);
+    bluetooth.setReplyUart(&huart2);   // PARAM_SET 的 ACK、TELEMETRY 回复
+    bluetooth.setSupplyMonitor(&supply);  // TELEMETRY 附带供电电压和补偿增益
+    // 循环DMA + 空闲线接收：一行指令只进一次中断，HAL回调见文件开头
+    if (!bluetooth.startDmaReception(&huart2)) {
+        Debug_Printf("蓝牙DMA接收启动失败\r\n");
+    }
+
+    Debug_Printf("\r\n========== 运动脚本示例 ==========\r\n");
+    Debug_Printf("脚本 %d 字节，短按按钮开始/中止\r\n", script.getLength());
+
+    const uint32_t CONTROL_INTERVAL = 10;
+    uint32_t last_control = HAL_GetTick();
+
+    while (1) {
+        uint32_t now = HAL_GetTick();
+
+        // 通信随时处理（脚本运行期间也能上传新脚本或 $SX 中止）
+        bluetooth.update();
+        remote.update();
+        supply.update();
+
+        if (button.isPressed()) {
+            if (script.isRunning()) {
+                script.abort();
+            } else {
+                pose.reset();
+                script.start();
+            }
+        }
+
+        if (now - last_control >= CONTROL_INTERVAL) {
+            uint32_t dt_ms = now - last_control;
+            last_control = now;
+
+            follower.update();                            // 读传感器，提交 LINE_FOLLOWER
+            script.update(readScriptInputs(follower));    // 推进脚本，提交 SCRIPT
+            arbiter.update();                             // 选出胜者并输出
+            pose.predict(drive_train.getLeftOutputQ8(), drive_train.getRightOutputQ8(), dt_ms);
+            if (arbiter.getActiveSource() == MotionSource::LINE_FOLLOWER) {
+                pose.observeLine(static_cast<int32_t>(follower.getPosition()));
+            }
+        }
+
+        __WFI();
+    }
+}
@@ -0,0 +1,237 @@
+/**
+ * @file    motor_curve_calibration.cpp
+ * @brief   电机速度曲线测量程序（死区 + 非线性补偿）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * 为每个电机测量 脉宽偏移 → 转速 的实测曲线，拟合成 MotorCurve 后保存到EEPROM，
+ * 主程序启动时通过 MotorCalibration::load()/apply() 加载。
+ *
+ * 准备工作：
+ * 1. 把小车架空，四个车轮都能自由转动
+ * 2. 在每个车轮侧面贴一条醒目的胶带作为转速标记
+ * 3. 打开串口监视器（USART1），按提示操作校准按钮（PD2）
+ *
+ * 每个电机、每个方向的测量步骤：
+ * 1. 死区测量：脉宽偏移从0开始缓慢增加，车轮刚开始转动时按一下按钮
+ * 2. 转速测量：依次输出若干固定脉宽，标记每经过同一位置按一下按钮，
+ *    共按 TAP_COUNT 次，程序根据按键间隔计算转速（15秒无按键记为0）
+ *
+ * 全部测完后，以所有曲线最大转速中的最小值作为“指令100”对应转速，
+ * 这样四个车轮在相同指令下转速一致，且转速与指令成正比。
+ */
+
+#include "button.hpp"
+#include "debug.hpp"
+#include "eeprom.hpp"
+#include "gpio.h"
+#include "i2c.h"
+#include "motor.hpp"
+#include "motor_calibration.hpp"
+#include "stm32f1xx_hal.h"
+#include "tim.h"
+#include "usart.h"
+
+extern "C" {
+void SystemClock_Config(void);
+}
+
+/* ========== 测量参数 ========== */
+
+constexpr uint16_t NEUTRAL_US = 1500;
+constexpr uint16_t RAMP_STEP_US = 2;          ///< 死区搜索步进
+constexpr uint32_t RAMP_STEP_MS = 300;        ///< 死区搜索每步保持时间
+constexpr uint32_t SETTLE_MS = 1500;          ///< 切换脉宽后的稳定时间
+constexpr uint32_t TAP_TIMEOUT_MS = 15000;    ///< 无按键超时（视为不转）
+constexpr uint8_t TAP_COUNT = 6;              ///< 每个测试点按键次数（5个周期）
+constexpr uint16_t TEST_OFFSETS_US[] = {40, 70, 100, 150, 200, 250};
+constexpr uint8_t MAX_SAMPLES = 1 + sizeof(TEST_OFFSETS_US) / sizeof(TEST_OFFSETS_US[0]);
+
+/* ========== 全局对象 ========== */
+
+EEPROM eeprom;
+Button tap_button(GPIOD, GPIO_PIN_2, ButtonMode::PULL_UP, 30);
+Motor motors[4];
+
+/// 每个通道、每个方向的实测样本
+struct DirectionSamples {
+    uint16_t offsets[MAX_SAMPLES];
+    float rpm[MAX_SAMPLES];
+    uint8_t count;
+};
+DirectionSamples samples[4][2];
+
+/* ========== 测量函数 ========== */
+
+/**
+ * @brief 输出相对中位的脉宽偏移
+ * @param forward true=正转方向，false=反转方向
+ */
+void outputOffset(Motor& motor, bool forward, uint16_t offset_us) {
+    motor.setPulseWidth(forward ? NEUTRAL_US + offset_us : NEUTRAL_US - offset_us);
+}
+
+/**
+ * @brief 死区搜索：缓慢增加偏移，直到用户按键
+ * @return 死区边缘偏移（us）
+ */
+uint16_t measureDeadband(Motor& motor, bool forward) {
+    Debug_Printf("  死区测量：车轮开始转动时按按钮\r\n");
+    tap_button.reset();
+
+    for (uint16_t offset = 0; offset <= MotorCalibration::MAX_OFFSET_US; offset += RAMP_STEP_US) {
+        outputOffset(motor, forward, offset);
+        uint32_t start = HAL_GetTick();
+        while (HAL_GetTick() - start < RAMP_STEP_MS) {
+            if (tap_button.isPressed()) {
+                Debug_Printf("  死区边缘: %d us\r\n", offset);
+                return offset;
+            }
+        }
+    }
+    Debug_Printf("  未检测到按键，按最大偏移处理\r\n");
+    return MotorCalibration::MAX_OFFSET_US;
+}
+
+/**
+ * @brief 按键测速：标记每经过一次按一下
+ * @return 转速（rpm），超时返回0
+ */
+float measureRpm() {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    uint8_t taps = 0;
+    uint32_t wait_start = HAL_GetTick();
+
+    tap_button.reset();
+    while (taps < TAP_COUNT) {
+        if (tap_button.isPressed()) {
+            last = HAL_GetTick();
+            if (taps == 0) {
+                first = last;
+            }
+            taps++;
+            wait_start = last;
+        }
+        if (HAL_GetTick() - wait_start > TAP_TIMEOUT_MS) {
+            return 0.0f;
+        }
+    }
+
+    if (last == first) {
+        return 0.0f;
+    }
+    return 60000.0f * (TAP_COUNT - 1) / (float)(last - first);
+}
+
+/**
+ * @brief 测量一个电机一个方向的完整曲线
+ */
+void measureDirection(Motor& motor, bool forward, DirectionSamples& out) {
+    out.count = 0;
+    uint16_t deadband = measureDeadband(motor, forward);
+    out.offsets[out.count] = deadband;
+    out.rpm[out.count] = 0.0f;
+    out.count++;
+
+    for (uint16_t offset : TEST_OFFSETS_US) {
+        if (offset <= deadband) {
+            continue;
+        }
+        outputOffset(motor, forward, offset);
+        HAL_Delay(SETTLE_MS);
+        Debug_Printf("  偏移 %3d us：标记每经过一次按一下（共%d次）\r\n", offset, TAP_COUNT);
+        float rpm = measureRpm();
+
+        // 转速应随脉宽单调增加，出现回落按测量误差处理
+        if (rpm < out.rpm[out.count - 1]) {
+            rpm = out.rpm[out.count - 1];
+        }
+        out.offsets[out.count] = offset;
+        out.rpm[out.count] = rpm;
+        out.count++;
+        Debug_Printf("  -> %d.%d rpm\r\n", (int)rpm, (int)(rpm * 10) % 10);
+    }
+    motor.stop();
+    HAL_Delay(500);
+}
+
+/* ========== 主程序 ========== */
+
+extern "C" int main(void) {
+    HAL_Init();
+    SystemClock_Config();
+
+    MX_GPIO_Init();
+    MX_TIM3_Init();
+    MX_I2C2_Init();
+    MX_USART1_UART_Init();
+
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_1);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_2);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_3);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_4);
+
+    motors[0].init(&htim3, TIM_CHANNEL_1);
+    motors[1].init(&htim3, TIM_CHANNEL_2);
+    motors[2].init(&htim3, TIM_CHANNEL_3);
+    motors[3].init(&htim3, TIM_CHANNEL_4);
+
+    tap_button.init();
+    eeprom.init();
+
+    Debug_Printf("\r\n========== 电机曲线校准 ==========\r\n");
+    Debug_Printf("小车架空、车轮贴好标记后，按按钮开始\r\n");
+    while (!tap_button.isPressed()) {
+    }
+
+    // 逐个通道、逐个方向测量
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        for (uint8_t dir = 0; dir < 2; dir++) {
+            bool forward = (dir == 0);
+            Debug_Printf("\r\n[CH%d %s]\r\n", ch + 1, forward ? "正转" : "反转");
+            measureDirection(motors[ch], forward, samples[ch][dir]);
+        }
+    }
+
+    // 以所有曲线最大转速中的最小值作为满量程
+    float full_scale = 1e9f;
+    for (uint8_t ch = 0; ch < 4; ch++) {
+        for (uint8_t dir = 0; dir < 2; dir++) {
+            const DirectionSamples& s = samples[ch][dir];
+            float max_rpm = s.rpm[s.count - 1];
+            if (max_rpm < full_scale) {
+                full_scale = max_rpm;
+            }
+        }
+    }
+    Debug_Printf("\r\n满量程转速: %d rpm\r\n", (int)full_scale);
+
+    // 拟合并保存
+    MotorCalibrationData calib;
+    calib.magic_number = MotorCalibration::MAGIC;
+    bool ok = full_scale > 0.0f;
+    for (uint8_t ch = 0; ch < 4 && ok; ch++) {
+        const DirectionSamples& f = samples[ch][0];
+        const DirectionSamples& r = samples[ch][1];
+        ok = MotorCalibration::fitDirection(f.offsets, f.rpm, f.count, full_scale,
+                                            calib.curves[ch].forward) &&
+             MotorCalibration::fitDirection(r.offsets, r.rpm, r.count, full_scale,
+                                            calib.curves[ch].reverse);
+
+        const MotorCurve& c = calib.curves[ch];
+        Debug_Printf("CH%d 正转: %3d %3d %3d %3d %3d  反转: %3d %3d %3d %3d %3d\r\n", ch + 1,
+                     c.forward[0], c.forward[1], c.forward[2], c.forward[3], c.forward[4],
+                     c.reverse[0], c.reverse[1], c.reverse[2], c.reverse[3], c.reverse[4]);
+    }
+
+    if (ok && MotorCalibration::save(eeprom, calib)) {
+        Debug_Printf("校准完成，重启主程序后生效\r\n");
+    } else {
+        Debug_Printf("校准失败：有电机未测到转速，请检查后重试\r\n");
+    }
+
+    while (1) {
+        HAL_Delay(1000);
+    }
+}
@@ -0,0 +1,183 @@
+/**
+ * @file    spot_turn_calibration.cpp
+ * @brief   原地转向牵引力校准程序（越线计时 + 最小二乘拟合）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * 测量当前地面上原地转向的“最小有效轮速”和“角速度增益”，保存到EEPROM（0xB0），
+ * 主程序启动时通过 SpotTurnCalibration::load()/apply() 加载，替代手工调
+ * spot_turn_tuning.cpp 里的降速系数和最小速度。
+ *
+ * 准备工作：
+ * 1. 先用主程序完成传感器校准（EEPROM 0x40）
+ * 2. 在要跑的地面上贴一条直线（≥40cm），把车放在线上，车身中心压线，
+ *    传感器阵列中间对准线
+ * 3. 打开串口监视器（USART1），按按钮（PD2）开始
+ *
+ * 测量过程：
+ * 对每个转向轮速（由低到高），小车原地左转，中间两路传感器每越过一次线记一次时间，
+ * 相邻两次越线转过180°。转不动（越线超时）的点记为0，不参与拟合。
+ */
+
+#include "button.hpp"
+#include "debug.hpp"
+#include "drive_train.hpp"
+#include "eeprom.hpp"
+#include "adc.h"
+#include "gpio.h"
+#include "i2c.h"
+#include "line_sensor.hpp"
+#include "motor.hpp"
+#include "motor_calibration.hpp"
+#include "spot_turn_calibration.hpp"
+#include "stm32f1xx_hal.h"
+#include "tim.h"
+#include "usart.h"
+
+extern "C" {
+void SystemClock_Config(void);
+}
+
+/* ========== 测量参数 ========== */
+
+constexpr uint8_t TEST_SPEEDS[] = {15, 20, 25, 30, 35, 40, 50, 60};
+constexpr uint8_t SPEED_COUNT = sizeof(TEST_SPEEDS) / sizeof(TEST_SPEEDS[0]);
+constexpr uint8_t CROSSINGS = 5;              ///< 每个速度记录的越线次数（4个半圈）
+constexpr uint32_t SPIN_UP_MS = 600;          ///< 起转后等待稳定的时间
+constexpr uint32_t CROSSING_TIMEOUT_MS = 4000; ///< 两次越线最长间隔（超时视为转不动）
+constexpr uint32_t MIN_OFF_LINE_MS = 40;      ///< 离线至少这么久才算下一次越线（去抖）
+constexpr LineSensor::LineMode LINE_MODE = LineSensor::LineMode::BLACK_ON_WHITE;
+
+/* ========== 全局对象 ========== */
+
+EEPROM eeprom;
+Button start_button(GPIOD, GPIO_PIN_2, ButtonMode::PULL_UP, 30);
+LineSensor line_sensor;
+Motor motor_lf, motor_lr, motor_rf, motor_rr;
+
+/* ========== 测量函数 ========== */
+
+/**
+ * @brief 中间两路传感器是否在线上
+ */
+bool centerOnLine() {
+    bool binary[8];
+    line_sensor.getBinaryData(binary, LINE_MODE);
+    return binary[3] || binary[4];
+}
+
+/**
+ * @brief 以指定轮速原地左转，测量角速度
+ * @return deg/s，转不动返回0
+ */
+uint16_t measureRate(DriveTrain& drive, uint8_t speed) {
+    const int32_t turn = speed * fixed_math::Q8_ONE;
+    drive.driveWheelsQ8(-turn, turn);
+    HAL_Delay(SPIN_UP_MS);
+
+    uint8_t crossings = 0;
+    uint32_t first = 0;
+    uint32_t last = HAL_GetTick();
+    uint32_t off_since = 0;
+    bool on_line = centerOnLine();
+
+    while (crossings < CROSSINGS) {
+        uint32_t now = HAL_GetTick();
+        bool center = centerOnLine();
+
+        if (!center) {
+            if (on_line) {
+                off_since = now;
+            }
+            on_line = false;
+        } else if (!on_line && now - off_since >= MIN_OFF_LINE_MS) {
+            // 离线足够久后重新压线：一次越线
+            on_line = true;
+            if (crossings == 0) {
+                first = now;
+            }
+            last = now;
+            crossings++;
+        }
+
+        if (now - last > CROSSING_TIMEOUT_MS) {
+            break;
+        }
+    }
+
+    drive.stop();
+    HAL_Delay(500);
+
+    if (crossings < 2) {
+        return 0;
+    }
+    return SpotTurnCalibration::crossingRate(crossings, last - first);
+}
+
+/* ========== 主程序 ========== */
+
+extern "C" int main(void) {
+    HAL_Init();
+    SystemClock_Config();
+
+    MX_GPIO_Init();
+    MX_TIM3_Init();
+    MX_I2C2_Init();
+    MX_USART1_UART_Init();
+    MX_ADC1_Init();
+
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_1);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_2);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_3);
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_4);
+
+    motor_lf.init(&htim3, TIM_CHANNEL_1);
+    motor_lr.init(&htim3, TIM_CHANNEL_3);
+    motor_rf.init(&htim3, TIM_CHANNEL_2);
+    motor_rr.init(&htim3, TIM_CHANNEL_4);
+
+    start_button.init();
+    eeprom.init();
+
+    MotorCalibrationData motor_calib;
+    if (MotorCalibration::load(eeprom, motor_calib)) {
+        MotorCalibration::apply(motor_calib, motor_lf);
+        MotorCalibration::apply(motor_calib, motor_lr);
+        MotorCalibration::apply(motor_calib, motor_rf);
+        MotorCalibration::apply(motor_calib, motor_rr);
+    }
+    DriveTrain drive(motor_lf, motor_lr, motor_rf, motor_rr);
+
+    Debug_Printf("\r\n========== 原地转向校准 ==========\r\n");
+    if (!line_sensor.loadCalibration(eeprom)) {
+        Debug_Printf("没有传感器校准数据，请先用主程序校准\r\n");
+        while (1) {
+            HAL_Delay(1000);
+        }
+    }
+    Debug_Printf("车身中心压线放好后按按钮开始\r\n");
+    while (!start_button.isPressed()) {
+    }
+
+    uint16_t rates[SPEED_COUNT];
+    for (uint8_t i = 0; i < SPEED_COUNT; i++) {
+        rates[i] = measureRate(drive, TEST_SPEEDS[i]);
+        Debug_Printf("  轮速 %2d%% -> %3d deg/s%s\r\n", TEST_SPEEDS[i], rates[i],
+                     rates[i] == 0 ? "（转不动）" : "");
+    }
+
+    SpotTurnCalibrationData calib;
+    if (SpotTurnCalibration::fit(TEST_SPEEDS, rates, SPEED_COUNT, calib) &&
+        SpotTurnCalibration::save(eeprom, calib)) {
+        Debug_Printf("最小有效轮速 %d.%02d%%，增益 %d.%02d deg/s/%%\r\n", calib.min_speed_q8 / 256,
+                     (calib.min_speed_q8 % 256) * 100 / 256, calib.gain_q8 / 256,
+                     (calib.gain_q8 % 256) * 100 / 256);
+        Debug_Printf("校准完成，重启主程序后生效\r\n");
+    } else {
+        Debug_Printf("校准失败：转动的速度点不足2个，请检查线和摆放位置后重试\r\n");
+    }
+
+    while (1) {
+        HAL_Delay(1000);
+    }
+}
@@ -46,19 +46,19 @@ extern "C" int main(void)
     while (1)
     {
         // ========== 测试1: 低速原地左旋 (30%) ==========
-        robot.drive(0, 30);  // 实际速度会被降低到 30*0.6=18%
+        robot.drive(0, 30);  // 实际速度会被降低到 30*0.8=24%，再抬到最小有效轮速
         HAL_Delay(3000);
         robot.stop();
         HAL_Delay(2000);
         
         // ========== 测试2: 中速原地左旋 (50%) ==========
-        robot.drive(0, 50);  // 实际速度会被降低到 50*0.6=30%
+        robot.drive(0, 50);  // 实际速度会被降低到 50*0.8=40%
         HAL_Delay(3000);
         robot.stop();
         HAL_Delay(2000);
         
         // ========== 测试3: 高速原地左旋 (70%) ==========
-        robot.drive(0, 70);  // 实际速度会被降低到 70*0.6=42%
+        robot.drive(0, 70);  // 实际速度会被降低到 70*0.8=56%
         HAL_Delay(3000);
         robot.stop();
         HAL_Delay(2000);
@@ -81,15 +81,19 @@ extern "C" int main(void)
  * 调试指南：
  * 
  * 1. 观察哪个测试能正常转动：
- *    - 如果测试1都转不动 → 降低 SPOT_TURN_REDUCTION 到 0.5 或 0.4
+ *    - 如果测试1都转不动 → 降低 setSpotTurnReduction() 到 0.5 或 0.4
  *    - 如果测试1能转但测试2/3堵转 → 当前设置合适
- *    - 如果所有测试都能转 → 可以提高 SPOT_TURN_REDUCTION 到 0.7-0.8
+ *    - 如果所有测试都能转 → 可以提高 setSpotTurnReduction() 到 0.7-0.8
  * 
- * 2. 修改 drive_train.cpp 中的参数：
- *    constexpr float SPOT_TURN_REDUCTION = 0.6f;
+ * 2. 调整 DriveTrain 的原地转向参数：
+ *    robot.setSpotTurnReduction(0.6f);            // 原地转向速度降低系数
+ *    robot.setMinSpotTurnSpeedQ8(25 * 256);       // 最小有效轮速
  *    
  *    粗糙地面建议：0.4 - 0.5
  *    光滑地面建议：0.6 - 0.7
+ *
+ *    更推荐用 examples/spot_turn_calibration.cpp 在实际地面上自动测量
+ *    最小有效轮速和角速度增益，结果保存到EEPROM，主程序启动时自动加载
  * 
  * 3. 如果降低速度后还是不行，考虑：
  *    - 检查电池电压是否充足
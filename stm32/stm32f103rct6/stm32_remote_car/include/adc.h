@@ -1,6 +1,6 @@
 /**
  * @file    adc.h
- * @brief   ADC 配置 - 8路灰度传感器采样
+ * @brief   ADC 配置 - 8路灰度传感器采样 + 电源电压监测
  * @author  AI Assistant
  * @date    2024
  * 
@@ -14,6 +14,10 @@
  *   [5]    PC3   - ADC_CH13 - SIG6 (右3)
  *   [6]    PC4   - ADC_CH14 - SIG7 (右2)
  *   [7]    PC5   - ADC_CH15 - SIG8 (最右侧)
+ *
+ * @hardware 注入组（电源监测，软件触发，与规则组扫描互不干扰）:
+ *   [J1]   内部  - ADC_CH17 - Vrefint（1.20V 内部基准，用于反推 VDDA）
+ *   [J2]   PA1   - ADC_CH1  - 电池分压（可选，ADC_BATTERY_ENABLE=1 时启用）
  */
 
 #ifndef __ADC_H
@@ -25,6 +29,14 @@ extern "C" {
 
 #include "stm32f1xx_hal.h"
 
+/* ========== 电池分压通道（可选） ========== */
+#ifndef ADC_BATTERY_ENABLE
+#define ADC_BATTERY_ENABLE      0                 // 1 = PA1 接了电池分压电阻
+#endif
+#define ADC_BATTERY_CHANNEL     ADC_CHANNEL_1
+#define ADC_BATTERY_PORT        GPIOA
+#define ADC_BATTERY_PIN         GPIO_PIN_1
+
 /* ADC 句柄 */
 extern ADC_HandleTypeDef hadc1;
 
@@ -45,6 +57,9 @@ void ADC_ReadAll(uint16_t *buffer);
 /* 开始 DMA 连续转换 */
 void ADC_StartDMA(uint16_t *buffer, uint32_t length);
 
+/* 读取注入组：Vrefint 和电池分压原始值（未启用分压时 battery 为0），成功返回1 */
+uint8_t ADC_ReadSupply(uint16_t *vrefint, uint16_t *battery);
+
 #ifdef __cplusplus
 }
 #endif
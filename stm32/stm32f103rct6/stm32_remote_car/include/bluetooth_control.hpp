@@ -8,8 +8,30 @@
 #ifndef BLUETOOTH_CONTROL_HPP
 #define BLUETOOTH_CONTROL_HPP
 
+#include <functional>
+
 #include "stm32f1xx_hal.h"
+#include "bt_protocol.hpp"
+#include "latency_probe.hpp"
+#include "spsc_ring.hpp"
 #include "remote_control.hpp"
+#include "motion_script.hpp"
+#include "supply_monitor.hpp"
+
+/**
+ * @brief 角度摇杆（A[角度]P[力度]）响应曲线，setJoystickCurve() 时烘焙成查找表
+ *
+ * - 力度先扣除死区再重新拉满，然后按 expo 混合线性与三次曲线：
+ *   y = (1-e)·x + e·x³，小力度更细腻，满力度仍是100%
+ * - 转向上限随直行速度线性变化：原地 turnAtStop%，全速 turnAtFull%，
+ *   高速时同样的摇杆偏角转得更缓
+ */
+struct JoystickCurve {
+    uint8_t deadzone = 5;       ///< 死区（力度的%，0-50）
+    uint8_t expo = 30;          ///< 指数曲线强度（0=线性，100=纯三次）
+    uint8_t turnAtStop = 100;   ///< 直行速度为0时的最大转向（%）
+    uint8_t turnAtFull = 60;    ///< 直行速度100%时的最大转向（%）
+};
 
 /**
  * @class BluetoothControl
@@ -19,7 +41,19 @@
  * - 接收并解析ESP32-S3蓝牙模块数据
  * - 支持按键模式（单字符命令）
  * - 支持摇杆模式（A[角度]P[力度]格式）
+ * - 支持运动脚本上传（$S 开头的文本行，见 setScriptEngine()）
+ * - 支持二进制帧（0xAA开头，带序号和CRC8，见 bt_protocol.hpp），与文本协议自动区分
  * - 将解析后的数据传递给RemoteControl处理
+ *
+ * 接收方式（二选一）：
+ * - startDmaReception()：循环DMA + 空闲线中断，每段数据（一行摇杆指令）只进一次中断，
+ *   中断里把整段拷进接收队列。HAL 回调由应用程序定义（其他串口也要用），在
+ *   HAL_UARTEx_RxEventCallback / HAL_UART_ErrorCallback 中转发给 onRxEventFromISR() /
+ *   onRxErrorFromISR()，这两个函数遇到其他串口直接返回
+ * - 逐字节中断：在 HAL_UART_RxCpltCallback 中调用 enqueueFromISR()
+ *
+ * 接收队列为 SpscRing（spsc_ring.hpp，中断生产、update() 消费），队列满时丢弃新数据，
+ * 消费时不需要关中断，update() 把队列中连续的一段交给 handleBurst() 一次解析。
  */
 class BluetoothControl {
 public:
@@ -44,12 +78,54 @@ public:
      * @param data 接收到的字节
      */
     void handleData(uint8_t data);
+
+    /**
+     * @brief 解析一段接收数据（逐字节调用 handleData）
+     */
+    void handleBurst(const uint8_t* data, uint16_t len);
     
     // 从USART中断上下文入队一个字节（非阻塞、ISR安全）
     void enqueueFromISR(uint8_t data);
+
+    /**
+     * @brief 设置回复帧（ACK / TELEMETRY / LATENCY）的发送串口
+     * @param huart 蓝牙模块所在串口，nullptr 关闭回复
+     * @note 与接收方式无关，逐字节中断接收时也需要调用；
+     *       未设置时 startDmaReception() 会把接收串口同时用作回复串口
+     */
+    void setReplyUart(UART_HandleTypeDef* huart) { txUart_ = huart; }
+
+    /**
+     * @brief 启动循环DMA + 空闲线接收（串口需已配置RX DMA，见 usart.c）
+     * @param huart 蓝牙模块所在串口
+     * @return true=启动成功
+     */
+    bool startDmaReception(UART_HandleTypeDef* huart);
+
+    /**
+     * @brief DMA接收事件（半满/满/空闲线，由应用的 HAL_UARTEx_RxEventCallback 转发）
+     * @param huart 产生事件的串口
+     * @param pos DMA缓冲中的写入位置
+     */
+    void onRxEventFromISR(UART_HandleTypeDef* huart, uint16_t pos);
+
+    /**
+     * @brief 串口错误（溢出/噪声/帧错误）后重新启动DMA接收（由应用的 HAL_UART_ErrorCallback 转发）
+     */
+    void onRxErrorFromISR(UART_HandleTypeDef* huart);
     
     // 在主循环中调用，消费队列并解析
     void update();
+
+    /**
+     * @brief 队列满丢弃的字节数
+     */
+    uint32_t getDroppedBytes() const { return rxRing_.overflowCount(); }
+
+    /**
+     * @brief 静态实例（供HAL回调转发）
+     */
+    static BluetoothControl* instance() { return instance_; }
     
     /**
      * @brief 设置摇杆模式使能
@@ -63,6 +139,48 @@ public:
      */
     bool isJoystickMode() const;
 
+    /**
+     * @brief 设置角度摇杆响应曲线（重建查找表，约几百个周期）
+     * @return false=参数超出范围，保持原曲线
+     * @note 只影响文本协议 A[角度]P[力度]；二进制摇杆帧直接给出直行/转向，不经过曲线
+     */
+    bool setJoystickCurve(const JoystickCurve& curve);
+
+    const JoystickCurve& getJoystickCurve() const { return joystickCurve_; }
+
+    /**
+     * @brief 接入运动脚本解释器，启用脚本上传命令
+     * @param script 脚本解释器（nullptr 关闭）
+     * @param eeprom 用于 $SW/$SL 保存和读取，可为 nullptr
+     *
+     * 命令（每行一条，十六进制不区分大小写）：
+     * - $SC        清空脚本
+     * - $S+<hex>   追加字节码（每行最多 MAX_SCRIPT_CHUNK 字节）
+     * - $SR        校验并运行
+     * - $SX        中止
+     * - $SW / $SL  保存到 / 读取自 EEPROM
+     */
+    void setScriptEngine(MotionScript* script, EEPROM* eeprom = nullptr);
+
+    /**
+     * @brief 自定义参数处理（二进制 PARAM_SET 中参数号 ≥ BtParam::USER 的部分）
+     * @param handler 返回 AckStatus，作为 ACK 回复给手机
+     */
+    void setParamHandler(std::function<bt_protocol::AckStatus(uint8_t id, int16_t value)> handler);
+
+    /**
+     * @brief 接入电源监测，TELEMETRY 回复附带供电电压和补偿增益
+     * @param supply 电源监测（nullptr 时这两项回复0）
+     */
+    void setSupplyMonitor(const SupplyMonitor* supply) { supply_ = supply; }
+
+    /**
+     * @brief 二进制帧解析器（统计有效帧、CRC错误、丢失和重复帧）
+     */
+    const bt_protocol::FrameParser& getFrameParser() const { return frameParser_; }
+
+    static constexpr uint8_t MAX_SCRIPT_CHUNK = 28;  ///< 单行最多字节码（56个十六进制字符）
+
 private:
     RemoteControl& remoteControl_;  // 遥控器控制引用
     
@@ -73,12 +191,36 @@ private:
     bool textMode_;                 // 文本模式（忽略非协议行，直到换行）
     uint8_t lineBuffer_[64];        // 行缓冲（非摇杆）
     uint8_t lineIndex_;             // 当前行长度
+
+    // 角度摇杆响应曲线（查找表在 setJoystickCurve() 中生成）
+    JoystickCurve joystickCurve_;
+    uint8_t powerLut_[100];         // 力度0-99 → 幅值0-100（死区 + expo）
+    uint8_t turnLimitLut_[101];     // |直行速度|0-100 → 最大转向（%）
+
+    MotionScript* script_ = nullptr;  // 运动脚本（可选）
+    EEPROM* scriptEeprom_ = nullptr;  // 脚本存储（可选）
+    const SupplyMonitor* supply_ = nullptr;  // 电源监测（可选，TELEMETRY 用）
+
+    // 二进制帧
+    bt_protocol::FrameParser frameParser_;
+    std::function<bt_protocol::AckStatus(uint8_t, int16_t)> paramHandler_;
+    uint8_t txSeq_ = 0;               // 回复帧序号
+    uint32_t lastRxTick_ = 0;         // 最近一次从队列取到数据的时刻（帧内间隔超时）
     
-    // --- UART2 字节级队列（ISR 生产，主循环消费） ---
-    static const uint16_t kRxQueueSize = 256;
-    volatile uint16_t rxqHead_ = 0; // 写入（ISR）
-    volatile uint16_t rxqTail_ = 0; // 读取（主循环）
-    uint8_t rxQueue_[kRxQueueSize];
+    // --- UART2 接收队列（ISR 生产，主循环消费） ---
+    SpscRing<uint8_t, 256> rxRing_;
+
+    // --- 循环DMA缓冲（半满/满/空闲线时拷入队列） ---
+    static const uint16_t kRxDmaSize = 64;
+    uint8_t rxDma_[kRxDmaSize];
+    uint16_t rxDmaPos_ = 0;                 // 上次拷贝到的位置
+    UART_HandleTypeDef* rxUart_ = nullptr;  // 未启动DMA接收时为空
+    UART_HandleTypeDef* txUart_ = nullptr;  // 回复帧串口（setReplyUart()）
+
+    /**
+     * @brief 把一段数据写入接收队列（ISR上下文）
+     */
+    void pushFromISR(const uint8_t* data, uint16_t len);
     
     /**
      * @brief 处理按键模式数据（单字符）
@@ -90,6 +232,53 @@ private:
      * @brief 处理摇杆模式数据（A[角度]P[力度]\n）
      */
     void handleJoystickCommand();
+
+    /**
+     * @brief 处理脚本命令行（$S...）
+     */
+    void handleScriptLine();
+
+    /**
+     * @brief 处理一个二进制帧
+     */
+    void handleFrame(const bt_protocol::Frame& frame);
+
+    /**
+     * @brief 设置内置参数（BtParam）
+     */
+    bt_protocol::AckStatus applyParam(uint8_t id, int16_t value);
+
+    /**
+     * @brief 发送回复帧（未设置回复串口时不发送）
+     */
+    void sendFrame(bt_protocol::MsgType type, const uint8_t* payload, uint8_t length);
+
+#if LATENCY_PROBE_ENABLE
+    // --- 延迟探针：每段数据入队时的DWT计数，解析时据此找出帧的到达时刻 ---
+    struct RxStamp {
+        uint32_t end;       // 该段最后一个字节的累计序号
+        uint32_t cycles;    // 入队时的DWT计数
+    };
+    SpscRing<RxStamp, 16> rxStamps_;
+    uint32_t rxBytesIn_ = 0;    // 已入队字节数（只由ISR修改）
+    uint32_t rxBytesOut_ = 0;   // 已取出字节数（只由主循环修改）
+    uint32_t rxArrival_ = 0;    // 当前字节的到达时刻（DWT计数）
+
+    /**
+     * @brief 取出一个字节前调用，更新 rxArrival_
+     */
+    void trackArrival();
+
+    /**
+     * @brief 帧载荷 offset 处带发送方时间戳时开始打点
+     */
+    void beginProbe(const bt_protocol::Frame& frame, uint8_t offset);
+
+    /**
+     * @brief 回传 LATENCY 帧
+     */
+    void sendLatency(const LatencyResult& result);
+#endif
     
     /**
      * @brief 将角度和力度转换为小车控制指令
@@ -97,6 +286,11 @@ private:
      * @param power 力度 (0-99)
      */
     void convertJoystickToMotion(int angle, int power);
+
+    /**
+     * @brief 按 joystickCurve_ 生成 powerLut_ 和 turnLimitLut_
+     */
+    void buildJoystickLuts();
     
     /**
      * @brief 静态实例指针（用于UART回调）
@@ -0,0 +1,176 @@
+/**
+ * @file    bt_protocol.hpp
+ * @brief   蓝牙二进制控制帧（帧头 + 长度 + 类型/序号 + CRC8）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 文本协议 A090P50\n 一条摇杆指令8字节，丢字节时只能靠格式检查碰运气，
+ * 重复或丢失的指令也看不出来。二进制帧：
+ *
+ *     0xAA | LEN | TYPE<<4 | SEQ | 载荷... | CRC8
+ *
+ * - LEN：类型/序号字节 + 载荷的字节数（1 ~ MAX_PAYLOAD+1）
+ * - SEQ：4位序号，发送方每帧加1（重发同一帧时不变）
+ * - CRC8：crc::crc8(LEN .. 最后一个载荷字节)
+ *
+ * 摇杆帧6字节、按键帧5字节。0xAA 不会出现在文本协议中，
+ * BluetoothControl 收到 0xAA 时切换到二进制解析，两种格式可以混用。
+ *
+ * | 类型 | 方向 | 载荷 |
+ * |------|------|------|
+ * | JOYSTICK      | 手机→小车 | int8 直行, int8 转向（-100 ~ 100）[, uint32 发送方时间戳] |
+ * | KEY           | 手机→小车 | 按键字符（F/B/L/R/W/X/Y/Z/U/S/D）[, uint32 发送方时间戳] |
+ * | PARAM_SET     | 手机→小车 | uint8 参数号（BtParam）, int16 值（小端），回复 ACK |
+ * | TELEMETRY_REQ | 手机→小车 | 无，回复 TELEMETRY |
+ * | TELEMETRY     | 小车→手机 | uint16×7（小端）：有效帧, CRC错误, 丢失, 重复, 队列丢弃字节,
+ *                               供电 mV, 补偿增益 Q8（256=1.0；未接电源监测时均为0） |
+ * | ACK           | 小车→手机 | 被确认帧的序号, 状态（0成功/1参数号未知/2值无效） |
+ * | LATENCY       | 小车→手机 | 延迟打点（小端）：uint32 发送方时间戳, uint32 到达us, uint32 回传us,
+ *                               uint16 解析/仲裁/CCR/PWM沿 us, uint16 速度到位 ms（相对到达，0xFFFF=未到达） |
+ *
+ * 摇杆/按键帧附带发送方时间戳（任意时钟，常用上位机微秒计数）时，LATENCY_PROBE_ENABLE=1
+ * 的固件逐级打点并回传 LATENCY 帧，见 latency_probe.hpp 和 tools/latency_report.py。
+ */
+
+#ifndef BT_PROTOCOL_HPP
+#define BT_PROTOCOL_HPP
+
+#include <stdint.h>
+
+namespace bt_protocol {
+
+constexpr uint8_t FRAME_SYNC = 0xAA;      ///< 帧头（文本协议中不会出现）
+constexpr uint8_t MAX_PAYLOAD = 22;       ///< 最大载荷字节数（LATENCY 帧）
+constexpr uint8_t FRAME_OVERHEAD = 4;     ///< 帧头 + LEN + 类型/序号 + CRC8
+constexpr uint8_t MAX_FRAME = MAX_PAYLOAD + FRAME_OVERHEAD;
+constexpr uint32_t FRAME_GAP_MS = 50;     ///< 帧内字节间隔超过该值视为帧被截断（大于BLE连接间隔）
+
+/**
+ * @brief 消息类型（类型/序号字节的高4位）
+ */
+enum class MsgType : uint8_t {
+    JOYSTICK = 1,
+    KEY = 2,
+    PARAM_SET = 3,
+    TELEMETRY_REQ = 4,
+    TELEMETRY = 8,
+    ACK = 9,
+    LATENCY = 10,
+};
+
+/**
+ * @brief PARAM_SET 参数号（0x80 以上交给 BluetoothControl::setParamHandler() 的处理函数）
+ */
+enum class BtParam : uint8_t {
+    TIMEOUT_MS = 0,        ///< 遥控超时（ms）
+    BASE_SPEED,            ///< 按键模式基础速度（%）
+    MAX_SPEED,             ///< 最大速度（%）
+    SPEED_INCREMENT,       ///< U/D 调速步进（%）
+    TURN_SENSITIVITY,      ///< 转向灵敏度（%）
+    JOY_DEADZONE,          ///< 角度摇杆死区（%，0-50）
+    JOY_EXPO,              ///< 角度摇杆指数曲线（0线性 ~ 100三次）
+    JOY_TURN_AT_STOP,      ///< 原地时最大转向（%）
+    JOY_TURN_AT_FULL,      ///< 全速时最大转向（%）
+    USER = 0x80,           ///< 自定义参数起始编号
+};
+
+/**
+ * @brief ACK 状态
+ */
+enum class AckStatus : uint8_t {
+    OK = 0,
+    UNKNOWN_PARAM,
+    BAD_VALUE,
+};
+
+/**
+ * @brief 解出的一帧
+ */
+struct Frame {
+    MsgType type;
+    uint8_t seq;
+    uint8_t length;                 ///< 载荷字节数
+    uint8_t payload[MAX_PAYLOAD];
+};
+
+/**
+ * @brief 逐字节帧解析（带序号检查）
+ *
+ * CRC错误或长度非法时只丢弃这个帧头，从已收字节中的下一个 0xAA 重新同步，
+ * 坏帧里夹着的完整帧照常解出。帧头之后的字节可能被当作帧内容吞掉（例如丢了 LEN 字节，
+ * 类型/序号字节被当成长度），所以线路空闲超过 FRAME_GAP_MS 时要调用 flushIdle()
+ * 丢弃未完成的帧，否则一个杂散 0xAA 会吃掉之后的第一帧。
+ * 与上一帧序号相同的帧视为重发，计数后丢弃；序号跳变时按差值累计丢失帧数。
+ */
+class FrameParser {
+public:
+    enum class Result : uint8_t {
+        PENDING,    ///< 字节已接收，帧未完成（或已丢弃）
+        FRAME,      ///< 得到一帧新数据，见 frame()
+        REJECTED,   ///< 不是帧的一部分（帧头后长度非法），交给文本协议处理
+    };
+
+    FrameParser();
+
+    /**
+     * @brief 输入一个字节
+     * @note 空闲时只接受 FRAME_SYNC，其它字节返回 REJECTED
+     */
+    Result feed(uint8_t byte);
+
+    /**
+     * @brief 线路空闲（帧内字节间隔超过 FRAME_GAP_MS）
+     * @return FRAME=缓冲中还有一个完整帧（重新同步后留下的），取出后再调用一次；
+     *         PENDING=未完成的帧已丢弃（计入 getTruncated()）
+     */
+    Result flushIdle();
+
+    /**
+     * @brief 是否正在接收一帧（帧头之后）
+     */
+    bool busy() const { return index_ > 0; }
+
+    /**
+     * @brief 最近一次 feed() 返回 FRAME 时的帧
+     */
+    const Frame& frame() const { return frame_; }
+
+    /**
+     * @brief 清空接收状态和统计，下一帧不做序号检查
+     */
+    void reset();
+
+    uint32_t getFrameCount() const { return frames_; }
+    uint32_t getCrcErrors() const { return crc_errors_; }
+    uint32_t getLostFrames() const { return lost_; }
+    uint32_t getDuplicates() const { return duplicates_; }
+    uint32_t getTruncated() const { return truncated_; }
+
+private:
+    Result process();
+    void resync(uint8_t from);
+    bool accept();
+
+    uint8_t buf_[MAX_FRAME];
+    uint8_t index_;
+    Frame frame_;
+    bool has_seq_;
+    uint8_t last_seq_;
+    uint32_t frames_;
+    uint32_t crc_errors_;
+    uint32_t lost_;
+    uint32_t duplicates_;
+    uint32_t truncated_;
+};
+
+/**
+ * @brief 编码一帧
+ * @param out 输出缓冲（至少 length + FRAME_OVERHEAD 字节）
+ * @return 帧长度，载荷超长时返回0
+ */
+uint8_t encode(MsgType type, uint8_t seq, const uint8_t* payload, uint8_t length, uint8_t* out);
+
+}  // namespace bt_protocol
+
+#endif  // BT_PROTOCOL_HPP
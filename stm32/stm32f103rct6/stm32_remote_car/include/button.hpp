@@ -99,6 +99,16 @@ public:
      */
     bool isLongPressed(uint32_t long_press_ms = 2000);
     
+    /**
+     * @brief 检测短按事件（在长按阈值之前释放）
+     * @param long_press_ms 长按时间阈值（毫秒），与 isLongPressed() 使用同一值
+     * @return true 检测到短按（释放时触发一次）
+     * @return false 未检测到
+     * 
+     * @note 按住超过阈值后释放不触发，长按操作不会同时触发短按操作
+     */
+    bool isShortPressed(uint32_t long_press_ms = 2000);
+    
     /**
      * @brief 获取按钮按下持续时间
      * @return uint32_t 按下持续时间（毫秒），未按下返回0
@@ -136,6 +146,9 @@ private:
     /* ========== 边沿检测状态 ========== */
     bool prev_state_for_release_;  ///< 用于isReleased边沿检测
     bool prev_state_for_longpress_; ///< 用于isLongPressed边沿检测
+    bool prev_state_for_short_;     ///< 用于isShortPressed边沿检测
+    bool short_press_armed_;        ///< 本次按下可触发短按（reset()时按住则不触发）
+    uint32_t short_press_start_;    ///< isShortPressed记录的按下时刻
     
     /**
      * @brief 使能GPIO端口时钟
@@ -0,0 +1,101 @@
+/**
+ * @file    crash_dump.hpp
+ * @brief   故障现场保存（.noinit RAM，复位后通过串口报告）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * HardFault/MemManage/BusFault/UsageFault 和 Error_Handler 以前都是原地死循环，
+ * 小车停在场上，什么证据也没有。现在它们会：
+ *
+ * 1. 把异常栈帧（r0-r3, r12, lr, pc, xpsr）、EXC_RETURN、
+ *    CFSR/HFSR/MMFAR/BFAR、当前主循环阶段、时间戳和崩溃前最后
+ *    CRASH_LOG_BYTES 字节的调试输出写入 .noinit 段（启动代码不清零）
+ * 2. 立即 NVIC_SystemReset()，几毫秒后重新运行
+ * 3. 下次启动时 CrashDump::reportIfAny() 通过调试串口输出报告并清除记录
+ *
+ * 故障处理入口先把 MSP 复位到栈顶再调用C代码，栈溢出导致的故障同样能保存；
+ * 栈帧地址不在RAM范围内时寄存器记为0，避免在故障处理中再次出错。
+ *
+ * .noinit 段由 ld/noinit.ld 放到 .bss 之后（NOLOAD），上电时内容随机，
+ * 靠魔术数字 + CRC8 判断记录是否有效。
+ *
+ * 报告示例：
+ * @code
+ * [CRASH] BusFault 第2次 运行 12345ms 阶段=TICK 中断=0
+ * [CRASH] PC=0x08003A1C LR=0x08003A05 xPSR=0x21000000 SP=0x2000BF60 EXC_RETURN=0xFFFFFFF9
+ * [CRASH] R0=0x00000000 R1=0x40000000 R2=0x00000001 R3=0x00000000 R12=0x00000000
+ * [CRASH] CFSR=0x00008200 HFSR=0x00000000 MMFAR=0xE000ED34 BFAR=0x40000000 PRECISERR BFARVALID
+ * [CRASH] ---- 崩溃前日志 256 字节 ----
+ * ...
+ * [CRASH] ---- END ----
+ * @endcode
+ *
+ * PC/LR 对应的源码行：arm-none-eabi-addr2line -e .pio/build/dev/firmware.elf -f -C 0x08003A1C
+ */
+
+#ifndef CRASH_DUMP_HPP
+#define CRASH_DUMP_HPP
+
+#include <stdint.h>
+
+#include "cycle_budget.hpp"
+
+/**
+ * @brief 故障类型
+ */
+enum class CrashCause : uint8_t {
+    NONE = 0,
+    HARD_FAULT,
+    MEM_MANAGE,
+    BUS_FAULT,
+    USAGE_FAULT,
+    ERROR_HANDLER,  // HAL初始化失败等软件错误，PC为调用 Error_Handler 的位置
+    COUNT
+};
+
+namespace CrashDump {
+
+constexpr uint32_t CRASH_LOG_BYTES = 256;   ///< 保存的崩溃前调试输出字节数
+
+/**
+ * @brief 打开 MemManage/BusFault/UsageFault 独立异常（否则都升级为 HardFault）
+ * @note 在 main() 最开始调用，早于其它初始化
+ */
+void init();
+
+/**
+ * @brief 有崩溃记录时通过调试串口输出报告并清除
+ * @return true 上次复位由崩溃引起
+ */
+bool reportIfAny();
+
+/**
+ * @brief 上电以来（不含上电复位）因崩溃复位的次数
+ */
+uint32_t getCrashCount();
+
+/**
+ * @brief 记录主循环当前阶段（只写一个字节，可在控制周期中调用）
+ */
+void setStage(BudgetStage stage);
+
+}  // namespace CrashDump
+
+extern "C" {
+/**
+ * @brief 故障入口（由故障处理函数的汇编前导调用，不返回）
+ * @param frame 异常栈帧（r0,r1,r2,r3,r12,lr,pc,xpsr），可能无效
+ * @param exc_return 进入异常时的 LR
+ * @param cause 故障类型（CrashCause）
+ */
+void CrashDump_OnFault(const uint32_t* frame, uint32_t exc_return, uint32_t cause) __attribute__((noreturn));
+
+/**
+ * @brief 软件错误入口（由 Error_Handler 调用，不返回）
+ * @param caller 调用 Error_Handler 的返回地址
+ */
+void CrashDump_OnError(uint32_t caller) __attribute__((noreturn));
+}
+
+#endif  // CRASH_DUMP_HPP
@@ -0,0 +1,31 @@
+/**
+ * @file    crc.hpp
+ * @brief   CRC-8 校验（多项式 0x07，初值 0，EEPROM结构体与串口帧共用）
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#ifndef CRC_HPP
+#define CRC_HPP
+
+#include <stdint.h>
+
+namespace crc {
+
+/**
+ * @brief CRC-8（查表，每字节约4个周期）
+ * @param data 数据
+ * @param length 长度
+ * @param crc 初值（分段计算时传入上一段的结果）
+ * @return CRC-8
+ */
+uint8_t crc8(const uint8_t* data, uint32_t length, uint8_t crc = 0x00);
+
+/**
+ * @brief 追加一个字节
+ */
+uint8_t crc8Update(uint8_t crc, uint8_t byte);
+
+}  // namespace crc
+
+#endif  // CRC_HPP
@@ -0,0 +1,126 @@
+/**
+ * @file    cycle_budget.hpp
+ * @brief   控制周期分段计时（基于DWT周期计数器）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 在控制周期的各阶段（ADC采集、滤波、位置计算、PID、OLED、调试输出等）插入作用域计时器，
+ * 用DWT->CYCCNT测量耗时，在RAM中统计 min/avg/max 和对数直方图（用于估算p99），
+ * 并记录超出预算的次数。按需调用 CYCLE_BUDGET_REPORT() 输出报告。
+ *
+ * 在 debug_config.h 中设置 CYCLE_BUDGET_ENABLE 为 0 时，所有宏编译为空。
+ *
+ * 使用示例：
+ * @code
+ * CYCLE_BUDGET_INIT();
+ *
+ * void LineFollowerPID::update() {
+ *     CYCLE_BUDGET_SCOPE(BudgetStage::TICK);
+ *     ...
+ * }
+ *
+ * if (button.isShortPressed(3000)) {   // 短按；长按留给校准
+ *     CYCLE_BUDGET_REPORT();
+ * }
+ * @endcode
+ */
+
+#ifndef CYCLE_BUDGET_HPP
+#define CYCLE_BUDGET_HPP
+
+#include <stdint.h>
+#include "debug_config.h"
+
+/**
+ * @brief 计时阶段
+ */
+enum class BudgetStage : uint8_t {
+    TICK = 0,     // 整个巡线控制周期（LineFollowerPID::update）
+    ADC,          // ADC采集（中值滤波多次采样）
+    FILTER,       // 低通滤波与偏移补偿
+    SENSOR_CFG,   // 运行中调整传感器滤波参数
+    POSITION,     // 二值化与线位置计算
+    PID,          // 状态估计与PID计算
+    POST,         // PID后处理链
+    OUTPUT,       // 电机输出
+    DEBUG,        // 调试输出
+    OLED,         // OLED刷新
+    LOOP,         // 一轮主循环（不含WFI）
+    COUNT
+};
+
+#if CYCLE_BUDGET_ENABLE
+
+#include "stm32f1xx_hal.h"
+
+namespace CycleBudget {
+
+/**
+ * @brief 使能DWT周期计数器并清空统计
+ */
+void init();
+
+/**
+ * @brief 清空统计数据（含 PWM 命令->脉冲延迟统计）
+ */
+void reset();
+
+/**
+ * @brief 记录一次阶段耗时
+ * @param stage 阶段
+ * @param cycles 耗时（CPU周期）
+ */
+void record(BudgetStage stage, uint32_t cycles);
+
+/**
+ * @brief 设置阶段预算（超过计为一次超时）
+ * @param stage 阶段
+ * @param budget_us 预算（微秒），0表示不检查
+ */
+void setBudget(BudgetStage stage, uint32_t budget_us);
+
+/**
+ * @brief 获取阶段超时次数
+ */
+uint32_t getOverruns(BudgetStage stage);
+
+/**
+ * @brief 通过调试串口输出统计报告
+ */
+void report();
+
+}  // namespace CycleBudget
+
+/**
+ * @brief 作用域计时器：构造时读CYCCNT，析构时记录差值
+ */
+class ScopedCycleTimer {
+public:
+    explicit ScopedCycleTimer(BudgetStage stage) : stage_(stage), start_(DWT->CYCCNT) {}
+    ~ScopedCycleTimer() { CycleBudget::record(stage_, DWT->CYCCNT - start_); }
+
+    ScopedCycleTimer(const ScopedCycleTimer&) = delete;
+    ScopedCycleTimer& operator=(const ScopedCycleTimer&) = delete;
+
+private:
+    BudgetStage stage_;
+    uint32_t start_;
+};
+
+#define CYCLE_BUDGET_CONCAT_(a, b)  a##b
+#define CYCLE_BUDGET_CONCAT(a, b)   CYCLE_BUDGET_CONCAT_(a, b)
+
+#define CYCLE_BUDGET_INIT()         CycleBudget::init()
+#define CYCLE_BUDGET_SCOPE(stage)   ScopedCycleTimer CYCLE_BUDGET_CONCAT(cycle_scope_, __LINE__)(stage)
+#define CYCLE_BUDGET_REPORT()       CycleBudget::report()
+
+#else
+
+#define CYCLE_BUDGET_INIT()         ((void)0)
+#define CYCLE_BUDGET_SCOPE(stage)   ((void)0)
+#define CYCLE_BUDGET_REPORT()       ((void)0)
+
+#endif  // CYCLE_BUDGET_ENABLE
+
+#endif  // CYCLE_BUDGET_HPP
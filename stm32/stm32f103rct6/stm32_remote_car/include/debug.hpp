@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 #include "usart.h"
+#include "debug_config.h"   // LOG_E/LOG_W/LOG_I/LOG_D 分级日志宏
 #include <stdio.h>
 #include <stdarg.h>
 
@@ -88,6 +89,50 @@ void Debug_Printf(const char* format, ...);
  */
 void Debug_Print_Always(const char* format, ...);
 
+/**
+ * @brief 写入原始字节（不格式化）
+ * @param data 数据
+ * @param len 长度
+ * @return 实际接受的字节数（非阻塞模式缓冲满时为0，整条丢弃）
+ */
+uint32_t Debug_Write(const uint8_t* data, uint32_t len);
+
+/**
+ * @brief 等待发送缓冲清空（非阻塞模式）
+ * @param timeout_ms 最长等待时间
+ * @return true=已发送完，false=超时
+ *
+ * 用于大量连续输出（报告、直方图）前后，或复位前确保输出完整。
+ * 不要在控制周期内调用。
+ */
+bool Debug_Flush(uint32_t timeout_ms);
+
+/**
+ * @brief 发送缓冲剩余空间（字节，阻塞模式恒为 UINT32_MAX）
+ *
+ * 分批输出大量内容时，每次只在空间足够时写一行，避免阻塞或丢弃。
+ */
+uint32_t Debug_GetTxSpace(void);
+
+/**
+ * @brief 发送缓冲满被丢弃的字节数（累计，阻塞模式恒为0）
+ */
+uint32_t Debug_GetDroppedBytes(void);
+
+/**
+ * @brief 复制最近写入调试输出的字节（不论是否已发送）
+ * @param dst 目标缓冲
+ * @param max 最多复制的字节数
+ * @return 实际复制的字节数（阻塞模式恒为0）
+ */
+uint32_t Debug_CopyRecent(uint8_t* dst, uint32_t max);
+
+/**
+ * @brief 非阻塞发送服务，由 USART1/USART2 中断处理函数调用
+ * @param huart 产生中断的串口（不是调试串口时立即返回）
+ */
+void Debug_TxService(UART_HandleTypeDef* huart);
+
 /**
  * @brief printf重定向函数
  * 重定向标准printf到设置的调试串口
@@ -99,6 +144,9 @@ int _write(int file, char *ptr, int len);
 
 #ifdef __cplusplus
 }
+
+// 延迟格式化日志宏 DLOG()（后端由 debug_config.h 选择）
+#include "deferred_log.hpp"
 #endif
 
 
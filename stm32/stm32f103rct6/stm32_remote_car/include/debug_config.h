@@ -40,6 +40,9 @@
 #define DEBUG_WIRELESS_ENABLE       0       // 无线模块调试
 #define DEBUG_LINE_FOLLOW_ENABLE    1       // 巡线模块调试
 #define DEBUG_SYSTEM_ENABLE         1       // 系统信息调试
+#define DEBUG_DRIVE_ENABLE          1       // 运动仲裁/原地转向调试
+#define DEBUG_SCRIPT_ENABLE         1       // 运动脚本调试
+#define DEBUG_POWER_ENABLE          1       // 电源监测调试
 
 
 /* ========== 调试输出选项 ========== */
@@ -84,10 +87,24 @@
 
 /**
  * @brief UART发送超时时间（毫秒）
- * 发送调试数据的最大等待时间
+ * 仅 DEBUG_TX_DMA_ENABLE=0 时的阻塞发送使用
  */
 #define DEBUG_UART_TIMEOUT          1000
 
+/**
+ * @brief 非阻塞发送（环形缓冲 + UART TX DMA）
+ * 1 = Debug_Printf 只把数据放入环形缓冲立即返回，由DMA在后台发送，
+ *     缓冲满时丢弃整条消息并计数（Debug_GetDroppedBytes）
+ * 0 = 阻塞发送（HAL_UART_Transmit，9600波特率下60字节约阻塞60ms）
+ */
+#define DEBUG_TX_DMA_ENABLE         1
+
+/**
+ * @brief 发送环形缓冲大小（字节，必须是2的幂）
+ * 9600波特率每秒约发送960字节，1024字节约可缓冲1秒的输出
+ */
+#define DEBUG_TX_RING_SIZE          1024
+
 /**
  * @brief 调试输出限流（毫秒）
  * 两次调试输出之间的最小间隔，用于防止刷屏
@@ -96,6 +113,22 @@
 #define DEBUG_MIN_INTERVAL          0
 
 
+/* ========== 日志后端 ========== */
+
+#define DEBUG_LOG_TEXT              0       // 设备端格式化，直接输出文本
+#define DEBUG_LOG_DEFERRED          1       // 只发送格式ID+参数，主机端还原
+
+/**
+ * @brief 日志后端（DLOG() 和 DEBUG_MOTOR() 等模块宏）
+ * DEBUG_LOG_TEXT     = 与 Debug_Printf 相同，串口监视器直接可读
+ * DEBUG_LOG_DEFERRED = 二进制帧，省去 vsnprintf，带宽约为文本的 1/5~1/10，
+ *                      需用 tools/log_decoder.py 配合 firmware.elf 解码
+ *                      （链接脚本见 ld/deferred_log.ld）
+ * Debug_Printf() 本身不受影响，始终输出文本
+ */
+#define DEBUG_LOG_BACKEND           DEBUG_LOG_TEXT
+
+
 /* ========== 高级选项 ========== */
 
 /**
@@ -106,78 +139,195 @@
 #define DEBUG_USE_COLOR             0
 
 /**
- * @brief 调试级别过滤
- * 1 = 启用调试级别过滤功能
- * 0 = 禁用级别过滤（所有调试信息都输出）
+ * @brief 包含文件名和行号
+ * 1 = 调试信息包含源文件名和行号
+ * 0 = 不包含文件名和行号
  */
-#define DEBUG_USE_LEVEL_FILTER      0
+#define DEBUG_SHOW_FILE_LINE        0
+
+
+/* ========== 日志级别 ========== */
+
+#define DEBUG_LEVEL_NONE            0
+#define DEBUG_LEVEL_ERROR           1
+#define DEBUG_LEVEL_WARN            2
+#define DEBUG_LEVEL_INFO            3
+#define DEBUG_LEVEL_DEBUG           4
 
 /**
- * @brief 默认调试级别
+ * @brief 调试级别过滤（编译时）
+ * 1 = 高于模块级别的 LOG_x() 语句编译为空（参数也不求值），不占代码和周期
+ * 0 = 所有 LOG_x() 都编译进来，只受运行时 Debug_Enable/Debug_Disable 控制
+ */
+#define DEBUG_USE_LEVEL_FILTER      1
+
+/**
+ * @brief 默认调试级别（未单独设置级别的模块使用）
  * 0 = 无输出
  * 1 = 仅错误 (ERROR)
  * 2 = 错误+警告 (WARN)
  * 3 = 错误+警告+信息 (INFO)
- * 4 = 全部 (DEBUG)
+ * 4 = 全部 (DEBUG，包括每个控制周期的原始数据)
  */
-#define DEBUG_DEFAULT_LEVEL         3
+#define DEBUG_DEFAULT_LEVEL         DEBUG_LEVEL_INFO
 
 /**
- * @brief 包含文件名和行号
- * 1 = 调试信息包含源文件名和行号
- * 0 = 不包含文件名和行号
+ * @brief 各模块级别
+ * 模块开关为1时取 DEBUG_DEFAULT_LEVEL，为0时只保留错误；
+ * 也可以单独指定，例如 build_flags 中加 -DDEBUG_LEVEL_SENSOR=4 只打开传感器的详细输出
  */
-#define DEBUG_SHOW_FILE_LINE        0
+#define DEBUG_MODULE_LEVEL_(enable) ((enable) ? DEBUG_DEFAULT_LEVEL : DEBUG_LEVEL_ERROR)
 
+#ifndef DEBUG_LEVEL_MOTOR
+#define DEBUG_LEVEL_MOTOR           DEBUG_MODULE_LEVEL_(DEBUG_MOTOR_ENABLE)
+#endif
+#ifndef DEBUG_LEVEL_SENSOR
+#define DEBUG_LEVEL_SENSOR          DEBUG_MODULE_LEVEL_(DEBUG_SENSOR_ENABLE)
+#endif
+#ifndef DEBUG_LEVEL_BT
+#define DEBUG_LEVEL_BT              DEBUG_MODULE_LEVEL_(DEBUG_BLUETOOTH_ENABLE)
+#endif
+#ifndef DEBUG_LEVEL_WIRELESS
+#define DEBUG_LEVEL_WIRELESS        DEBUG_MODULE_LEVEL_(DEBUG_WIRELESS_ENABLE)
+#endif
+#ifndef DEBUG_LEVEL_LINE
+#define DEBUG_LEVEL_LINE            DEBUG_MODULE_LEVEL_(DEBUG_LINE_FOLLOW_ENABLE)
+#endif
+#ifndef DEBUG_LEVEL_SYSTEM
+#define DEBUG_LEVEL_SYSTEM          DEBUG_MODULE_LEVEL_(DEBUG_SYSTEM_ENABLE)
+#endif
+#ifndef DEBUG_LEVEL_DRIVE
+#define DEBUG_LEVEL_DRIVE           DEBUG_MODULE_LEVEL_(DEBUG_DRIVE_ENABLE)
+#endif
+#ifndef DEBUG_LEVEL_SCRIPT
+#define DEBUG_LEVEL_SCRIPT          DEBUG_MODULE_LEVEL_(DEBUG_SCRIPT_ENABLE)
+#endif
+#ifndef DEBUG_LEVEL_POWER
+#define DEBUG_LEVEL_POWER           DEBUG_MODULE_LEVEL_(DEBUG_POWER_ENABLE)
+#endif
 
-/* ========== 调试宏定义 ========== */
 
-#if DEBUG_GLOBAL_ENABLE
+/* ========== 性能分析配置 ========== */
 
-    /* 模块调试宏 */
-    #if DEBUG_MOTOR_ENABLE
-        #define DEBUG_MOTOR(...)        Debug_Printf("[MOTOR] " __VA_ARGS__)
-    #else
-        #define DEBUG_MOTOR(...)        ((void)0)
-    #endif
+/**
+ * @brief 控制周期分段计时（DWT周期计数器）
+ * 1 = 在各阶段插入计时，统计min/avg/max/p99和超时次数
+ * 0 = 计时宏编译为空（不占用代码和RAM）
+ */
+#define CYCLE_BUDGET_ENABLE         0
 
-    #if DEBUG_SENSOR_ENABLE
-        #define DEBUG_SENSOR(...)       Debug_Printf("[SENSOR] " __VA_ARGS__)
-    #else
-        #define DEBUG_SENSOR(...)       ((void)0)
-    #endif
+/**
+ * @brief 控制周期预算（微秒）
+ * 整个控制周期（TICK）和一轮主循环（LOOP）超过该值计为一次超时
+ */
+#define CYCLE_BUDGET_DEADLINE_US    10000
 
-    #if DEBUG_BLUETOOTH_ENABLE
-        #define DEBUG_BT(...)           Debug_Printf("[BT] " __VA_ARGS__)
-    #else
-        #define DEBUG_BT(...)           ((void)0)
-    #endif
+/**
+ * @brief 采样分析器（TIM7中断采样被打断的PC）
+ * 1 = 启用，按钮短按时通过调试串口输出地址直方图，
+ *     用 tools/profile_symbolize.py 结合ELF符号生成函数级统计
+ * 0 = 不编译（不占用TIM7和RAM）
+ */
+#define PROFILER_SAMPLING_ENABLE    0
 
-    #if DEBUG_WIRELESS_ENABLE
-        #define DEBUG_WIRELESS(...)     Debug_Printf("[WIRELESS] " __VA_ARGS__)
-    #else
-        #define DEBUG_WIRELESS(...)     ((void)0)
-    #endif
+/**
+ * @brief 采样频率（Hz）
+ */
+#define PROFILER_SAMPLE_HZ          2000
+
+/**
+ * @brief 地址桶大小 = 2^PROFILER_BUCKET_SHIFT 字节
+ * 7 → 128字节/桶，覆盖256KB Flash需要2048个桶（4KB RAM）
+ */
+#define PROFILER_BUCKET_SHIFT       7
+
+/**
+ * @brief 飞行记录仪（控制事件环形缓冲，触发后冻结，见 flight_recorder.hpp）
+ * 1 = 常开，记录一条事件约二十个周期
+ * 0 = 记录宏编译为空
+ */
+#define FLIGHT_RECORDER_ENABLE      1
+
+/**
+ * @brief 缓冲容量（条，必须是2的幂，每条8字节）
+ */
+#define FLIGHT_RECORDER_EVENTS      256
+
+/**
+ * @brief 丢线持续超过该时长（毫秒）自动触发冻结，0 = 只由按钮/代码触发
+ */
+#define FLIGHT_RECORDER_LINE_LOST_MS 300
+
+/**
+ * @brief 指令延迟探针（蓝牙帧带发送方时间戳时逐级打点并回传，见 latency_probe.hpp）
+ * 1 = 记录 到达/解析/仲裁/CCR写入/PWM沿/速度到位 时间，用 tools/latency_report.py 统计
+ * 0 = 打点宏编译为空，带时间戳的帧照常执行但不回传
+ */
+#define LATENCY_PROBE_ENABLE        0
 
-    #if DEBUG_LINE_FOLLOW_ENABLE
-        #define DEBUG_LINE(...)         Debug_Printf("[LINE] " __VA_ARGS__)
+/**
+ * @brief 探针等待速度剖面到位的最长时间（毫秒），超时后未到达的阶段记为缺失
+ */
+#define LATENCY_PROBE_TIMEOUT_MS    1000
+
+
+/* ========== 调试宏定义 ========== */
+
+#if DEBUG_GLOBAL_ENABLE
+
+    /* 输出函数（延迟格式化后端只支持C++） */
+    #if DEBUG_LOG_BACKEND == DEBUG_LOG_DEFERRED && defined(__cplusplus)
+        #define DEBUG_OUT(...)          DLOG(__VA_ARGS__)
+        #define DEBUG_OUT_ALWAYS(...)   DLOG_ALWAYS(__VA_ARGS__)
     #else
-        #define DEBUG_LINE(...)         ((void)0)
+        #define DEBUG_OUT(...)          Debug_Printf(__VA_ARGS__)
+        #define DEBUG_OUT_ALWAYS(...)   Debug_Print_Always(__VA_ARGS__)
     #endif
 
-    #if DEBUG_SYSTEM_ENABLE
-        #define DEBUG_SYSTEM(...)       Debug_Printf("[SYSTEM] " __VA_ARGS__)
+    /**
+     * 分级日志：LOG_E/LOG_W/LOG_I/LOG_D(模块, 格式, 参数...)
+     * 模块名为 DEBUG_LEVEL_xxx 的后缀（MOTOR、SENSOR、LINE ...）
+     * 条件是编译期常量，被过滤的语句连同参数求值一起被编译器删除；
+     * ERROR/WARN 不受运行时 Debug_Disable() 影响
+     */
+    #if DEBUG_USE_LEVEL_FILTER
+        #define DEBUG_LOG_PASS_(mod, level)  ((level) <= DEBUG_LEVEL_##mod)
     #else
-        #define DEBUG_SYSTEM(...)       ((void)0)
+        #define DEBUG_LOG_PASS_(mod, level)  (1)
     #endif
 
-    /* 错误和警告总是输出 */
-    #define DEBUG_ERROR(...)            Debug_Print_Always("[ERROR] " __VA_ARGS__)
-    #define DEBUG_WARN(...)             Debug_Print_Always("[WARN] " __VA_ARGS__)
-    #define DEBUG_INFO(...)             Debug_Printf("[INFO] " __VA_ARGS__)
+    #define DEBUG_LOG_AT_(mod, level, out, ...)                 \
+        do {                                                    \
+            if (DEBUG_LOG_PASS_(mod, level)) {                  \
+                out(__VA_ARGS__);                               \
+            }                                                   \
+        } while (0)
+
+    #define LOG_E(mod, ...)     DEBUG_LOG_AT_(mod, DEBUG_LEVEL_ERROR, DEBUG_OUT_ALWAYS, __VA_ARGS__)
+    #define LOG_W(mod, ...)     DEBUG_LOG_AT_(mod, DEBUG_LEVEL_WARN, DEBUG_OUT_ALWAYS, __VA_ARGS__)
+    #define LOG_I(mod, ...)     DEBUG_LOG_AT_(mod, DEBUG_LEVEL_INFO, DEBUG_OUT, __VA_ARGS__)
+    #define LOG_D(mod, ...)     DEBUG_LOG_AT_(mod, DEBUG_LEVEL_DEBUG, DEBUG_OUT, __VA_ARGS__)
+
+    /* 模块调试宏（带模块前缀，INFO级别） */
+    #define DEBUG_MOTOR(...)            LOG_I(MOTOR, "[MOTOR] " __VA_ARGS__)
+    #define DEBUG_SENSOR(...)           LOG_I(SENSOR, "[SENSOR] " __VA_ARGS__)
+    #define DEBUG_BT(...)               LOG_I(BT, "[BT] " __VA_ARGS__)
+    #define DEBUG_WIRELESS(...)         LOG_I(WIRELESS, "[WIRELESS] " __VA_ARGS__)
+    #define DEBUG_LINE(...)             LOG_I(LINE, "[LINE] " __VA_ARGS__)
+    #define DEBUG_SYSTEM(...)           LOG_I(SYSTEM, "[SYSTEM] " __VA_ARGS__)
+
+    /* 错误和警告总是输出（级别过滤仍然生效） */
+    #define DEBUG_ERROR(...)            LOG_E(SYSTEM, "[ERROR] " __VA_ARGS__)
+    #define DEBUG_WARN(...)             LOG_W(SYSTEM, "[WARN] " __VA_ARGS__)
+    #define DEBUG_INFO(...)             LOG_I(SYSTEM, "[INFO] " __VA_ARGS__)
 
 #else
     /* 全局调试禁用时，所有宏都变成空操作 */
+    /* 条件恒为假：不生成代码，但参数仍参与类型检查（不会出现未使用变量警告） */
+    #define LOG_E(mod, ...)             do { if (0) { Debug_Printf(__VA_ARGS__); } } while (0)
+    #define LOG_W(mod, ...)             do { if (0) { Debug_Printf(__VA_ARGS__); } } while (0)
+    #define LOG_I(mod, ...)             do { if (0) { Debug_Printf(__VA_ARGS__); } } while (0)
+    #define LOG_D(mod, ...)             do { if (0) { Debug_Printf(__VA_ARGS__); } } while (0)
     #define DEBUG_MOTOR(...)            ((void)0)
     #define DEBUG_SENSOR(...)           ((void)0)
     #define DEBUG_BT(...)               ((void)0)
@@ -231,6 +381,11 @@
 1. 基本使用：
    DEBUG_MOTOR("速度设置为: %d\r\n", speed);
    DEBUG_SENSOR("传感器值: %d\r\n", value);
+
+   分级日志（模块, 格式, 参数...）：
+   LOG_I(SENSOR, "[LineSensor] 阈值: %d\r\n", threshold);
+   LOG_D(LINE, "pos=%d\r\n", pos);        // 默认级别INFO下整条语句不编译
+   LOG_E(MOTOR, "[MotorCal] 保存失败\r\n");
    
 2. 错误和警告：
    DEBUG_ERROR("初始化失败\r\n");
@@ -0,0 +1,165 @@
+/**
+ * @file    deferred_log.hpp
+ * @brief   延迟格式化二进制日志（只发送格式ID和参数，主机端还原文本）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * Debug_Printf 每次调用都要 vsnprintf，%f 还会拉进 newlib 的浮点格式化，
+ * 在 Cortex-M3 上一行就是几千个周期，输出的中文 UTF-8 文本也很占串口带宽。
+ *
+ * DLOG() 在调用处把格式字符串放进 .logfmt 段（ld/deferred_log.ld 把它标为 INFO，
+ * 只保留在ELF里，不烧录、不发送），运行时只发送：
+ *
+ *     0xA5 | LEN | ID(2, 小端) | 参数... | CRC8
+ *
+ * - ID：格式字符串在 .logfmt 段中的地址（低16位），链接时确定
+ * - LEN：ID + 参数的字节数
+ * - CRC8：crc::crc8(LEN .. 最后一个参数)
+ * - 整数（含 char/bool/枚举/指针）：zigzag 变长编码，0~63 只占1字节，传感器值2字节
+ * - float/double：4字节 IEEE754 float
+ * - 字符串：1字节长度 + 内容（最长 MAX_STRING 字节）
+ *
+ * 主机端 tools/log_decoder.py 从ELF的 .logfmt 段读出格式字符串，按转换说明符
+ * 依次解码参数并格式化；二进制帧与普通文本可以混在同一个串口里。
+ * 一次调用只有编码和 Debug_Write 的开销（几十个周期），不做任何格式化。
+ *
+ * 后端由 debug_config.h 的 DEBUG_LOG_BACKEND 选择，DEBUG_LOG_TEXT 时 DLOG()
+ * 直接展开为 Debug_Printf()，调用处不需要修改。
+ *
+ * 使用示例：
+ * @code
+ * DLOG("[LINE] pos=%d err=%.2f\r\n", position, error);
+ * DEBUG_LINE("lost %u ms\r\n", lost_ms);   // 模块宏同样走选定的后端
+ * @endcode
+ *
+ * 注意：
+ * - 格式字符串必须是字面量
+ * - 转换说明符按 C 语义解释（%u/%x 按32位无符号、%ll 按64位），
+ *   %f 的参数以 float 精度发送
+ * - 与 Debug_Printf 一样只能在主循环中调用（单生产者）
+ */
+
+#ifndef DEFERRED_LOG_HPP
+#define DEFERRED_LOG_HPP
+
+#include <stdint.h>
+#include <type_traits>
+
+#include "debug.hpp"
+#include "debug_config.h"
+
+namespace deferred_log {
+
+constexpr uint8_t FRAME_SYNC = 0xA5;    ///< 帧头
+constexpr uint8_t MAX_PAYLOAD = 64;     ///< ID + 参数最大字节数
+constexpr uint8_t MAX_STRING = 24;      ///< 字符串参数最多发送的字节数
+
+/**
+ * @brief 帧编码器（栈上缓冲，超长时整帧丢弃）
+ */
+class Writer {
+public:
+    explicit Writer(const char* format);
+
+    void putSigned(int32_t value) {
+        putVarint((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+    void putSigned64(int64_t value);
+    void putFloat(float value);
+    void putString(const char* str);
+
+    /**
+     * @brief 填写长度与CRC并写入调试输出
+     */
+    void finish();
+
+private:
+    static constexpr uint8_t HEADER = 2;  // SYNC + LEN
+
+    uint8_t buf_[HEADER + MAX_PAYLOAD + 1];
+    uint8_t len_;
+    bool overflow_;
+
+    void put(uint8_t byte) {
+        if (len_ < HEADER + MAX_PAYLOAD) {
+            buf_[len_++] = byte;
+        } else {
+            overflow_ = true;
+        }
+    }
+    void putVarint(uint32_t value) {
+        while (value >= 0x80u) {
+            put(static_cast<uint8_t>(value | 0x80u));
+            value >>= 7;
+        }
+        put(static_cast<uint8_t>(value));
+    }
+};
+
+/* ========== 按参数类型编码 ========== */
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+encode(Writer& w, T value) {
+    if (sizeof(T) > 4) {
+        w.putSigned64(static_cast<int64_t>(value));
+    } else {
+        w.putSigned(static_cast<int32_t>(value));
+    }
+}
+
+inline void encode(Writer& w, double value) { w.putFloat(static_cast<float>(value)); }
+
+inline void encode(Writer& w, const char* str) { w.putString(str); }
+
+template <typename T>
+inline void encode(Writer& w, const T* ptr) {
+    w.putSigned(static_cast<int32_t>(reinterpret_cast<uintptr_t>(ptr)));
+}
+
+/**
+ * @brief 编码并发送一条日志
+ * @param format .logfmt 段中的格式字符串（地址即ID）
+ */
+template <typename... Args>
+inline void emit(bool always, const char* format, Args... args) {
+    if (!always && !g_debug_enabled) {
+        return;
+    }
+    Writer w(format);
+    int expand[] = {0, (encode(w, args), 0)...};
+    (void)expand;
+    w.finish();
+}
+
+/**
+ * @brief 超长被丢弃的帧数
+ */
+uint32_t getOversizeCount();
+
+}  // namespace deferred_log
+
+/* ========== 调用宏 ========== */
+
+#if DEBUG_LOG_BACKEND == DEBUG_LOG_DEFERRED
+
+#define DLOG_EMIT_(always, fmt, ...)                                                     \
+    do {                                                                                 \
+        static const char dlog_fmt_[] __attribute__((section(".logfmt"), used)) = fmt;   \
+        deferred_log::emit(always, dlog_fmt_, ##__VA_ARGS__);                            \
+    } while (0)
+
+/// 延迟格式化日志（受 Debug_Enable/Debug_Disable 控制）
+#define DLOG(fmt, ...)          DLOG_EMIT_(false, fmt, ##__VA_ARGS__)
+/// 延迟格式化日志（总是输出）
+#define DLOG_ALWAYS(fmt, ...)   DLOG_EMIT_(true, fmt, ##__VA_ARGS__)
+
+#else
+
+#define DLOG(fmt, ...)          Debug_Printf(fmt, ##__VA_ARGS__)
+#define DLOG_ALWAYS(fmt, ...)   Debug_Print_Always(fmt, ##__VA_ARGS__)
+
+#endif
+
+#endif  // DEFERRED_LOG_HPP
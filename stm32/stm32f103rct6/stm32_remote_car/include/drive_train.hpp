@@ -10,6 +10,8 @@
 
 #include "../include/motor.hpp"
 #include "../include/motion_profile.hpp"
+#include "../include/skid_steer.hpp"
+#include "../include/supply_monitor.hpp"
 
 class DriveTrain {
 public:
@@ -49,29 +51,45 @@ public:
      * @param straightSpeed 目标直行速度 (-100 到 100)
      * @param turnSpeed 目标转向速度 (-100 到 100)
      * 
-     * 实际速度会按照梯形速度轮廓平滑过渡到目标速度
+     * 实际速度会按照S曲线速度轮廓平滑过渡到目标速度
      */
     void setTargetSpeed(int straightSpeed, int turnSpeed = 0);
 
+    /**
+     * @brief 设置目标速度（Q8定点，亚百分比精度）
+     * @param straightQ8 目标直行速度（1/256 %，-25600 到 25600）
+     * @param turnQ8 目标转向速度（1/256 %）
+     */
+    void setTargetSpeedQ8(int32_t straightQ8, int32_t turnQ8 = 0);
+
     /**
      * @brief 更新速度轮廓（需在主循环中定期调用）
      * 
-     * 根据梯形速度轮廓算法更新当前速度，实现平滑加减速
+     * 按实际经过时间积分S曲线速度轮廓，实现平滑加减速
      * 建议调用频率：每 10-20ms 调用一次
      */
     void update();
 
     /**
-     * @brief 设置加速度参数
-     * @param acceleration 加速度（每次更新增加的速度值，默认5）
-     * @param deceleration 减速度（每次更新减少的速度值，默认8）
-     * @param reverseDeceleration 反向减速度（反向切换时的减速度，默认12）
+     * @brief 设置加速度参数（兼容旧接口，按每20ms的速度步长换算）
+     * @param acceleration 加速度（每20ms增加的速度值）
+     * @param deceleration 减速度（每20ms减少的速度值）
+     * @param reverseDeceleration 反向减速度（反向切换时的减速度）
      */
     void setAcceleration(int acceleration, int deceleration, int reverseDeceleration);
 
     /**
-     * @brief 设置速度更新间隔
-     * @param intervalMs 更新间隔（毫秒，默认20ms）
+     * @brief 设置S曲线加速度与加加速度限制
+     * @param acceleration 加速度（%/s，默认400）
+     * @param deceleration 减速度（%/s，默认600）
+     * @param reverseDeceleration 反向刹车减速度（%/s，默认800）
+     * @param jerk 加加速度（%/s²，默认4000，越小起步越柔和、越不易打滑）
+     */
+    void setMotionLimits(int acceleration, int deceleration, int reverseDeceleration, int jerk);
+
+    /**
+     * @brief 设置速度最小更新间隔
+     * @param intervalMs 最小更新间隔（毫秒，默认0；积分按实际经过时间计算）
      */
     void setUpdateInterval(uint32_t intervalMs);
 
@@ -90,6 +108,29 @@ public:
      */
     void driveImmediate(int straightSpeed, int turnSpeed);
 
+    /**
+     * @brief 立即驱动（浮点速度，小数部分不会被截断）
+     */
+    void driveImmediate(float straightSpeed, float turnSpeed);
+
+    /**
+     * @brief 立即驱动（Q8定点速度，1/256 %）
+     */
+    void driveImmediateQ8(int32_t straightQ8, int32_t turnQ8);
+
+    /**
+     * @brief 直接输出左右轮速度（Q8，前进为正），并同步速度剖面实现无扰切换
+     * @param leftQ8 左轮速度（1/256 %）
+     * @param rightQ8 右轮速度（1/256 %）
+     */
+    void driveWheelsQ8(int32_t leftQ8, int32_t rightQ8);
+
+    /**
+     * @brief 最近一次输出的左右轮速度（Q8，前进为正，用于位姿估计与遥测）
+     */
+    int32_t getLeftOutputQ8() const { return outputLeftQ8_; }
+    int32_t getRightOutputQ8() const { return outputRightQ8_; }
+
     /**
      * @brief 获取当前直行速度指令
      * @return 当前直行速度 (-100 到 100)
@@ -114,6 +155,40 @@ public:
      */
     void setMinForwardFloor(int floor);
 
+    /**
+     * @brief 设置原地转向速度降低系数（减少打滑，默认0.8）
+     * @param reduction 0.1 - 1.0
+     */
+    void setSpotTurnReduction(float reduction);
+
+    /**
+     * @brief 设置原地转向最小有效轮速（通常由 SpotTurnCalibration::apply() 设置）
+     * @param minSpeedQ8 标定的最小有效轮速（1/256 %），实际下限再加 SPOT_TURN_MARGIN
+     */
+    void setMinSpotTurnSpeedQ8(int32_t minSpeedQ8);
+
+    int32_t getMinSpotTurnSpeedQ8() const { return min_spot_turn_q8_; }
+
+    static constexpr int SPOT_TURN_MARGIN = 3;  ///< 原地转向下限相对标定值的余量（%）
+
+    /**
+     * @brief 设置四轮滑移转向几何（前后轮独立速度）
+     * @param geometry 轴距、轮距、ICR偏移和混合比例，blend_pct=0 关闭（默认）
+     *
+     * 转弯时离瞬时转动中心远的车轮给得更快，减少侧滑拖拽，弯道掉速更少。
+     */
+    void setSkidSteerGeometry(const skid_steer::Geometry& geometry);
+
+    const skid_steer::Geometry& getSkidSteerGeometry() const { return skidSteer_; }
+
+    /**
+     * @brief 设置电源电压补偿（nullptr 关闭，默认关闭）
+     * @param supply 电源监测，输出到电机前按其增益放大轮速
+     *
+     * getLeftOutputQ8()/getRightOutputQ8() 仍为补偿前的速度（即期望的实际速度）。
+     */
+    void setSupplyMonitor(const SupplyMonitor* supply) { supply_ = supply; }
+
 private:
     Motor leftFrontMotor_;
     Motor leftBackMotor_;
@@ -129,6 +204,14 @@ private:
     // 可调参数
     float turn_sensitivity_ = 0.8f;   // 转向灵敏度
     int min_forward_floor_ = 0;       // 最小前进速度底线（0表示关闭）
+    float spot_turn_reduction_ = 0.80f;                   // 原地转向速度降低系数（光滑地面也转不动时用更低值）
+    int32_t min_spot_turn_q8_ = 25 * fixed_math::Q8_ONE;  // 原地转向最小有效速度（Q8，未标定时25%）
+    skid_steer::Geometry skidSteer_ = skid_steer::defaultGeometry();  // 四轮滑移转向几何
+    const SupplyMonitor* supply_ = nullptr;                            // 电源电压补偿（可选）
+
+    // 最近一次输出（Q8，前进为正）
+    int32_t outputLeftQ8_ = 0;
+    int32_t outputRightQ8_ = 0;
 
     /**
      * @brief 应用死区滤波消除噪声
@@ -136,7 +219,7 @@ private:
      * @param threshold 死区阈值
      * @return 滤波后的值
      */
-    int applyDeadband(int value, int threshold);
+    int32_t applyDeadband(int32_t value, int32_t threshold);
 
     /**
      * @brief 限制速度到有效范围 [-100, 100]
@@ -145,17 +228,39 @@ private:
      */
     int clampSpeed(int value);
 
+    /**
+     * @brief 限制Q8速度到有效范围 [-25600, 25600]
+     */
+    int32_t clampSpeedQ8(int32_t value);
+
     /**
      * @brief 当超出限制时按比例归一化速度
-     * @param leftSpeed 左侧速度（会被修改）
-     * @param rightSpeed 右侧速度（会被修改）
+     * @param leftSpeed 左侧速度（Q8，会被修改）
+     * @param rightSpeed 右侧速度（Q8，会被修改）
      */
-    void normalizeSpeed(int& leftSpeed, int& rightSpeed);
+    void normalizeSpeed(int32_t& leftSpeed, int32_t& rightSpeed);
 
     /**
      * @brief 将当前速度应用到电机
      */
     void applySpeedToMotors();
+
+    /**
+     * @brief 差速混合并输出到电机（Q8定点）
+     * @param straightQ8 直行速度（1/256 %）
+     * @param turnQ8 转向速度（1/256 %）
+     */
+    void mixToMotorsQ8(int32_t straightQ8, int32_t turnQ8);
+
+    /**
+     * @brief 左右轮速度（前进为正）写到四个电机
+     */
+    void outputWheelsQ8(int32_t leftSpeed, int32_t rightSpeed);
+
+    /**
+     * @brief 提交四个电机的暂存脉宽（同一帧生效）
+     */
+    void commitMotors();
 };
 
 #endif // DRIVE_TRAIN_HPP
@@ -9,7 +9,7 @@
  * - 工作模式切换（透传/配置/省电/唤醒）
  * - 数据收发（基于 USART）
  * - 状态检查（AUX 引脚）
- * - 接收回调机制
+ * - 接收回调机制（中断只入队，主循环 poll() 里回调）
  * 
  * 硬件连接（基于原理图）：
  * - PA6  -> E49 M0  (模式选择位0)
@@ -21,6 +21,7 @@
 #define E49_WIRELESS_HPP
 
 #include "stm32f1xx_hal.h"
+#include "spsc_ring.hpp"
 #include <cstdint>
 #include <functional>
 
@@ -107,6 +108,8 @@ public:
      * @brief 设置数据接收回调函数
      * @param callback 回调函数，参数为接收到的字节
      * 
+     * 回调在 poll() 中（主循环上下文）执行。
+     *
      * 示例：
      * wireless.setDataReceivedCallback([](uint8_t data) {
      *     // 处理接收到的数据
@@ -117,9 +120,22 @@ public:
     /**
      * @brief 数据接收处理（由中断调用）
      * @param data 接收到的字节
-     * @note 此函数应在 UART 接收中断回调中调用
+     * @note 此函数应在 UART 接收中断回调中调用，只把字节放入接收队列，
+     *       回调在 poll() 中执行
      */
     void onDataReceived(uint8_t data);
+
+    /**
+     * @brief 取出接收队列中的字节并依次调用回调（主循环中调用）
+     * @note 必须调用：回调只在这里执行，不调用 poll() 就收不到任何数据。
+     *       接入 RemoteControl 时由 RemoteControl::update() 调用，单独使用时需在主循环中调用
+     */
+    void poll();
+
+    /**
+     * @brief 接收队列满被丢弃的字节数（累计）
+     */
+    uint32_t getDroppedBytes() const { return rxRing_.overflowCount(); }
     
     // ========== 状态查询 ==========
     
@@ -139,6 +155,7 @@ private:
     // ========== 成员变量 ==========
     Mode currentMode_;                          // 当前工作模式
     std::function<void(uint8_t)> dataCallback_; // 数据接收回调函数
+    SpscRing<uint8_t, 64> rxRing_;              // 接收队列（中断写入，poll() 读取）
     
     // ========== 内部辅助函数 ==========
     
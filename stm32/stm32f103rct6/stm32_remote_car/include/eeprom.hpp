@@ -46,7 +46,8 @@
  * - 0x00-0x0F: 基本配置参数（16字节）
  * - 0x10-0x3F: PID参数等（48字节）
  * - 0x40-0x7F: 传感器校准数据（64字节）
- * - 0x80-0xFF: 用户自定义数据（128字节）
+ * - 0x80-0xAC: 电机速度曲线（MotorCalibration，45字节）
+ * - 0xAD-0xFF: 用户自定义数据
  */
 
 #ifndef __EEPROM_HPP
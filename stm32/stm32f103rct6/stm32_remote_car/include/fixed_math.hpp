@@ -0,0 +1,79 @@
+/**
+ * @file    fixed_math.hpp
+ * @brief   定点数学工具（整数开方、Q15正弦表等）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * Cortex-M3没有FPU，控制环中的定点运算统一放在这里。
+ */
+
+#ifndef FIXED_MATH_HPP
+#define FIXED_MATH_HPP
+
+#include <stdint.h>
+
+namespace fixed_math {
+
+/// Q8定点：1.0 对应 256（速度以 1/256 % 为单位）
+constexpr int32_t Q8_ONE = 256;
+
+/**
+ * @brief 浮点转Q8（四舍五入）
+ */
+inline int32_t toQ8(float value) {
+    return static_cast<int32_t>(value * Q8_ONE + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+/**
+ * @brief 64位整数开方（向下取整）
+ * @param value 被开方数
+ * @return floor(sqrt(value))
+ */
+inline uint32_t isqrt64(uint64_t value) {
+    uint64_t result = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(result);
+}
+
+/**
+ * @brief 限幅
+ */
+inline int32_t clamp(int32_t value, int32_t lo, int32_t hi) {
+    return (value < lo) ? lo : (value > hi) ? hi : value;
+}
+
+/**
+ * @brief 二进制角度：一整圈 = 65536
+ */
+constexpr uint32_t ANGLE_FULL_TURN = 65536u;
+
+/**
+ * @brief Q15正弦（四分之一周期查表 + 线性插值）
+ * @param angle 二进制角度（65536 = 360°）
+ * @return sin(angle)，Q15（32767 ≈ 1.0）
+ */
+int16_t sinQ15(uint16_t angle);
+
+/**
+ * @brief Q15余弦
+ * @param angle 二进制角度（65536 = 360°）
+ */
+inline int16_t cosQ15(uint16_t angle) {
+    return sinQ15(static_cast<uint16_t>(angle + ANGLE_FULL_TURN / 4));
+}
+
+}  // namespace fixed_math
+
+#endif  // FIXED_MATH_HPP
@@ -0,0 +1,178 @@
+/**
+ * @file    flight_recorder.hpp
+ * @brief   控制事件飞行记录仪（RAM环形缓冲，触发后冻结）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 小车冲出赛道时，出事前那两秒早就被串口刷过去了。飞行记录仪一直在RAM里循环记录
+ * 状态切换、恢复动作、指令到达、参数修改、超时和队列溢出等事件，每条8字节：
+ *
+ *     DWT周期计数(4) | 事件类型(1) | 参数a(1) | 参数b(2)
+ *
+ * 记录一条约二十个周期，中断中也可以调用。满足触发条件（丢线超过N毫秒、按钮、
+ * 代码中手动触发）后再记录 post_events 条就冻结缓冲，保留“触发前 + 触发后”的窗口，
+ * 之后随时用 dump() 从调试串口导出，时间以触发时刻为0，单位微秒。
+ * 导出不阻塞主循环：dump() 只记下窗口，之后每次 update() 在发送缓冲有空间时输出一行，
+ * 9600 波特率下 256 条约需十秒，期间控制循环和仲裁器照常运行。
+ *
+ * 在 debug_config.h 中设置 FLIGHT_RECORDER_ENABLE 为 0 时，所有宏编译为空。
+ *
+ * 使用示例：
+ * @code
+ * FR_INIT();
+ * FR_RECORD(FrEvent::STATE, State::LINE_LOST, position);
+ *
+ * // 主循环中
+ * FR_UPDATE();                           // 检查丢线时长触发，导出时逐行输出
+ * if (button.isShortPressed(3000)) {
+ *     FR_BUTTON();                       // 第一次按：冻结；再按：导出，导出完重新记录
+ * }
+ * @endcode
+ *
+ * 输出格式（调试串口）：
+ * @code
+ * FLIGHT BEGIN events=256 trigger=line_lost tick=48213 post=64 frozen=1
+ *   -1834512 us  param      a=3 b=24
+ *       ...
+ *    -300127 us  state      a=2 b=412
+ *    -300119 us  recovery   a=0 b=14
+ *          0 us  trigger    a=1 b=300
+ *       ...
+ * FLIGHT END
+ * @endcode
+ */
+
+#ifndef FLIGHT_RECORDER_HPP
+#define FLIGHT_RECORDER_HPP
+
+#include <stdint.h>
+#include "debug_config.h"
+
+/**
+ * @brief 事件类型（参数a/b的含义见各项注释）
+ */
+enum class FrEvent : uint8_t {
+    STATE = 0,        ///< 巡线状态切换：a=新状态（LineFollowerPID::State），b=线位置
+    RECOVERY,         ///< 丢线处理动作：a=0降速沿上次位置（b=轮速）/1找回线后重置跟踪器（b=线位置）
+    SOURCE_SWITCH,    ///< 仲裁器切换指令源：a=新源（MotionSource），b=旧源
+    COMMAND,          ///< 非巡线指令到达：a=指令源，b=模式（1目标/2轮速/3停止/0撤销）
+    PARAM,            ///< 参数修改：a=参数编号（FrParam），b=新值（按参数约定缩放）
+    DEADLINE_MISS,    ///< 控制周期超时：a=阶段（BudgetStage），b=实际间隔或耗时(us，饱和到32767)
+    QUEUE_OVERFLOW,   ///< 队列溢出：a=队列编号（FrQueue），b=本次丢弃的字节数（饱和）
+    BUTTON,           ///< 按钮：a=1短按/2长按
+    TRIGGER,          ///< 触发点：a=触发原因（FrTrigger），b=参数
+    MARK,             ///< 自定义标记
+    COUNT
+};
+
+/// STATE 事件中表示丢线的状态值（与 LineFollowerPID::State::LINE_LOST 一致）
+constexpr uint8_t FR_STATE_LINE_LOST = 2;
+
+/**
+ * @brief 参数编号（FrEvent::PARAM 的参数a）
+ */
+enum class FrParam : uint8_t {
+    KP = 0,           ///< b = Kp×1000
+    KI,               ///< b = Ki×1000
+    KD,               ///< b = Kd×1000
+    BASE_SPEED,       ///< b = 基础速度(%)
+};
+
+/**
+ * @brief 队列编号（FrEvent::QUEUE_OVERFLOW 的参数a）
+ */
+enum class FrQueue : uint8_t {
+    DEBUG_TX = 0,     ///< 调试发送环形缓冲
+    BT_RX,            ///< 蓝牙接收队列
+};
+
+/**
+ * @brief 触发原因
+ */
+enum class FrTrigger : uint8_t {
+    NONE = 0,
+    LINE_LOST,        ///< 丢线持续超过设定时长
+    BUTTON,           ///< 按钮
+    MANUAL,           ///< 代码中调用 trigger()
+    COUNT
+};
+
+#if FLIGHT_RECORDER_ENABLE
+
+namespace FlightRecorder {
+
+/**
+ * @brief 使能DWT周期计数器并开始记录
+ * @param post_events 触发后继续记录的事件数（0 = 触发即冻结，默认为容量的1/4）
+ */
+void init(uint16_t post_events = FLIGHT_RECORDER_EVENTS / 4);
+
+/**
+ * @brief 记录一条事件（冻结后直接返回，可在中断中调用）
+ */
+void record(FrEvent type, uint8_t a, int16_t b);
+
+/**
+ * @brief 立即触发（之后再记录 post_events 条后冻结）
+ */
+void trigger(FrTrigger reason, int16_t arg = 0);
+
+/**
+ * @brief 周期检查触发条件，导出期间输出下一行（主循环调用）
+ */
+void update();
+
+/**
+ * @brief 丢线持续超过该时长时自动触发（0 = 关闭）
+ */
+void setLineLostTrigger(uint16_t ms);
+
+/**
+ * @brief 按钮短按：未冻结时触发，已冻结时开始导出，导出完成后重新开始记录（导出期间忽略）
+ */
+void onButton();
+
+/**
+ * @brief 是否已冻结（触发后记录完 post_events 条）
+ */
+bool isFrozen();
+
+/**
+ * @brief 开始通过调试串口导出冻结窗口（未冻结时导出当前缓冲，导出期间暂停记录）
+ *
+ * 不阻塞：这里只记下窗口，由之后的 update() 在发送缓冲有空间时逐行输出。
+ */
+void dump();
+
+/**
+ * @brief 是否正在导出
+ */
+bool isDumping();
+
+/**
+ * @brief 清空缓冲并重新开始记录
+ */
+void rearm();
+
+}  // namespace FlightRecorder
+
+#define FR_INIT()                   FlightRecorder::init()
+#define FR_RECORD(type, a, b)       FlightRecorder::record((type), static_cast<uint8_t>(a), static_cast<int16_t>(b))
+#define FR_TRIGGER(reason)          FlightRecorder::trigger(reason)
+#define FR_UPDATE()                 FlightRecorder::update()
+#define FR_DUMP()                   FlightRecorder::dump()
+#define FR_BUTTON()                 FlightRecorder::onButton()
+
+#else
+
+#define FR_INIT()                   ((void)0)
+#define FR_RECORD(type, a, b)       ((void)0)
+#define FR_TRIGGER(reason)          ((void)0)
+#define FR_UPDATE()                 ((void)0)
+#define FR_DUMP()                   ((void)0)
+#define FR_BUTTON()                 ((void)0)
+
+#endif  // FLIGHT_RECORDER_ENABLE
+
+#endif  // FLIGHT_RECORDER_HPP
@@ -0,0 +1,119 @@
+/**
+ * @file    latency_probe.hpp
+ * @brief   指令端到端延迟探针（手机/上位机 → 串口 → 解析 → 仲裁 → PWM）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 遥控手感发涩时，要知道延迟花在哪一段：BLE/ESP32-S3 转发、UART、解析、
+ * 仲裁器、MotionProfile 斜坡，还是 50Hz PWM 帧。蓝牙摇杆/按键帧在载荷末尾
+ * 附带4字节发送方时间戳时（见 bt_protocol.hpp），探针依次记录：
+ *
+ * | 阶段 | 打点位置 |
+ * |------|----------|
+ * | rx     | 帧最后一个字节所在的那段数据进入接收队列（串口中断） |
+ * | parse  | 帧解析完成，交给 RemoteControl 之前 |
+ * | accept | 仲裁器 update() 第一次选中该指令源 |
+ * | ccr    | 之后第一次 Motor::commit() 写入CCR |
+ * | edge   | 新脉宽开始输出（CCR写入 + 距下一个更新事件的时间） |
+ * | settle | 速度剖面第一次到达目标（斜坡结束） |
+ *
+ * 时间用DWT周期计数，完成或超时后换算成本机微秒时间（HAL_GetTick + SysTick），
+ * 由 BluetoothControl 用 LATENCY 帧回传。上位机用 tools/latency_report.py
+ * 估计两边的时钟偏差，统计每一段的延迟分布。
+ *
+ * 同一时间只跟踪一条指令，前一条未完成时新的带时间戳指令照常执行、不打点。
+ * 在 debug_config.h 中设置 LATENCY_PROBE_ENABLE 为 0 时，所有宏编译为空。
+ */
+
+#ifndef LATENCY_PROBE_HPP
+#define LATENCY_PROBE_HPP
+
+#include <stdint.h>
+#include "debug_config.h"
+#include "stm32f1xx_hal.h"
+
+/// 未到达的阶段
+constexpr uint16_t LATENCY_MISSING = 0xFFFF;
+
+/**
+ * @brief 一条指令的打点结果
+ */
+struct LatencyResult {
+    uint32_t sender_ts;   ///< 发送方时间戳（原样回传）
+    uint32_t rx_us;       ///< 到达时刻（本机微秒时间）
+    uint16_t parse_us;    ///< 以下均相对 rx，单位微秒，饱和到 0xFFFE
+    uint16_t accept_us;
+    uint16_t ccr_us;
+    uint16_t edge_us;
+    uint16_t settle_ms;   ///< 相对 rx，单位毫秒
+};
+
+#if LATENCY_PROBE_ENABLE
+
+namespace LatencyProbe {
+
+/**
+ * @brief 使能DWT周期计数器
+ */
+void init();
+
+/**
+ * @brief 本机微秒时间（HAL_GetTick×1000 + SysTick 计数，约71分钟回绕）
+ */
+uint32_t nowUs();
+
+/**
+ * @brief 开始跟踪一条指令（解析完成时调用）
+ * @param sender_ts 帧中的发送方时间戳
+ * @param rx_cycles 帧到达时的DWT计数
+ * @return false=上一条尚未完成，本条不跟踪
+ */
+bool begin(uint32_t sender_ts, uint32_t rx_cycles);
+
+/**
+ * @brief 仲裁器收到非巡线指令（MotionArbiter::store）
+ */
+void onSubmit(uint8_t source);
+
+/**
+ * @brief 仲裁器选出执行者（MotionArbiter::update）
+ */
+void onArbiter(uint8_t winner);
+
+/**
+ * @brief CCR写入完成（Motor::commit）
+ */
+void onPwmCommit(TIM_HandleTypeDef* htim);
+
+/**
+ * @brief 速度剖面更新后（DriveTrain::update）
+ * @param settled 直行/转向都已到达目标
+ */
+void onProfile(bool settled);
+
+/**
+ * @brief 取出已完成（或超时）的结果，主循环调用
+ * @return true=有结果
+ */
+bool poll(LatencyResult& out);
+
+}  // namespace LatencyProbe
+
+#define LATENCY_INIT()              LatencyProbe::init()
+#define LATENCY_ON_SUBMIT(source)   LatencyProbe::onSubmit(static_cast<uint8_t>(source))
+#define LATENCY_ON_ARBITER(winner)  LatencyProbe::onArbiter(static_cast<uint8_t>(winner))
+#define LATENCY_ON_PWM(htim)        LatencyProbe::onPwmCommit(htim)
+#define LATENCY_ON_PROFILE(settled) LatencyProbe::onProfile(settled)
+
+#else
+
+#define LATENCY_INIT()              ((void)0)
+#define LATENCY_ON_SUBMIT(source)   ((void)0)
+#define LATENCY_ON_ARBITER(winner)  ((void)0)
+#define LATENCY_ON_PWM(htim)        ((void)0)
+#define LATENCY_ON_PROFILE(settled) ((void)0)
+
+#endif  // LATENCY_PROBE_ENABLE
+
+#endif  // LATENCY_PROBE_HPP
@@ -35,11 +35,17 @@
 #ifndef LINE_FOLLOWER_PID_HPP
 #define LINE_FOLLOWER_PID_HPP
 
+#include "line_position_tracker.hpp"
 #include "line_sensor.hpp"
 #include "motor.hpp"
 #include "pid_controller.hpp"
+#include "signal_chain.hpp"
+#include "skid_steer.hpp"
+#include "supply_monitor.hpp"
 #include <stdint.h>
 
+class MotionArbiter;
+
 class LineFollowerPID {
 public:
     /**
@@ -150,6 +156,42 @@ public:
      */
     float getError() const { return error_; }
 
+    /**
+     * @brief 获取估计的线位置变化率
+     * @return 变化率（单位/秒）
+     */
+    float getPositionRate() const { return tracker_.getRate(); }
+
+    /**
+     * @brief 设置线位置跟踪器参数
+     * @param alpha 位置增益（0~1）
+     * @param beta 速度增益（0~1）
+     * @param input_gain 每1%差速产生的位置变化率（单位/秒）
+     */
+    void setTrackerParameters(float alpha, float beta, float input_gain);
+
+    /**
+     * @brief 设置输出目标（运动仲裁器）
+     * @param arbiter 仲裁器指针，nullptr 表示直接驱动电机
+     *
+     * 设置后 update() 把左右轮速度以 LINE_FOLLOWER 源提交给仲裁器，
+     * 由仲裁器统一输出；stop() 撤销租期，让其他指令源接管。
+     */
+    void setOutputSink(MotionArbiter* arbiter) { output_sink_ = arbiter; }
+
+    /// 巡线指令租期（毫秒），控制循环停顿超过此时间后仲裁器不再执行巡线输出
+    static constexpr uint32_t OUTPUT_LEASE_MS = 100;
+
+    /**
+     * @brief 设置四轮滑移转向几何（仅直接驱动电机时使用，经仲裁器时由 DriveTrain 混合）
+     */
+    void setSkidSteerGeometry(const skid_steer::Geometry& geometry) { skid_steer_ = geometry; }
+
+    /**
+     * @brief 设置电源电压补偿（仅直接驱动电机时使用，经仲裁器时由 DriveTrain 补偿）
+     */
+    void setSupplyMonitor(const SupplyMonitor* supply) { supply_ = supply; }
+
     /**
      * @brief 获取PID输出
      * @return PID输出值
@@ -160,13 +202,19 @@ public:
      * @brief 获取当前左侧速度
      * @return 左侧速度
      */
-    int getLeftSpeed() const { return left_speed_; }
+    int getLeftSpeed() const { return static_cast<int>(left_speed_); }
 
     /**
      * @brief 获取当前右侧速度
      * @return 右侧速度
      */
-    int getRightSpeed() const { return right_speed_; }
+    int getRightSpeed() const { return static_cast<int>(right_speed_); }
+
+    /**
+     * @brief 获取左右侧速度指令（Q8，1/256 %，前进为正）
+     */
+    int32_t getLeftSpeedQ8() const { return fixed_math::toQ8(left_speed_); }
+    int32_t getRightSpeedQ8() const { return fixed_math::toQ8(right_speed_); }
 
     /**
      * @brief 获取最近一次更新时的原始传感器数据（用于显示）
@@ -230,6 +278,31 @@ private:
     // PID控制器
     PIDController pid_;
 
+    // 线位置状态估计（位置 + 变化率）
+    LinePositionTracker tracker_;
+
+    // 输出目标（nullptr 时直接写电机）
+    MotionArbiter* output_sink_ = nullptr;
+
+    // 四轮滑移转向几何（直接写电机时使用）
+    skid_steer::Geometry skid_steer_ = skid_steer::defaultGeometry();
+
+    // 电源电压补偿（直接写电机时使用，nullptr 关闭）
+    const SupplyMonitor* supply_ = nullptr;
+
+    /**
+     * @brief PID后处理链（编译期组合，调整顺序或替换环节只需修改这里）
+     *
+     * 平滑已由跟踪器完成，默认不包含 Deadband/SlewLimit/LowPass；
+     * 实验时可插入例如 signal_chain::SlewLimit<8000, 2000>。
+     */
+    using PostChain = signal_chain::Chain<signal_chain::Clamp,
+                                          signal_chain::Normalize,
+                                          signal_chain::DynamicMaxAdjust,
+                                          signal_chain::DifferentialMix,
+                                          signal_chain::SpeedClamp>;
+    PostChain post_chain_;
+
     // 配置参数
     LineMode line_mode_;        // 线模式
     int base_speed_;            // 基础速度
@@ -256,16 +329,23 @@ private:
     float error_;               // 当前误差
     float last_position_;       // 上次线位置（用于丢线处理）
     float pid_output_;          // PID输出
-    int left_speed_;            // 左侧速度
-    int right_speed_;           // 右侧速度
+    float left_speed_;          // 左侧速度（保留小数，输出时转Q8）
+    float right_speed_;         // 右侧速度
     uint32_t last_update_time_; // 上次更新时间
 
     /**
-     * @brief 应用速度到电机
+     * @brief 应用速度到电机（Q8亚百分比精度）
      * @param left_speed 左侧速度
      * @param right_speed 右侧速度
      */
-    void applySpeed(int left_speed, int right_speed);
+    void applySpeed(float left_speed, float right_speed);
+
+    /**
+     * @brief 应用整数速度到电机（兼容接口）
+     */
+    void applySpeed(int left_speed, int right_speed) {
+        applySpeed(static_cast<float>(left_speed), static_cast<float>(right_speed));
+    }
 
     /**
      * @brief 限制速度范围
@@ -295,14 +375,8 @@ private:
     uint16_t last_sensor_data_[8] = {0};
     bool last_binary_data_[8] = {false};
 
-    // 上一次的调整系数（用于限幅与平滑，避免左右快速来回抖动）
-    float last_adjustment_factor_ = 0.0f;
-
-    // 方向判定（基于线位置的滞回判断）：true=左侧为内侧（应当减速），false=右侧为内侧
-    bool last_inner_left_ = true;
-    // 方向滞回阈值（单位与position一致，-1000..1000），低阈值用于保持，高阈值用于切换
-    float dir_hyst_low_ = 80.0f;
-    float dir_hyst_high_ = 150.0f;
+    // 上一帧的指令差速（右速 - 左速），作为跟踪器的过程输入
+    float last_differential_ = 0.0f;
 
     // 是否反转位置符号
     bool invert_position_ = false;
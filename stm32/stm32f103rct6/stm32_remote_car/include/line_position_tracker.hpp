@@ -0,0 +1,102 @@
+/**
+ * @file    line_position_tracker.hpp
+ * @brief   线位置 α-β 跟踪器（状态估计）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 状态：线位置 p（-1000..1000）与位置变化率 v（单位/秒，赛道弯曲等未建模漂移）。
+ * 过程模型把上一帧指令差速 u = 右速 - 左速 作为输入：
+ *
+ *     p' = v + k·u
+ *
+ * 每帧先预测，再用传感器位置修正：
+ *
+ *     r = z - p̂
+ *     p̂ += α·r
+ *     v̂ += (β/dt)·r
+ *
+ * 传感器间隔285.7单位，线在两探头之间切换会产生跳变。残差超过门限的帧被拒绝（只做预测），
+ * 连续拒绝超过 max_rejects 帧则认为线确实跳变，直接重新锚定到测量值。
+ *
+ * 使用示例：
+ * @code
+ * tracker.predict(dt, right_speed - left_speed);
+ * tracker.correct(line_position);
+ * pid.compute(0.0f, tracker.getPosition(), tracker.getRate(), dt);
+ * @endcode
+ */
+
+#ifndef LINE_POSITION_TRACKER_HPP
+#define LINE_POSITION_TRACKER_HPP
+
+#include <stdint.h>
+
+class LinePositionTracker {
+public:
+    LinePositionTracker();
+
+    /**
+     * @brief 重置状态
+     * @param position 初始位置
+     */
+    void reset(float position = 0.0f);
+
+    /**
+     * @brief 时间更新（预测）
+     * @param dt 时间间隔（秒）
+     * @param differential 上一帧指令差速（右速 - 左速，单位：速度百分比）
+     */
+    void predict(float dt, float differential);
+
+    /**
+     * @brief 量测更新（修正）
+     * @param measured 传感器线位置
+     * @return true 测量被接受，false 被门限拒绝
+     */
+    bool correct(float measured);
+
+    /**
+     * @brief 设置滤波增益
+     * @param alpha 位置增益（0~1，越大越信任传感器）
+     * @param beta 速度增益（0~1）
+     */
+    void setGains(float alpha, float beta);
+
+    /**
+     * @brief 设置差速输入增益
+     * @param gain 每1%差速产生的位置变化率（单位/秒），0表示不使用指令输入
+     */
+    void setInputGain(float gain) { input_gain_ = gain; }
+
+    /**
+     * @brief 设置跳变门限
+     * @param gate 残差门限（位置单位）
+     * @param max_rejects 连续拒绝多少帧后重新锚定
+     */
+    void setGate(float gate, uint8_t max_rejects);
+
+    float getPosition() const { return position_; }      ///< 滤波后位置
+    float getVelocity() const { return velocity_; }      ///< 估计的漂移速度（单位/秒）
+    float getRate() const { return rate_; }              ///< 总位置变化率 v + k·u（单位/秒）
+    bool isInitialized() const { return initialized_; }
+    uint32_t getRejectCount() const { return total_rejects_; }
+
+private:
+    float position_;      // 位置估计
+    float velocity_;      // 漂移速度估计
+    float rate_;          // 最近一次预测使用的总变化率
+    float dt_;            // 最近一次预测的时间间隔
+
+    float alpha_;
+    float beta_;
+    float input_gain_;
+    float gate_;
+    uint8_t max_rejects_;
+
+    uint8_t reject_streak_;    // 连续拒绝帧数
+    uint32_t total_rejects_;   // 累计拒绝帧数（调试用）
+    bool initialized_;
+};
+
+#endif // LINE_POSITION_TRACKER_HPP
@@ -0,0 +1,128 @@
+/**
+ * @file    motion_arbiter.hpp
+ * @brief   运动指令仲裁器（多指令源按优先级与租期选择唯一执行者）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 巡线、蓝牙摇杆、E49按键、避障、脚本、失效保护都通过 submit*() 提交运动指令，
+ * 每条指令带租期（lease），到期未续约自动失效。每个控制周期 update() 选出
+ * 优先级最高的有效指令源，只通过 DriveTrain 这一条路径写电机：
+ *
+ *     FAILSAFE > OBSTACLE > SCRIPT > BT_JOYSTICK > E49_KEYS > LINE_FOLLOWER
+ *
+ * 指令有三种：
+ * - TARGET：直行/转向目标，经 MotionProfile S曲线平滑（遥控）
+ * - WHEELS：左右轮速度直接输出（巡线等闭环控制）
+ * - STOP：立即停车并保持
+ *
+ * WHEELS 输出时 DriveTrain 会把速度剖面同步到当前轮速，切回 TARGET 时从当前速度
+ * 平滑过渡，不会突跳（无扰切换）。没有任何有效指令时按剖面减速到0。
+ *
+ * 使用示例：
+ * @code
+ * MotionArbiter arbiter(drive_train);
+ * follower.setOutputSink(&arbiter);
+ * remote.attachArbiter(&arbiter);
+ *
+ * while (1) {
+ *     follower.update();   // 提交 LINE_FOLLOWER 指令
+ *     arbiter.update();    // 选出胜者并输出
+ * }
+ * @endcode
+ */
+
+#ifndef MOTION_ARBITER_HPP
+#define MOTION_ARBITER_HPP
+
+#include <stdint.h>
+
+#include "drive_train.hpp"
+
+/**
+ * @brief 指令源（数值越小优先级越高）
+ */
+enum class MotionSource : uint8_t {
+    FAILSAFE = 0,   ///< 失效保护（校准、故障）
+    OBSTACLE,       ///< 避障急停
+    SCRIPT,         ///< 脚本动作
+    BT_JOYSTICK,    ///< 蓝牙摇杆
+    E49_KEYS,       ///< E49/按键遥控
+    LINE_FOLLOWER,  ///< 巡线
+    COUNT
+};
+
+class MotionArbiter {
+public:
+    /// 永不过期的租期
+    static constexpr uint32_t LEASE_FOREVER = 0xFFFFFFFFu;
+
+    explicit MotionArbiter(DriveTrain& drive);
+
+    /**
+     * @brief 提交直行/转向目标（经S曲线平滑）
+     * @param source 指令源
+     * @param straight_q8 直行目标（1/256 %）
+     * @param turn_q8 转向目标（1/256 %）
+     * @param lease_ms 租期（毫秒）
+     */
+    void submitTarget(MotionSource source, int32_t straight_q8, int32_t turn_q8, uint32_t lease_ms);
+
+    /**
+     * @brief 提交左右轮速度（直接输出，前进为正）
+     */
+    void submitWheels(MotionSource source, int32_t left_q8, int32_t right_q8, uint32_t lease_ms);
+
+    /**
+     * @brief 提交立即停车
+     */
+    void submitStop(MotionSource source, uint32_t lease_ms);
+
+    /**
+     * @brief 撤销指令源（较低优先级的指令源立即接管）
+     */
+    void release(MotionSource source);
+
+    /**
+     * @brief 仲裁并输出（每个控制周期调用一次）
+     */
+    void update();
+
+    /**
+     * @brief 当前执行的指令源（无有效指令时为 COUNT）
+     */
+    MotionSource getActiveSource() const { return active_; }
+
+    /**
+     * @brief 指令源是否持有未过期的租期
+     */
+    bool isActive(MotionSource source) const;
+
+    /**
+     * @brief 执行者切换次数
+     */
+    uint32_t getSwitchCount() const { return switch_count_; }
+
+    static const char* sourceName(MotionSource source);
+
+private:
+    enum class Mode : uint8_t { NONE, TARGET, WHEELS, STOP };
+
+    struct Slot {
+        Mode mode;
+        int32_t a_q8;       // TARGET：直行；WHEELS：左轮
+        int32_t b_q8;       // TARGET：转向；WHEELS：右轮
+        uint32_t start_ms;
+        uint32_t lease_ms;
+    };
+
+    void store(MotionSource source, Mode mode, int32_t a_q8, int32_t b_q8, uint32_t lease_ms);
+    static bool expired(const Slot& slot, uint32_t now);
+
+    DriveTrain& drive_;
+    Slot slots_[static_cast<uint8_t>(MotionSource::COUNT)];
+    MotionSource active_;
+    uint32_t switch_count_;
+};
+
+#endif  // MOTION_ARBITER_HPP
@@ -1,103 +1,207 @@
 /**
  * @file    motion_profile.hpp
- * @brief   梯形速度轮廓（直线加减速与反向刹车）
+ * @brief   S曲线速度轮廓（加加速度限制，按实际时间积分）
+ *
+ * 速度以Q8定点表示（1/256 %），加速度单位 %/s，加加速度单位 %/s²。
+ * 每次 update() 按两次调用之间的实际毫秒数积分，斜坡时长与调用频率无关。
+ *
+ * 算法：
+ * - 期望加速度 a* = sign(e)·min(a_max, sqrt(2·j·|e|))，e为距目标的速度差，
+ *   sqrt项保证在加加速度限制下刚好以0加速度到达目标（S曲线收尾）
+ * - 实际加速度以不超过 j·dt 的步长逼近 a*（S曲线起步，减少起步打滑）
+ * - 远离0加速用 acceleration，向0减速用 deceleration，跨越0的反向刹车用 reverseDeceleration
  */
 
 #ifndef MOTION_PROFILE_HPP
 #define MOTION_PROFILE_HPP
 
 #include "stm32f1xx_hal.h"
+#include "fixed_math.hpp"
 #include <algorithm>
+#include <cstdlib>
 
 class MotionProfile {
 public:
+    static constexpr int32_t Q = 256;              ///< 1% 对应的定点值
+    static constexpr uint32_t MAX_DT_MS = 50;      ///< 单次积分最大时间（防止长时间未调用后跳变）
+    static constexpr uint32_t LEGACY_STEP_MS = 20; ///< setParams() 旧接口“每步”对应的时间
+
     MotionProfile()
         : target_(0)
         , current_(0)
-        , acceleration_(5)
-        , deceleration_(8)
-        , reverseDeceleration_(12)
+        , accel_(0)
+        , velRemainder_(0)
+        , accelRemainder_(0)
+        , accelLimit_(400)
+        , decelLimit_(600)
+        , reverseDecelLimit_(800)
+        , jerkLimit_(4000)
         , lastUpdateMs_(0)
-        , updateIntervalMs_(20) {}
+        , updateIntervalMs_(0)
+        , started_(false) {}
 
     void setTarget(int target)
     {
-        if (target > 100) target = 100;
-        if (target < -100) target = -100;
-        target_ = target;
+        setTargetQ8(static_cast<int32_t>(target) * Q);
+    }
+
+    /**
+     * @brief 设置目标速度（Q8，±100% = ±25600）
+     */
+    void setTargetQ8(int32_t target)
+    {
+        target_ = fixed_math::clamp(target, -100 * Q, 100 * Q);
     }
 
-    int getTarget() const { return target_; }
-    int getCurrent() const { return current_; }
+    int getTarget() const { return roundQ8(target_); }
+    int getCurrent() const { return roundQ8(current_); }
+    int32_t getTargetQ8() const { return target_; }
+    int32_t getCurrentQ8() const { return current_; }
+
+    /**
+     * @brief 当前加速度（%/s）
+     */
+    int getAcceleration() const { return accel_ / Q; }
 
+    /**
+     * @brief 兼容旧接口：每 LEGACY_STEP_MS 的速度步长
+     * @note 换算为 %/s：step * 1000 / LEGACY_STEP_MS（默认5/8/12 → 250/400/600 %/s）
+     */
     void setParams(int acceleration, int deceleration, int reverseDeceleration)
     {
-        acceleration_ = std::max(1, acceleration);
-        deceleration_ = std::max(1, deceleration);
-        reverseDeceleration_ = std::max(1, reverseDeceleration);
+        const int scale = 1000 / static_cast<int>(LEGACY_STEP_MS);
+        accelLimit_ = std::max(1, acceleration) * scale;
+        decelLimit_ = std::max(1, deceleration) * scale;
+        reverseDecelLimit_ = std::max(1, reverseDeceleration) * scale;
+    }
+
+    /**
+     * @brief 设置加速度与加加速度限制
+     * @param acceleration 加速度（%/s，远离0）
+     * @param deceleration 减速度（%/s，趋向0）
+     * @param reverseDeceleration 反向刹车减速度（%/s）
+     * @param jerk 加加速度（%/s²），越小起步越柔和
+     */
+    void setLimits(int acceleration, int deceleration, int reverseDeceleration, int jerk)
+    {
+        accelLimit_ = std::max(1, acceleration);
+        decelLimit_ = std::max(1, deceleration);
+        reverseDecelLimit_ = std::max(1, reverseDeceleration);
+        jerkLimit_ = std::max(1, jerk);
     }
 
+    /**
+     * @brief 设置最小更新间隔（毫秒，0表示每次调用都积分）
+     */
     void setUpdateInterval(uint32_t intervalMs)
     {
-        if (intervalMs < 10u) intervalMs = 10u;
         updateIntervalMs_ = intervalMs;
     }
 
+    /**
+     * @brief 无扰切换：把当前速度和目标都设为给定值（加速度清零）
+     * @param value 当前实际速度（Q8）
+     */
+    void sync(int32_t value)
+    {
+        target_ = fixed_math::clamp(value, -100 * Q, 100 * Q);
+        current_ = target_;
+        accel_ = 0;
+        velRemainder_ = 0;
+        accelRemainder_ = 0;
+    }
+
     void reset()
     {
         target_ = 0;
         current_ = 0;
+        accel_ = 0;
+        velRemainder_ = 0;
+        accelRemainder_ = 0;
     }
 
-    // 按时间片更新当前速度，返回更新后的 current
+    // 按实际经过时间积分当前速度，返回更新后的 current（整数百分比）
     int update(uint32_t nowMs)
     {
-        if (nowMs - lastUpdateMs_ < updateIntervalMs_) {
-            return current_;
+        if (!started_) {
+            started_ = true;
+            lastUpdateMs_ = nowMs;
+            return getCurrent();
+        }
+
+        uint32_t dtMs = nowMs - lastUpdateMs_;
+        if (dtMs == 0 || dtMs < updateIntervalMs_) {
+            return getCurrent();
         }
         lastUpdateMs_ = nowMs;
+        if (dtMs > MAX_DT_MS) dtMs = MAX_DT_MS;
 
-        if (current_ == target_) {
-            return current_;
+        if (current_ == target_ && accel_ == 0) {
+            return getCurrent();
         }
 
+        const int32_t error = target_ - current_;
+        const int32_t dir = (error > 0) ? 1 : (error < 0 ? -1 : 0);
+
+        // 当前阶段的加速度上限（Q8 %/s）
         const bool reversing = (current_ > 0 && target_ < 0) || (current_ < 0 && target_ > 0);
+        int32_t limit;
         if (reversing) {
-            if (current_ > 0) {
-                current_ = std::max(0, current_ - reverseDeceleration_);
-            } else {
-                current_ = std::min(0, current_ + reverseDeceleration_);
-            }
-            return current_;
+            limit = reverseDecelLimit_;
+        } else if (std::abs(target_) > std::abs(current_)) {
+            limit = accelLimit_;
+        } else {
+            limit = decelLimit_;
         }
+        limit *= Q;
 
-        if (abs(current_) < abs(target_)) {
-            // 加速阶段
-            if (target_ > current_) {
-                current_ = std::min(target_, current_ + acceleration_);
-            } else {
-                current_ = std::max(target_, current_ - acceleration_);
-            }
-        } else {
-            // 减速阶段
-            if (target_ > current_) {
-                current_ = std::min(target_, current_ + deceleration_);
-            } else {
-                current_ = std::max(target_, current_ - deceleration_);
-            }
+        // 期望加速度：保证在加加速度限制下平滑收尾
+        const int64_t jerkQ = static_cast<int64_t>(jerkLimit_) * Q;
+        uint32_t brake = fixed_math::isqrt64(2ull * static_cast<uint64_t>(jerkQ) *
+                                             static_cast<uint64_t>(std::abs(error)));
+        int32_t desired = dir * static_cast<int32_t>(std::min<int64_t>(limit, brake));
+
+        // 加速度按加加速度限制逼近期望值
+        int64_t jerkStep = jerkQ * dtMs + accelRemainder_;
+        int32_t maxDelta = static_cast<int32_t>(jerkStep / 1000);
+        accelRemainder_ = static_cast<int32_t>(jerkStep % 1000);
+        accel_ += fixed_math::clamp(desired - accel_, -maxDelta, maxDelta);
+
+        // 速度积分（保留余数，低加速度时也不丢失精度）
+        int64_t velStep = static_cast<int64_t>(accel_) * dtMs + velRemainder_;
+        int32_t dv = static_cast<int32_t>(velStep / 1000);
+        velRemainder_ = static_cast<int32_t>(velStep % 1000);
+        current_ += dv;
+
+        // 越过目标时直接到位
+        const int32_t after = target_ - current_;
+        if (dir == 0 || (after > 0) != (error > 0) || after == 0) {
+            current_ = target_;
+            accel_ = 0;
+            velRemainder_ = 0;
+            accelRemainder_ = 0;
         }
-        return current_;
+        return getCurrent();
     }
 
 private:
-    int target_;
-    int current_;
-    int acceleration_;
-    int deceleration_;
-    int reverseDeceleration_;
+    static int roundQ8(int32_t value)
+    {
+        return (value >= 0) ? (value + Q / 2) / Q : -((-value + Q / 2) / Q);
+    }
+
+    int32_t target_;           // 目标速度（Q8）
+    int32_t current_;          // 当前速度（Q8）
+    int32_t accel_;            // 当前加速度（Q8 %/s）
+    int32_t velRemainder_;     // 速度积分余数
+    int32_t accelRemainder_;   // 加速度积分余数
+    int accelLimit_;           // %/s
+    int decelLimit_;           // %/s
+    int reverseDecelLimit_;    // %/s
+    int jerkLimit_;            // %/s²
     uint32_t lastUpdateMs_;
     uint32_t updateIntervalMs_;
+    bool started_;
 };
 
 #endif // MOTION_PROFILE_HPP
-
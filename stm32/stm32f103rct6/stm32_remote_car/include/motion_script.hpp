@@ -0,0 +1,216 @@
+/**
+ * @file    motion_script.hpp
+ * @brief   运动脚本解释器（紧凑字节码，非阻塞执行）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 把“前进1秒 → 原地转到看见线 → 巡线到标记 → 重复3次”这类固定动作写成字节码，
+ * 由 update() 在每个控制周期推进一步，不使用 HAL_Delay，主循环在脚本运行期间
+ * 照常读传感器、处理串口。脚本以 SCRIPT 指令源提交给 MotionArbiter，
+ * 优先级高于遥控与巡线、低于失效保护与避障。
+ *
+ * 字节码格式（多字节参数小端，速度单位 %，转向正值左转）：
+ *
+ *   | 操作码 | 助记符            | 参数                           | 长度 |
+ *   |--------|-------------------|--------------------------------|------|
+ *   | 0x00   | END               | -                              | 1    |
+ *   | 0x01   | DRIVE_TIME        | straight:i8 turn:i8 ms:u16     | 5    |
+ *   | 0x02   | DRIVE_DIST        | straight:i8 turn:i8 mm:u16     | 5    |
+ *   | 0x03   | ARC               | speed:i8 radius_cm:i8 deg:u16  | 5    |
+ *   | 0x04   | SPOT_UNTIL_LINE   | turn:i8 timeout_ms:u16         | 4    |
+ *   | 0x05   | FOLLOW_TO_MARKER  | timeout_ms:u16                 | 3    |
+ *   | 0x06   | WAIT              | ms:u16                         | 3    |
+ *   | 0x07   | REPEAT            | count:u8（0=无限）             | 2    |
+ *   | 0x08   | NEXT              | -                              | 1    |
+ *   | 0x09   | SPOT_ANGLE        | turn:i8 deg:u16                | 4    |
+ *
+ * - DRIVE_TIME/DRIVE_DIST 经 S曲线平滑；距离取 PoseEstimator 的累计路程（与航向无关）
+ * - ARC 按 PoseEstimator 航向转过 deg 度，radius_cm 正值向左、负值向右
+ * - SPOT_UNTIL_LINE 先离开当前线再转到下一条线，timeout_ms=0 表示不限时
+ * - FOLLOW_TO_MARKER 暂时让出控制权给低优先级指令源（通常是巡线），
+ *   直到检测到标记（横线）
+ * - SPOT_ANGLE 按原地转向模型（SpotTurnCalibration）算出转动时间，
+ *   未标定或 turn 低于最小有效转速时失败
+ * - REPEAT/NEXT 最多嵌套 MAX_LOOP_DEPTH 层
+ * - 超时视为失败，脚本进入 ERROR 并让出控制权
+ *
+ * 使用示例：
+ * @code
+ * static const uint8_t square[] = {
+ *     0x07, 4,                   // REPEAT 4
+ *     0x02, 40, 0, 0xF4, 0x01,   //   DRIVE_DIST 40% 500mm
+ *     0x03, 30, 10, 90, 0,       //   ARC 30% r=10cm 90°
+ *     0x08,                      // NEXT
+ *     0x00,                      // END
+ * };
+ * MotionScript script(arbiter, pose);
+ * script.load(square, sizeof(square));
+ * script.start();
+ *
+ * while (1) {
+ *     follower.update();
+ *     script.update(inputs);   // 每个控制周期调用
+ *     arbiter.update();
+ * }
+ * @endcode
+ *
+ * 汇编器见 tools/motion_script_asm.py，串口上传格式见 BluetoothControl。
+ */
+
+#ifndef MOTION_SCRIPT_HPP
+#define MOTION_SCRIPT_HPP
+
+#include <stdint.h>
+
+#include "eeprom.hpp"
+#include "motion_arbiter.hpp"
+#include "pose_estimator.hpp"
+#include "spot_turn_calibration.hpp"
+
+/**
+ * @brief EEPROM中的脚本（64字节含CRC，占满 0xC0~0xFF）
+ */
+struct __attribute__((packed)) MotionScriptData {
+    uint16_t magic_number;  ///< 魔术数字
+    uint8_t length;         ///< 字节码长度
+    uint8_t code[60];       ///< 字节码
+    // CRC会自动添加在writeStructCRC时
+};
+
+class MotionScript {
+public:
+    static constexpr uint8_t EEPROM_ADDR = 0xC0;      ///< 脚本存储地址
+    static constexpr uint16_t MAGIC = 0x4D53;         ///< 魔术数字 "MS"
+    static constexpr uint8_t MAX_LENGTH = sizeof(MotionScriptData::code);
+    static constexpr uint8_t MAX_LOOP_DEPTH = 4;      ///< REPEAT 最大嵌套层数
+    static constexpr uint32_t LEASE_MS = 100;         ///< 指令租期（主循环停止调用后自动失效）
+
+    /// 操作码
+    enum class Op : uint8_t {
+        END = 0x00,
+        DRIVE_TIME = 0x01,
+        DRIVE_DIST = 0x02,
+        ARC = 0x03,
+        SPOT_UNTIL_LINE = 0x04,
+        FOLLOW_TO_MARKER = 0x05,
+        WAIT = 0x06,
+        REPEAT = 0x07,
+        NEXT = 0x08,
+        SPOT_ANGLE = 0x09,
+    };
+
+    enum class State : uint8_t {
+        IDLE,     ///< 未运行
+        RUNNING,  ///< 运行中
+        DONE,     ///< 正常结束
+        ERROR     ///< 超时或字节码错误
+    };
+
+    /**
+     * @brief 每个控制周期的传感器输入
+     */
+    struct Inputs {
+        bool line_seen;  ///< 至少一路传感器在线上
+        bool marker;     ///< 检测到标记（横线，多数传感器同时在线上）
+    };
+
+    MotionScript(MotionArbiter& arbiter, const PoseEstimator& pose);
+
+    /**
+     * @brief 装入脚本（从Flash常量或上传缓冲），会先校验
+     * @return false 字节码非法或过长（原脚本保持不变）
+     */
+    bool load(const uint8_t* code, uint8_t length);
+
+    /**
+     * @brief 追加字节码（分段上传），不校验，start() 时再校验
+     * @return false 超出 MAX_LENGTH
+     */
+    bool append(const uint8_t* code, uint8_t length);
+
+    /**
+     * @brief 清空脚本（运行中会先中止）
+     */
+    void clear();
+
+    /**
+     * @brief 从头开始执行
+     * @return false 脚本为空或非法
+     */
+    bool start();
+
+    /**
+     * @brief 中止执行并让出控制权
+     */
+    void abort();
+
+    /**
+     * @brief 推进脚本（每个控制周期调用，立即返回）
+     */
+    void update(const Inputs& inputs);
+
+    /**
+     * @brief 设置原地转向模型（SPOT_ANGLE 使用）
+     */
+    void setSpotTurnModel(const SpotTurnCalibrationData& model) { spot_model_ = model; }
+
+    bool saveToEEPROM(EEPROM& eeprom) const;
+    bool loadFromEEPROM(EEPROM& eeprom);
+
+    State getState() const { return state_; }
+    bool isRunning() const { return state_ == State::RUNNING; }
+    uint8_t getPc() const { return pc_; }
+    uint8_t getLength() const { return length_; }
+
+    /**
+     * @brief 指令长度（含操作码）
+     * @return 0 表示未知操作码
+     */
+    static uint8_t instructionLength(uint8_t op);
+
+    /**
+     * @brief 校验字节码：操作码合法、参数完整、REPEAT/NEXT 配对且不超过嵌套上限
+     */
+    static bool validate(const uint8_t* code, uint8_t length);
+
+private:
+    struct Loop {
+        uint8_t body_pc;    // 循环体第一条指令
+        uint8_t remaining;  // 剩余次数（0=无限）
+    };
+
+    /// 当前指令是否完成
+    enum class Step : uint8_t { BUSY, NEXT, JUMP, FAIL };  // JUMP：指令已自行设置 pc_
+
+    MotionArbiter& arbiter_;
+    const PoseEstimator& pose_;
+
+    uint8_t code_[MAX_LENGTH];
+    uint8_t length_;
+
+    State state_;
+    uint8_t pc_;
+    bool entered_;           // 当前指令已完成初始化
+    uint32_t step_start_ms_;
+    int32_t step_start_mm_;
+    int32_t turned_;         // ARC 已转过的角度（二进制角度，65536=360°）
+    uint16_t last_heading_;
+    bool left_line_;         // SPOT_UNTIL_LINE 已离开起始线 / FOLLOW_TO_MARKER 已离开起始标记
+
+    SpotTurnCalibrationData spot_model_;
+
+    Loop loops_[MAX_LOOP_DEPTH];
+    uint8_t loop_depth_;
+
+    Step execute(const Inputs& inputs, uint32_t now);
+    void finish(State state);
+
+    int8_t argI8(uint8_t offset) const { return static_cast<int8_t>(code_[pc_ + offset]); }
+    uint8_t argU8(uint8_t offset) const { return code_[pc_ + offset]; }
+    uint16_t argU16(uint8_t offset) const {
+        return static_cast<uint16_t>(code_[pc_ + offset] | (code_[pc_ + offset + 1] << 8));
+    }
+};
+
+#endif  // MOTION_SCRIPT_HPP
@@ -6,6 +6,7 @@
  * 
  * Motor control class for controlling DC motors via PWM signals
  * Speed range: -100 (full reverse) to 100 (full forward)
+ * Fine path: signed Q8 speed (1/256 %, -25600 to 25600)
  */
 
 #ifndef MOTOR_HPP
@@ -13,6 +14,23 @@
 
 #include <cstdint>
 #include "stm32f1xx_hal.h"
+#include "fixed_math.hpp"
+
+/**
+ * @brief Per-motor calibrated pulse curve (piecewise-linear LUT)
+ *
+ * Each direction holds the pulse offset (us, relative to the 1500us neutral)
+ * at commanded speed 0+, 25, 50, 75 and 100. Point 0 is the edge of the servo
+ * dead band, so the smallest non-zero command already moves the wheel.
+ * Intermediate speeds are interpolated linearly between the points.
+ */
+struct __attribute__((packed)) MotorCurve {
+    static constexpr uint8_t POINTS = 5;    ///< Points per direction
+    static constexpr int STEP = 25;         ///< Speed step between points
+
+    uint8_t forward[POINTS];                ///< Forward pulse offsets (us)
+    uint8_t reverse[POINTS];                ///< Reverse pulse offsets (us)
+};
 
 class Motor {
 public:
@@ -33,6 +51,12 @@ public:
      */
     void setSpeed(int speed);
 
+    /**
+     * @brief Set motor speed with sub-percent resolution
+     * @param speed_q8 Speed in 1/256 % (-25600 to 25600)
+     */
+    void setSpeedQ8(int32_t speed_q8);
+
     /**
      * @brief Stop the motor (neutral position)
      */
@@ -48,11 +72,109 @@ public:
      */
     void maxSpeed();
 
+    /**
+     * @brief Compute and stage the pulse for a speed without touching the timer
+     * @param speed Speed value from -100 to 100
+     * @return Staged compare value in timer ticks
+     * @note Use Motor::commit() to write the staged pulses of several motors
+     *       in one register burst, so they latch at the same PWM update event
+     */
+    uint16_t stageSpeed(int speed);
+
+    /**
+     * @brief Stage a Q8 speed (1/256 %) without touching the timer
+     * @return Staged compare value in timer ticks
+     */
+    uint16_t stageSpeedQ8(int32_t speed_q8);
+
+    /**
+     * @brief Stage the neutral pulse (stop) without touching the timer
+     */
+    void stageStop();
+
+    /**
+     * @brief Compare value (timer ticks) staged by the last stageSpeed()/setSpeed() call
+     */
+    uint16_t stagedPulse() const { return pulse_; }
+
+    /**
+     * @brief Write staged pulses of a group of motors together
+     * @param motors Motors to commit
+     * @param count Number of motors
+     *
+     * Motors on the same timer are written with one CCR1..CCR4 burst
+     * (TIM_PWM_CommitPulses), which only latches at the next update event.
+     */
+    static void commit(Motor* const motors[], uint8_t count);
+
+    /**
+     * @brief Write staged pulses of four motors together
+     */
+    static void commit(Motor& m1, Motor& m2, Motor& m3, Motor& m4) {
+        Motor* const motors[] = {&m1, &m2, &m3, &m4};
+        commit(motors, 4);
+    }
+
+    /**
+     * @brief Output a raw pulse width, bypassing the speed curve
+     * @param pulse_us Pulse width in microseconds (clamped to the frame)
+     * @note Intended for curve measurement only
+     */
+    void setPulseWidth(uint16_t pulse_us);
+
+    /**
+     * @brief Install a calibrated speed curve
+     * @param curve Curve measured for this motor
+     */
+    void setCurve(const MotorCurve& curve);
+
+    /**
+     * @brief Remove the calibrated curve (back to 1500 + speed*5/2)
+     */
+    void clearCurve();
+
+    /**
+     * @brief Check whether a calibrated curve is installed
+     */
+    bool hasCurve() const { return has_curve_; }
+
+    /**
+     * @brief Zero-based index of the TIM channel (CH1 -> 0 ... CH4 -> 3)
+     */
+    uint8_t channelIndex() const { return static_cast<uint8_t>(channel_ / 4); }
+
 private:
+    /**
+     * @brief Map a speed command to a pulse width
+     * @param speed_q8 Speed in 1/256 % (-25600 to 25600)
+     * @return Pulse width in 1/256 us
+     */
+    int32_t pulseForSpeedQ8(int32_t speed_q8) const;
+
+    /**
+     * @brief Read tick rate and frame length from the timer
+     */
+    void configureTiming();
+
+    /**
+     * @brief Clamp a pulse width to the frame and convert it to timer ticks
+     */
+    uint16_t toTicks(uint16_t pulse_us) const;
+
+    /**
+     * @brief Clamp a Q8 pulse width (1/256 us) and round it to timer ticks
+     */
+    uint16_t toTicksQ8(int32_t pulse_q8) const;
+
     TIM_HandleTypeDef* htim_;
     uint32_t channel_;
     bool initialized_ = false;
-    int speed_ = 0;
+    int32_t speed_q8_ = 0;
+    uint16_t pulse_ = 0;
+    uint8_t ticks_per_us_ = 1;
+    uint16_t max_pulse_us_ = 2500;
+    bool has_curve_ = false;
+    MotorCurve curve_ = {};
 };
 
 #endif // MOTOR_HPP
@@ -0,0 +1,89 @@
+/**
+ * @file    motor_calibration.hpp
+ * @brief   舵机电机速度曲线校准（死区与非线性补偿）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * 连续旋转舵机在1500us附近有较宽的死区，且正反转速度曲线非线性、不对称。
+ * 本模块为每个电机保存一条分段线性曲线（正转/反转各5点），
+ * Motor::setSpeed() 按曲线插值出脉宽，使指令速度与车轮转速近似成正比。
+ *
+ * @usage   MotorCalibrationData calib;
+ *          if (MotorCalibration::load(eeprom, calib)) {
+ *              MotorCalibration::apply(calib, motor_lf);
+ *              ...
+ *          }
+ *
+ * 测量流程见 examples/motor_curve_calibration.cpp
+ */
+
+#ifndef __MOTOR_CALIBRATION_HPP
+#define __MOTOR_CALIBRATION_HPP
+
+#include <stdint.h>
+#include "eeprom.hpp"
+#include "motor.hpp"
+
+/**
+ * @brief 电机曲线校准数据结构体
+ *
+ * 曲线按TIM通道索引（CH1..CH4），与电机在车上的逻辑位置无关
+ * 总共占用 4 + 4*10 + 1 = 45字节（含CRC）
+ */
+struct __attribute__((packed)) MotorCalibrationData {
+    uint32_t magic_number;  ///< 魔术数字（用于验证数据有效性）
+    MotorCurve curves[4];   ///< 各通道的速度曲线
+    // CRC会自动添加在writeStructCRC时
+};
+
+/**
+ * @class MotorCalibration
+ * @brief 电机曲线的存储、应用与拟合
+ */
+class MotorCalibration {
+public:
+    static constexpr uint8_t EEPROM_ADDR = 0x80;         ///< 校准数据存储地址
+    static constexpr uint32_t MAGIC = 0x4D435256;        ///< 魔术数字 "MCRV"
+    static constexpr uint8_t MAX_OFFSET_US = 250;        ///< 最大脉宽偏移（对应原1750/1250us）
+
+    /**
+     * @brief 从EEPROM加载校准数据
+     * @return true 数据有效
+     * @return false CRC或魔术数字错误（data内容不可用）
+     */
+    static bool load(EEPROM& eeprom, MotorCalibrationData& data);
+
+    /**
+     * @brief 保存校准数据到EEPROM（带CRC）
+     */
+    static bool save(EEPROM& eeprom, const MotorCalibrationData& data);
+
+    /**
+     * @brief 把对应通道的曲线安装到电机
+     * @note DriveTrain按值保存电机，需在构造DriveTrain之前调用
+     */
+    static void apply(const MotorCalibrationData& data, Motor& motor);
+
+    /**
+     * @brief 生成与未校准时等效的线性曲线（1500 ± speed*5/2）
+     */
+    static void makeLinear(MotorCurve& curve);
+
+    /**
+     * @brief 由实测数据拟合单方向曲线
+     * @param offsets_us 测试脉宽偏移（升序），offsets_us[0]为死区边缘
+     * @param rpm        对应实测转速，rpm[0]应为0
+     * @param count      样本数（>=2）
+     * @param full_scale_rpm 指令100对应的目标转速（取所有电机最大转速的最小值）
+     * @param out        输出的5个曲线点
+     * @return true 拟合成功
+     * @return false 样本不足或转速达不到full_scale_rpm
+     *
+     * 第k点（k=1..4）取实测曲线上转速等于 full_scale_rpm*k/4 处的脉宽（线性反插值），
+     * 因此四个电机在相同指令下转速一致。
+     */
+    static bool fitDirection(const uint16_t* offsets_us, const float* rpm, uint8_t count,
+                             float full_scale_rpm, uint8_t out[MotorCurve::POINTS]);
+};
+
+#endif  // __MOTOR_CALIBRATION_HPP
@@ -75,6 +75,18 @@ public:
      */
     float compute(float setpoint, float input, float dt);
 
+    /**
+     * @brief 计算PID输出（由外部提供测量值变化率）
+     * @param setpoint 目标值
+     * @param input 当前测量值（通常为状态估计器的滤波值）
+     * @param input_rate 测量值变化率（单位/秒，来自状态估计器）
+     * @param dt 时间间隔（秒）
+     * @return PID控制输出
+     *
+     * @note D项直接使用input_rate，不再做差分和微分滤波
+     */
+    float compute(float setpoint, float input, float input_rate, float dt);
+
     /**
      * @brief 设置PID参数
      * @param kp 比例系数
@@ -228,6 +240,12 @@ private:
      * @return 限幅后的值
      */
     float constrain(float value, float min, float max);
+
+    /**
+     * @brief PID计算主体
+     * @param input_rate 外部变化率，nullptr表示由测量值差分得到
+     */
+    float computeImpl(float setpoint, float input, float dt, const float* input_rate);
 };
 
 #endif // PID_CONTROLLER_HPP
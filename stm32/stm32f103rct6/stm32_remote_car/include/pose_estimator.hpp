@@ -0,0 +1,121 @@
+/**
+ * @file    pose_estimator.hpp
+ * @brief   航位推算位姿估计（无编码器，基于指令轮速 + 电机模型）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 小车没有编码器，用左右轮速度指令经电机响应模型估计实际轮速，再积分得到位姿：
+ *
+ *     指令(%) → 死区 → ×满量程线速度 → 一阶滞后(τ) → 轮速 v_l, v_r
+ *     v = (v_l + v_r)/2,  ω = (v_r - v_l)/轮距
+ *     x += v·cosθ·dt,  y += v·sinθ·dt,  θ += ω·dt
+ *
+ * 同时维护相对于赛道线的坐标：沿线距离 s、横向偏差 d（车在线左侧为正）、
+ * 相对线的航向 ψ（左转为正）。线位置传感器在车轴前方 L 处测量 d + L·sinψ，
+ * 每次观测用残差按 α/β 增益修正 d 和 ψ，使横向估计不随时间漂移。
+ * 沿线距离只在巡线修正 ψ 时可靠；按路程计量的动作（DRIVE_DIST）用累计路程 |位移| 之和。
+ *
+ * 全部为定点运算：速度/距离为Q8毫米，角度为32位二进制角度（2^32 = 360°），
+ * 三角函数查 fixed_math::sinQ15 表，每个控制周期约几百个周期。
+ *
+ * 使用示例：
+ * @code
+ * pose.predict(left_q8, right_q8, dt_ms);   // 指令为Q8百分比，前进为正
+ * if (line_valid) pose.observeLine(position);
+ * int32_t s = pose.getDistance();           // 沿线距离（mm）
+ * int32_t p = pose.getPathLength();         // 累计路程（mm，转弯后照常增加）
+ * @endcode
+ */
+
+#ifndef POSE_ESTIMATOR_HPP
+#define POSE_ESTIMATOR_HPP
+
+#include <stdint.h>
+
+class PoseEstimator {
+public:
+    /**
+     * @brief 电机模型与几何参数
+     */
+    struct Params {
+        uint16_t full_scale_mm_s;       ///< 指令100%对应的车轮线速度（mm/s）
+        uint16_t tau_ms;                ///< 电机一阶滞后时间常数（ms）
+        uint8_t deadband_pct;           ///< 指令死区（%），低于此值车轮不转
+        uint16_t track_mm;              ///< 轮距（左右轮接地中心距离，mm）
+        uint16_t sensor_lead_mm;        ///< 传感器阵列到车轴的前伸距离（mm）
+        uint16_t sensor_half_width_mm;  ///< 线位置 ±1000 对应的横向距离（mm）
+        uint8_t lateral_gain_q8;        ///< 横向修正增益 α（/256）
+        uint8_t heading_gain_q8;        ///< 航向修正增益 β（/256）
+    };
+
+    /**
+     * @brief 默认参数（需按实车标定满量程速度和时间常数）
+     */
+    static Params defaultParams();
+
+    PoseEstimator();
+
+    /**
+     * @brief 设置模型参数
+     */
+    void setParams(const Params& params);
+
+    const Params& getParams() const { return params_; }
+
+    /**
+     * @brief 位姿、轮速全部清零
+     */
+    void reset();
+
+    /**
+     * @brief 沿线距离清零（例如每圈起点）
+     */
+    void resetDistance() { distance_q8_ = 0; }
+
+    /**
+     * @brief 时间更新：按指令轮速积分
+     * @param left_q8 左轮速度指令（1/256 %，前进为正）
+     * @param right_q8 右轮速度指令（1/256 %，前进为正）
+     * @param dt_ms 距上次调用的时间（ms）
+     */
+    void predict(int32_t left_q8, int32_t right_q8, uint32_t dt_ms);
+
+    /**
+     * @brief 量测更新：用线位置修正横向偏差和相对航向
+     * @param position 线位置（-1000..1000，与巡线控制器符号一致）
+     */
+    void observeLine(int32_t position);
+
+    int32_t getX() const { return x_q8_ / 256; }                  ///< mm
+    int32_t getY() const { return y_q8_ / 256; }                  ///< mm
+    uint16_t getHeading() const { return heading_ >> 16; }        ///< 二进制角度（65536 = 360°）
+    int16_t getHeadingDeg() const { return angleToDeg(heading_); }
+    int32_t getDistance() const { return distance_q8_ / 256; }    ///< 沿线距离（mm）
+    int32_t getPathLength() const { return path_q8_ / 256; }      ///< 累计路程（mm，不分方向，只增不减）
+    int32_t getCrossTrack() const { return cross_q8_ / 256; }     ///< 横向偏差（mm，车在线左侧为正）
+    int16_t getLineHeadingDeg() const { return angleToDeg(line_heading_); }
+    int32_t getSpeed() const { return (v_left_q8_ + v_right_q8_) / 512; }  ///< mm/s
+    int32_t getLeftWheelSpeed() const { return v_left_q8_ / 256; }         ///< mm/s
+    int32_t getRightWheelSpeed() const { return v_right_q8_ / 256; }       ///< mm/s
+
+private:
+    int32_t wheelTarget(int32_t command_q8) const;
+    int32_t applyLag(int32_t speed_q8, int32_t target_q8, uint32_t dt_ms) const;
+    static int16_t angleToDeg(uint32_t angle);
+
+    Params params_;
+
+    int32_t v_left_q8_;       // 模型轮速（Q8 mm/s）
+    int32_t v_right_q8_;
+    int32_t x_q8_;            // 位置（Q8 mm）
+    int32_t y_q8_;
+    uint32_t heading_;        // 航向（2^32 = 360°）
+    int32_t distance_q8_;     // 沿线距离（Q8 mm）
+    int32_t path_q8_;         // 累计路程（Q8 mm）
+    int32_t cross_q8_;        // 横向偏差（Q8 mm）
+    uint32_t line_heading_;   // 相对线的航向 ψ（2^32 = 360°）
+    int32_t step_remainder_;  // 位移积分余数
+};
+
+#endif  // POSE_ESTIMATOR_HPP
@@ -11,6 +11,7 @@
 #include "stm32f1xx_hal.h"
 #include "drive_train.hpp"
 #include "e49_wireless.hpp"
+#include "motion_arbiter.hpp"
 
 /**
  * @class RemoteControl
@@ -42,7 +43,7 @@ public:
     
     /**
      * @brief 更新函数（在主循环中调用）
-     * 检查超时并自动停止
+     * 处理E49接收队列，检查超时并自动停止
      */
     void update();
     
@@ -106,6 +107,15 @@ public:
      */
     void handleJoystickSpeeds(int straightSpeed, int turnSpeed);
 
+    /**
+     * @brief 接入运动仲裁器
+     * @param arbiter 仲裁器指针，nullptr 表示直接设置 DriveTrain 目标
+     *
+     * 接入后按键指令以 E49_KEYS、摇杆以 BT_JOYSTICK 提交，租期等于超时时间；
+     * 停止时撤销租期，巡线等低优先级指令源无扰接管。
+     */
+    void attachArbiter(MotionArbiter* arbiter) { arbiter_ = arbiter; }
+
 private:
     DriveTrain& driveTrain_;        // 差速转向系统引用
     E49_Wireless& wireless_;        // 无线模块引用
@@ -123,6 +133,13 @@ private:
     // 当前目标速度（累积）
     int currentTargetStraightSpeed_;  // 当前目标直行速度
     int currentTargetTurnSpeed_;      // 当前目标转向速度
+
+    MotionArbiter* arbiter_ = nullptr;  // 运动仲裁器（可选）
+
+    /**
+     * @brief 输出目标速度（经仲裁器或直接给 DriveTrain）
+     */
+    void applyTarget(int straightSpeed, int turnSpeed, MotionSource source);
     
     /**
      * @brief 检查并处理超时
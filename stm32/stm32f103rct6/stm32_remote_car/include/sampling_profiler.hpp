@@ -0,0 +1,77 @@
+/**
+ * @file    sampling_profiler.hpp
+ * @brief   统计采样分析器（PC直方图）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * TIM7以固定频率中断，中断入口取出被打断代码的栈帧，把栈帧中的PC计入地址桶。
+ * 适合分析控制周期之外、不便插入计时器的代码（u8g2绘图、HAL I2C、vsnprintf等）。
+ *
+ * 输出格式（调试串口）：
+ * @code
+ * PROFILE BEGIN base=0x08000000 shift=7 hz=2000 samples=12345 other=12
+ * 0x08001A80 321
+ * ...
+ * PROFILE END
+ * @endcode
+ *
+ * 主机端：python tools/profile_symbolize.py capture.log .pio/build/dev/firmware.elf
+ *
+ * @note TIM7与USART1、SysTick同为最高抢占优先级，这些中断执行期间的采样会延后到中断返回，
+ *       因此中断内部的耗时会被少计。
+ */
+
+#ifndef SAMPLING_PROFILER_HPP
+#define SAMPLING_PROFILER_HPP
+
+#include <stdint.h>
+#include "debug_config.h"
+
+#if PROFILER_SAMPLING_ENABLE
+
+namespace SamplingProfiler {
+
+/**
+ * @brief 配置TIM7并开始采样
+ * @param sample_hz 采样频率（Hz）
+ */
+void init(uint32_t sample_hz = PROFILER_SAMPLE_HZ);
+
+/**
+ * @brief 暂停/恢复采样
+ */
+void stop();
+void start();
+
+/**
+ * @brief 清空统计
+ */
+void reset();
+
+/**
+ * @brief 通过调试串口输出非零地址桶（输出期间暂停采样）
+ */
+void dump();
+
+}  // namespace SamplingProfiler
+
+extern "C" {
+/**
+ * @brief 采样入口（由TIM7_IRQHandler调用）
+ * @param frame 被打断代码的异常栈帧（r0,r1,r2,r3,r12,lr,pc,xpsr）
+ */
+void SamplingProfiler_OnTick(uint32_t* frame);
+}
+
+#define PROFILER_INIT()     SamplingProfiler::init()
+#define PROFILER_DUMP()     SamplingProfiler::dump()
+
+#else
+
+#define PROFILER_INIT()     ((void)0)
+#define PROFILER_DUMP()     ((void)0)
+
+#endif  // PROFILER_SAMPLING_ENABLE
+
+#endif  // SAMPLING_PROFILER_HPP
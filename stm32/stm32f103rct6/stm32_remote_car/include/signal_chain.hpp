@@ -0,0 +1,250 @@
+/**
+ * @file    signal_chain.hpp
+ * @brief   编译期组合的信号处理链（巡线PID后处理）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 每个处理环节是一个带 process(x, ctx) 成员的小类，用模板 Chain<...> 串联成一个类型。
+ * 整条链在编译期确定，编译器可以完全内联并常量折叠，没有虚函数和堆分配。
+ * 环节的输入输出类型可以不同（例如 DifferentialMix 把 float 转成 WheelPair），
+ * 链的返回类型由最后一个环节自动推导。
+ *
+ * 常量参数用千分比整数作为模板参数（C++14不支持浮点模板参数），便于常量折叠。
+ *
+ * 使用示例：
+ * @code
+ * using namespace signal_chain;
+ * using PostChain = Chain<Clamp, Normalize, DynamicMaxAdjust, SlewLimit<8000, 2000>,
+ *                         DifferentialMix, SpeedClamp>;
+ * PostChain chain;
+ *
+ * Context ctx = {dt, base, max_output, error_ratio, max_adj, min_speed, max_speed};
+ * WheelPair wheels = chain.process(pid_output, ctx);
+ * @endcode
+ */
+
+#ifndef SIGNAL_CHAIN_HPP
+#define SIGNAL_CHAIN_HPP
+
+#include <stddef.h>
+#include <math.h>
+
+namespace signal_chain {
+
+/**
+ * @brief 每帧的运行时参数（所有环节共享）
+ */
+struct Context {
+    float dt;                    ///< 控制周期（秒）
+    float base_speed;            ///< 基础速度
+    float max_output;            ///< PID输出上限
+    float error_ratio;           ///< 位置偏差比例 |position|/1000，[0,1]
+    float max_adjustment_ratio;  ///< 小偏差时的最大调整幅度
+    float min_speed;             ///< 车轮最小速度
+    float max_speed;             ///< 车轮最大速度
+};
+
+/**
+ * @brief 左右轮速度
+ */
+struct WheelPair {
+    float left;
+    float right;
+};
+
+/* ========== 无状态环节 ========== */
+
+/**
+ * @brief 对称限幅到 ±max_output
+ */
+struct Clamp {
+    float process(float x, const Context& ctx) const {
+        if (x > ctx.max_output) return ctx.max_output;
+        if (x < -ctx.max_output) return -ctx.max_output;
+        return x;
+    }
+    void reset() {}
+};
+
+/**
+ * @brief 归一化到 [-1, 1]
+ */
+struct Normalize {
+    float process(float x, const Context& ctx) const {
+        return (ctx.max_output > 0.0f) ? x / ctx.max_output : 0.0f;
+    }
+    void reset() {}
+};
+
+/**
+ * @brief 死区 + 跳变：|x|<Low 输出0，Low~High 之间输出 ±High
+ * @tparam LowPermille 低阈值（千分比）
+ * @tparam HighPermille 高阈值（千分比）
+ */
+template <int LowPermille, int HighPermille>
+struct Deadband {
+    float process(float x, const Context&) const {
+        const float low = LowPermille / 1000.0f;
+        const float high = HighPermille / 1000.0f;
+        float mag = fabsf(x);
+        if (mag < low) return 0.0f;
+        if (mag < high) return (x >= 0.0f) ? high : -high;
+        return x;
+    }
+    void reset() {}
+};
+
+/**
+ * @brief 动态调整幅度：偏差越大允许的差速越大（线性过渡到100%）
+ */
+struct DynamicMaxAdjust {
+    float process(float x, const Context& ctx) const {
+        float max_adj = ctx.max_adjustment_ratio + (1.0f - ctx.max_adjustment_ratio) * ctx.error_ratio;
+        return x * max_adj;
+    }
+    void reset() {}
+};
+
+/**
+ * @brief 差速混合：left = base*(1-x)，right = base*(1+x)
+ */
+struct DifferentialMix {
+    WheelPair process(float x, const Context& ctx) const {
+        return WheelPair{ctx.base_speed * (1.0f - x), ctx.base_speed * (1.0f + x)};
+    }
+    void reset() {}
+};
+
+/**
+ * @brief 左右轮统一限制在 [min_speed, max_speed]
+ */
+struct SpeedClamp {
+    WheelPair process(WheelPair w, const Context& ctx) const {
+        return WheelPair{clamp(w.left, ctx), clamp(w.right, ctx)};
+    }
+    void reset() {}
+
+private:
+    static float clamp(float v, const Context& ctx) {
+        if (v < ctx.min_speed) return ctx.min_speed;
+        if (v > ctx.max_speed) return ctx.max_speed;
+        return v;
+    }
+};
+
+/* ========== 有状态环节 ========== */
+
+/**
+ * @brief 非对称限斜率：同向变化快，反向变化慢
+ * @tparam SamePermillePerSec 同向最大变化率（千分比/秒）
+ * @tparam FlipPermillePerSec 反向最大变化率（千分比/秒）
+ */
+template <int SamePermillePerSec, int FlipPermillePerSec>
+class SlewLimit {
+public:
+    float process(float x, const Context& ctx) {
+        const float max_same = SamePermillePerSec / 1000.0f * ctx.dt;
+        const float max_flip = FlipPermillePerSec / 1000.0f * ctx.dt;
+        float delta = x - last_;
+        bool same_direction = (delta > 0.0f && last_ >= 0.0f) || (delta < 0.0f && last_ <= 0.0f);
+        float limit = same_direction ? max_same : max_flip;
+        if (delta > limit) delta = limit;
+        if (delta < -limit) delta = -limit;
+        last_ += delta;
+        return last_;
+    }
+    void reset() { last_ = 0.0f; }
+
+private:
+    float last_ = 0.0f;
+};
+
+/**
+ * @brief 一阶低通：y = w*x + (1-w)*y_last
+ * @tparam NewWeightPermille 新值权重（千分比）
+ */
+template <int NewWeightPermille>
+class LowPass {
+public:
+    float process(float x, const Context&) {
+        const float w = NewWeightPermille / 1000.0f;
+        last_ = w * x + (1.0f - w) * last_;
+        return last_;
+    }
+    void reset() { last_ = 0.0f; }
+
+private:
+    float last_ = 0.0f;
+};
+
+/* ========== 链组合 ========== */
+
+template <typename... Stages>
+class Chain;
+
+/**
+ * @brief 空链：原样返回
+ */
+template <>
+class Chain<> {
+public:
+    template <typename T>
+    T process(T x, const Context&) { return x; }
+    void reset() {}
+};
+
+/**
+ * @brief 链：先执行 Head，再把结果交给剩余环节
+ */
+template <typename Head, typename... Tail>
+class Chain<Head, Tail...> {
+public:
+    template <typename T>
+    auto process(T x, const Context& ctx) {
+        return tail_.process(head_.process(x, ctx), ctx);
+    }
+
+    /**
+     * @brief 重置所有有状态环节
+     */
+    void reset() {
+        head_.reset();
+        tail_.reset();
+    }
+
+    Head& head() { return head_; }
+    Chain<Tail...>& tail() { return tail_; }
+
+private:
+    Head head_;
+    Chain<Tail...> tail_;
+};
+
+/**
+ * @brief 按索引访问环节（用于运行时调整有状态环节）
+ *
+ * @code
+ * auto& slew = signal_chain::stage<3>(chain);
+ * @endcode
+ */
+template <size_t I>
+struct StageAt {
+    template <typename Head, typename... Tail>
+    static auto& get(Chain<Head, Tail...>& chain) { return StageAt<I - 1>::get(chain.tail()); }
+};
+
+template <>
+struct StageAt<0> {
+    template <typename Head, typename... Tail>
+    static Head& get(Chain<Head, Tail...>& chain) { return chain.head(); }
+};
+
+template <size_t I, typename... Stages>
+auto& stage(Chain<Stages...>& chain) {
+    return StageAt<I>::get(chain);
+}
+
+}  // namespace signal_chain
+
+#endif // SIGNAL_CHAIN_HPP
@@ -0,0 +1,88 @@
+/**
+ * @file    skid_steer.hpp
+ * @brief   四轮滑移转向混合（前后轮独立速度，减少转弯侧滑阻力）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 差速混合只给出左右两侧的速度，同侧前后轮速度相同。四轮滑移转向车转弯时，
+ * 车轮接地点相对瞬时转动中心（ICR）的速度除了纵向分量 v_x 还有横向分量：
+ *
+ *     v_x = ω·(R − y_w)            （与同侧速度相同）
+ *     v_y = ω·(x_w − x_icr)        （只能靠轮胎侧滑提供）
+ *
+ * 轮子离 ICR 越远，实际接地速度越大。同侧前后轮给相同速度时，
+ * 离 ICR 远的轮子被拖着侧滑，近的轮子被推着空转，转弯阻力大、掉速明显。
+ *
+ * 本模块保持同侧前后轮的平均速度为 v_x（左右比例、转弯半径不变），
+ * 按前后轮接地速度 sqrt(v_x² + v_y²) 的比例在前后之间拉开：
+ *
+ *     前 = v_x·(1 + e)，后 = v_x·(1 − e)，e = (|v_前| − |v_后|) / (|v_前| + |v_后|) × blend
+ *
+ * 差值与 v_x 成正比，v_x 过零时连续。
+ * x_icr 为 ICR 相对轴距中心的纵向偏移（向前为正），重心靠后时 ICR 也靠后，
+ * 此时前轮离 ICR 更远、给得更快。直行（ω=0）时输出与原来完全相同。
+ *
+ * icr_offset_mm 为 0（默认）时前后轮到 ICR 距离相同，输出与同侧相同一致；
+ * 要让前后轮独立，需按重心位置设置非零的 icr_offset_mm。
+ *
+ * 使用示例：
+ * @code
+ * skid_steer::Geometry geo = skid_steer::defaultGeometry();
+ * geo.icr_offset_mm = -15;   // 电池在后，ICR 略靠后
+ * geo.blend_pct = 100;
+ * drive_train.setSkidSteerGeometry(geo);
+ * @endcode
+ */
+
+#ifndef SKID_STEER_HPP
+#define SKID_STEER_HPP
+
+#include <stdint.h>
+
+namespace skid_steer {
+
+/**
+ * @brief 底盘几何参数
+ */
+struct Geometry {
+    uint16_t wheelbase_mm;   ///< 前后轴距
+    uint16_t track_mm;       ///< 左右轮距
+    int16_t icr_offset_mm;   ///< ICR 相对轴距中心的纵向偏移（向前为正）
+    uint8_t blend_pct;       ///< 0 = 同侧前后相同（关闭），100 = 完全按到ICR距离
+};
+
+/**
+ * @brief 默认几何（关闭，与两轮差速混合等效）
+ */
+inline Geometry defaultGeometry() {
+    Geometry geo;
+    geo.wheelbase_mm = 150;
+    geo.track_mm = 130;
+    geo.icr_offset_mm = 0;
+    geo.blend_pct = 0;
+    return geo;
+}
+
+/**
+ * @brief 四个车轮的速度（Q8，前进为正）
+ */
+struct WheelSpeeds {
+    int32_t left_front;
+    int32_t left_rear;
+    int32_t right_front;
+    int32_t right_rear;
+};
+
+/**
+ * @brief 由左右两侧速度计算四轮速度
+ * @param geo 底盘几何
+ * @param left_q8 左侧速度（1/256 %，前进为正）
+ * @param right_q8 右侧速度（1/256 %，前进为正）
+ * @return 四轮速度，同侧前后平均等于该侧速度；超过 ±100% 时四轮等比缩小
+ */
+WheelSpeeds mix(const Geometry& geo, int32_t left_q8, int32_t right_q8);
+
+}  // namespace skid_steer
+
+#endif  // SKID_STEER_HPP
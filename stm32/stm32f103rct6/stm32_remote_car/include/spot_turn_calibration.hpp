@@ -0,0 +1,100 @@
+/**
+ * @file    spot_turn_calibration.hpp
+ * @brief   原地转向牵引力校准（最小有效转速 + 角速度增益）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * 原地转向时四轮侧滑，实际角速度与轮速指令不成正比：低于某个指令时车根本转不动，
+ * 高于它之后角速度近似线性增加，且两者都随地面变化。模型：
+ *
+ *     ω(deg/s) = gain × (|cmd| − min_speed)，|cmd| > min_speed
+ *
+ * 测量方法：车身中心压在一条直线上原地旋转，传感器阵列在车轴前方画圆，
+ * 每转半圈中间传感器越过一次线，相邻两次越线间隔即转过180°的时间。
+ * 对若干指令测出角速度后最小二乘拟合 gain 和 min_speed，保存到EEPROM。
+ *
+ * @usage   SpotTurnCalibrationData spot;
+ *          if (SpotTurnCalibration::load(eeprom, spot)) {
+ *              SpotTurnCalibration::apply(spot, drive_train);
+ *              script.setSpotTurnModel(spot);
+ *          }
+ *
+ * 测量流程见 examples/spot_turn_calibration.cpp
+ */
+
+#ifndef __SPOT_TURN_CALIBRATION_HPP
+#define __SPOT_TURN_CALIBRATION_HPP
+
+#include <stdint.h>
+#include "drive_train.hpp"
+#include "eeprom.hpp"
+
+/**
+ * @brief 原地转向校准数据（4 + 2 + 2 + 1 = 9字节含CRC）
+ */
+struct __attribute__((packed)) SpotTurnCalibrationData {
+    uint32_t magic_number;  ///< 魔术数字（用于验证数据有效性）
+    int16_t min_speed_q8;   ///< 最小有效转向轮速（1/256 %）
+    uint16_t gain_q8;       ///< 角速度增益（1/256 deg/s 每 1%）
+    // CRC会自动添加在writeStructCRC时
+};
+
+/**
+ * @class SpotTurnCalibration
+ * @brief 原地转向模型的存储、拟合与换算
+ */
+class SpotTurnCalibration {
+public:
+    static constexpr uint8_t EEPROM_ADDR = 0xB0;    ///< 校准数据存储地址
+    static constexpr uint32_t MAGIC = 0x5350544E;   ///< 魔术数字 "SPTN"
+
+    static bool load(EEPROM& eeprom, SpotTurnCalibrationData& data);
+    static bool save(EEPROM& eeprom, const SpotTurnCalibrationData& data);
+
+    /**
+     * @brief 把最小有效转速装入 DriveTrain（原地转向的轮速下限）
+     */
+    static void apply(const SpotTurnCalibrationData& data, DriveTrain& drive);
+
+    /**
+     * @brief 最小二乘拟合 ω = gain × (cmd − min_speed)
+     * @param commands 转向轮速指令（%）
+     * @param rates    实测角速度（deg/s），0 表示没转动（不参与拟合）
+     * @param count    样本数
+     * @param out      拟合结果（含魔术数字）
+     * @return false 有效样本少于2个，或拟合出的增益/死区不合理
+     */
+    static bool fit(const uint8_t commands[], const uint16_t rates[], uint8_t count,
+                    SpotTurnCalibrationData& out);
+
+    /**
+     * @brief 由两次越线间隔换算角速度（每次越线180°）
+     * @param crossings 越线次数（>=2）
+     * @param elapsed_ms 第一次到最后一次越线的时间
+     * @return 角速度（deg/s）
+     */
+    static uint16_t crossingRate(uint8_t crossings, uint32_t elapsed_ms);
+
+    /**
+     * @brief 模型预测的角速度
+     * @param command_q8 转向轮速（1/256 %，取绝对值）
+     * @return deg/s，低于最小有效转速返回0
+     */
+    static uint32_t rateFor(const SpotTurnCalibrationData& data, int32_t command_q8);
+
+    /**
+     * @brief 以 command_q8 原地转过 angle_deg 所需时间
+     * @return 毫秒，转不动返回0
+     */
+    static uint32_t durationFor(const SpotTurnCalibrationData& data, int32_t command_q8,
+                                uint16_t angle_deg);
+
+    /**
+     * @brief 校准数据是否可用
+     */
+    static bool isValid(const SpotTurnCalibrationData& data) {
+        return data.magic_number == MAGIC && data.gain_q8 > 0;
+    }
+};
+
+#endif  // __SPOT_TURN_CALIBRATION_HPP
@@ -0,0 +1,261 @@
+/**
+ * @file    spsc_ring.hpp
+ * @brief   单生产者/单消费者无锁环形缓冲（中断 → 主循环的字节/帧队列）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 一端只在中断里写、另一端只在主循环里读（或反过来）时，不需要关中断：
+ * - 写入位置 head_ 只由生产者修改，读取位置 tail_ 只由消费者修改
+ * - 两个位置都是自由递增的 uint32_t，取模用掩码（N 必须是2的幂），
+ *   head_ - tail_ 就是已用元素数，N 个位置全部可用
+ * - 生产者先写数据、__DMB()、再发布 head_；消费者读到 head_ 后 __DMB()、再读数据，
+ *   读完 __DMB()、再发布 tail_，保证另一端看到的位置和数据一致
+ * - 缓冲满时丢弃新数据并累加溢出计数，生产者从不改动 tail_
+ *
+ * 连续区间接口（writeSpan()/commit()、readSpan()/consume()）给 DMA 和批量解析用，
+ * 每次最多返回到缓冲末尾的一段，回绕部分需要再取一次。
+ *
+ * 使用示例：
+ *   static SpscRing<uint8_t, 256> rx;
+ *
+ *   // 中断里
+ *   rx.pushBulk(dma_buf, len);
+ *
+ *   // 主循环里
+ *   uint32_t n;
+ *   while (const uint8_t* p = rx.readSpan(n)) {
+ *       parse(p, n);
+ *       rx.consume(n);
+ *   }
+ */
+
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include "stm32f1xx.h"
+
+template <typename T, uint32_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing 容量必须是2的幂");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing 按字节拷贝元素，T 必须可平凡拷贝");
+
+public:
+    SpscRing() : head_(0), tail_(0), overflow_(0) {}
+
+    static constexpr uint32_t capacity() { return N; }
+
+    // ========== 生产者 ==========
+
+    /**
+     * @brief 写入一个元素
+     * @return false=缓冲满，已丢弃并计入溢出
+     */
+    bool push(const T& value)
+    {
+        const uint32_t head = head_;
+        if (head - loadTail() >= N) {
+            overflow_ = overflow_ + 1;
+            return false;
+        }
+        buf_[head & MASK] = value;
+        __DMB();
+        head_ = head + 1;
+        return true;
+    }
+
+    /**
+     * @brief 尽量多地写入一段数据，放不下的部分丢弃并计入溢出
+     * @return 实际写入的元素数
+     */
+    uint32_t pushBulk(const T* data, uint32_t count)
+    {
+        const uint32_t head = head_;
+        const uint32_t room = N - (head - loadTail());
+        if (count > room) {
+            overflow_ = overflow_ + (count - room);
+            count = room;
+        }
+        copyIn(head, data, count);
+        __DMB();
+        head_ = head + count;
+        return count;
+    }
+
+    /**
+     * @brief 整段写入，放不下时整段丢弃并计入溢出（用于不能截断的文本行/帧）
+     */
+    bool pushAll(const T* data, uint32_t count)
+    {
+        const uint32_t head = head_;
+        if (count > N - (head - loadTail())) {
+            overflow_ = overflow_ + count;
+            return false;
+        }
+        copyIn(head, data, count);
+        __DMB();
+        head_ = head + count;
+        return true;
+    }
+
+    /**
+     * @brief 取得可直接写入的连续空闲区间（给DMA或就地编码用）
+     * @param count 输出：区间长度，缓冲满时为0
+     * @return 区间起始地址，缓冲满时为 nullptr
+     */
+    T* writeSpan(uint32_t& count)
+    {
+        const uint32_t head = head_;
+        const uint32_t room = N - (head - loadTail());
+        const uint32_t index = head & MASK;
+        count = (room < N - index) ? room : N - index;
+        return count != 0 ? &buf_[index] : nullptr;
+    }
+
+    /**
+     * @brief 发布 writeSpan() 区间里已写好的前 count 个元素
+     */
+    void commit(uint32_t count)
+    {
+        __DMB();
+        head_ = head_ + count;
+    }
+
+    // ========== 消费者 ==========
+
+    /**
+     * @brief 读出一个元素
+     * @return false=缓冲空
+     */
+    bool pop(T& value)
+    {
+        const uint32_t tail = tail_;
+        if (loadHead() == tail) {
+            return false;
+        }
+        value = buf_[tail & MASK];
+        __DMB();
+        tail_ = tail + 1;
+        return true;
+    }
+
+    /**
+     * @brief 读出最多 count 个元素
+     * @return 实际读出的元素数
+     */
+    uint32_t popBulk(T* out, uint32_t count)
+    {
+        const uint32_t tail = tail_;
+        const uint32_t used = loadHead() - tail;
+        if (count > used) {
+            count = used;
+        }
+        const uint32_t index = tail & MASK;
+        const uint32_t first = (count < N - index) ? count : N - index;
+        memcpy(out, &buf_[index], first * sizeof(T));
+        memcpy(out + first, &buf_[0], (count - first) * sizeof(T));
+        __DMB();
+        tail_ = tail + count;
+        return count;
+    }
+
+    /**
+     * @brief 取得可直接读取的连续区间（给DMA发送或批量解析用）
+     * @param count 输出：区间长度，缓冲空时为0
+     * @return 区间起始地址，缓冲空时为 nullptr
+     * @note 区间在 consume() 之前保持有效，生产者不会覆盖
+     */
+    const T* readSpan(uint32_t& count) const
+    {
+        const uint32_t tail = tail_;
+        const uint32_t used = loadHead() - tail;
+        const uint32_t index = tail & MASK;
+        count = (used < N - index) ? used : N - index;
+        return count != 0 ? &buf_[index] : nullptr;
+    }
+
+    /**
+     * @brief 释放 readSpan() 区间的前 count 个元素
+     */
+    void consume(uint32_t count)
+    {
+        __DMB();
+        tail_ = tail_ + count;
+    }
+
+    // ========== 状态 ==========
+
+    uint32_t size() const { return head_ - tail_; }
+    uint32_t space() const { return N - size(); }
+    bool empty() const { return head_ == tail_; }
+
+    /**
+     * @brief 因缓冲满被丢弃的元素数（累计）
+     */
+    uint32_t overflowCount() const { return overflow_; }
+
+    /**
+     * @brief 复制最近写入的元素（含已被消费的部分），不改变缓冲状态
+     * @return 实际复制的元素数
+     * @note 只读，可在故障处理中调用
+     */
+    uint32_t copyRecent(T* out, uint32_t max) const
+    {
+        const uint32_t head = head_;
+        uint32_t count = head < N ? head : N;
+        if (count > max) {
+            count = max;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            out[i] = buf_[(head - count + i) & MASK];
+        }
+        return count;
+    }
+
+    /**
+     * @brief 清空缓冲和溢出计数
+     * @note 只能在生产者和消费者都停止时调用（初始化阶段）
+     */
+    void clear()
+    {
+        head_ = 0;
+        tail_ = 0;
+        overflow_ = 0;
+    }
+
+private:
+    static constexpr uint32_t MASK = N - 1;
+
+    uint32_t loadHead() const
+    {
+        const uint32_t head = head_;
+        __DMB();
+        return head;
+    }
+
+    uint32_t loadTail() const
+    {
+        const uint32_t tail = tail_;
+        __DMB();
+        return tail;
+    }
+
+    void copyIn(uint32_t head, const T* data, uint32_t count)
+    {
+        const uint32_t index = head & MASK;
+        const uint32_t first = (count < N - index) ? count : N - index;
+        memcpy(&buf_[index], data, first * sizeof(T));
+        memcpy(&buf_[0], data + first, (count - first) * sizeof(T));
+    }
+
+    T buf_[N];
+    volatile uint32_t head_;      // 写入位置（只由生产者修改）
+    volatile uint32_t tail_;      // 读取位置（只由消费者修改）
+    volatile uint32_t overflow_;  // 丢弃的元素数（只由生产者修改）
+};
+
+#endif  // SPSC_RING_HPP
@@ -0,0 +1,125 @@
+/**
+ * @file    supply_monitor.hpp
+ * @brief   电源电压监测与轮速补偿（内部 Vrefint + 可选电池分压）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * 舵机转速近似与供电电压成正比，电池从满电放到低电时同样的指令转得越来越慢，
+ * 相当于所有 PID 增益和速度参数都在一圈圈地变小。
+ *
+ * 本模块用 ADC1 注入组低频采样（默认50ms一次，约40us）：
+ *
+ *     VDDA    = 1200mV × 4095 / raw_vrefint
+ *     V_pin   = raw_bat × 1200mV / raw_vrefint       （与 VDDA 无关）
+ *     V_bat   = V_pin × (R_top + R_bottom) / R_bottom
+ *
+ * 一阶低通（α = 1/16，约0.8s）后得到供电电压 V，再按
+ *
+ *     gain = V_nominal / V，限制在 [MIN_GAIN, MAX_GAIN]
+ *
+ * 放大轮速指令，使同一指令在整个放电过程中得到相同的实际转速。
+ * 放大后超出 ±100% 时左右轮等比缩小，保持转弯半径。
+ *
+ * 启用电池分压（adc.h 中 ADC_BATTERY_ENABLE=1）时补偿按电池电压；
+ * 否则按 VDDA，只有舵机与 MCU 同一路供电（无稳压）时才有补偿效果。
+ * V_nominal 默认取上电后第一次测量值（即“本次上电时的速度”保持不变），
+ * 也可以用 setNominalMillivolts() 固定为调参时的电压。
+ *
+ * 使用示例：
+ * @code
+ * SupplyMonitor supply;
+ * supply.init();
+ * drive_train.setSupplyMonitor(&supply);
+ *
+ * while (1) {
+ *     supply.update();                       // 内部按 SAMPLE_INTERVAL_MS 限频
+ *     uint16_t mv = supply.getSupplyMillivolts();
+ * }
+ * @endcode
+ */
+
+#ifndef SUPPLY_MONITOR_HPP
+#define SUPPLY_MONITOR_HPP
+
+#include <stdint.h>
+
+class SupplyMonitor {
+public:
+    static constexpr uint16_t VREFINT_MV = 1200;         ///< 内部基准典型值（1.16~1.24V）
+    static constexpr uint32_t SAMPLE_INTERVAL_MS = 50;   ///< 采样间隔
+    static constexpr uint8_t FILTER_SHIFT = 4;           ///< 低通系数 α = 1/16
+    static constexpr int32_t MIN_GAIN_Q8 = 205;          ///< 最小补偿增益 0.8（电压高于标称时）
+    static constexpr int32_t MAX_GAIN_Q8 = 384;          ///< 最大补偿增益 1.5（电池快没电时不再加）
+
+    SupplyMonitor();
+
+    /**
+     * @brief 立即采样一次并用它初始化滤波器（标称电压未设置时同时作为标称值）
+     * @return false ADC注入组转换超时
+     */
+    bool init();
+
+    /**
+     * @brief 周期更新（主循环调用，距上次采样不足 SAMPLE_INTERVAL_MS 时立即返回）
+     */
+    void update();
+
+    /**
+     * @brief 设置电池分压电阻（仅 ADC_BATTERY_ENABLE=1 时使用，默认 20k/10k）
+     */
+    void setBatteryDivider(uint16_t top_kohm, uint16_t bottom_kohm);
+
+    /**
+     * @brief 设置标称电压（在该电压下增益为1.0，0 表示取上电后的第一次测量值）
+     */
+    void setNominalMillivolts(uint16_t mv);
+
+    /**
+     * @brief 开关补偿（关闭时增益固定为1.0，电压照常测量）
+     */
+    void setCompensationEnabled(bool enable);
+
+    /**
+     * @brief 按当前增益补偿左右轮速度，超出 ±100% 时等比缩小
+     * @param left_q8 左轮速度（1/256 %，会被修改）
+     * @param right_q8 右轮速度（1/256 %，会被修改）
+     */
+    void compensate(int32_t& left_q8, int32_t& right_q8) const;
+
+    bool isValid() const { return valid_; }
+    uint16_t getVddaMillivolts() const { return static_cast<uint16_t>(vdda_acc_ >> FILTER_SHIFT); }
+    uint16_t getBatteryMillivolts() const { return static_cast<uint16_t>(battery_acc_ >> FILTER_SHIFT); }
+
+    /**
+     * @brief 用于补偿的供电电压（有电池分压时为电池电压，否则为 VDDA）
+     */
+    uint16_t getSupplyMillivolts() const;
+
+    uint16_t getNominalMillivolts() const { return nominal_mv_; }
+    int32_t getGainQ8() const { return gain_q8_; }
+
+private:
+    bool valid_;
+    bool compensation_enabled_;
+    uint32_t last_sample_ms_;
+
+    // 滤波累加器（mV << FILTER_SHIFT）
+    uint32_t vdda_acc_;
+    uint32_t battery_acc_;
+
+    uint16_t divider_top_kohm_;
+    uint16_t divider_bottom_kohm_;
+    uint16_t nominal_mv_;
+    int32_t gain_q8_;
+
+    /**
+     * @brief 读一次注入组并换算为毫伏
+     * @return false 转换超时或读数异常
+     */
+    bool sample(uint16_t& vdda_mv, uint16_t& battery_mv) const;
+
+    void updateGain();
+};
+
+#endif  // SUPPLY_MONITOR_HPP
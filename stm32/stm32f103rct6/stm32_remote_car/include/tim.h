@@ -5,9 +5,13 @@
  * @date    2024
  * 
  * TIM3 configuration for 4-channel PWM output (motor control)
- * - Prescaler: 71 (72MHz / 72 = 1MHz timer clock)
- * - Period: 20000 (1MHz / 20000 = 50Hz PWM frequency, 20ms period)
+ * - Frame rate: SERVO_PWM_FRAME_HZ (default 50Hz, 20ms period)
+ * - Prescaler/Period are derived from the frame rate: the finest tick that
+ *   still fits one frame into the 16-bit ARR (50Hz -> 3 ticks/us,
+ *   200Hz -> 12 ticks/us, 333Hz -> 18 ticks/us)
  * - Channels: PC6 (CH1), PC7 (CH2), PC8 (CH3), PC9 (CH4)
+ * - ARR and CCR preload enabled: compare values latch at the update event,
+ *   use TIM_PWM_CommitPulses() to change all four channels in the same frame
  */
 
 #ifndef __TIM_H__
@@ -20,6 +24,30 @@ extern "C" {
 #include "stm32f1xx_hal.h"
 #include "common.h"
 
+/* Exported constants --------------------------------------------------------*/
+
+/**
+ * @brief Servo PWM frame rate (Hz)
+ *
+ * A new wheel command waits up to one frame before the servo sees it.
+ * Many continuous-rotation servos accept 100-333Hz; check the servo before
+ * raising it. Override with -DSERVO_PWM_FRAME_HZ=200 in build_flags.
+ */
+#ifndef SERVO_PWM_FRAME_HZ
+#define SERVO_PWM_FRAME_HZ 50U
+#endif
+
+/**
+ * @brief Command-to-pulse latency statistics (microseconds)
+ */
+typedef struct {
+  uint32_t count;     /**< Number of commits */
+  uint32_t last_us;   /**< Delay of the last commit */
+  uint32_t avg_us;    /**< Average delay */
+  uint32_t max_us;    /**< Worst delay */
+  uint32_t frame_us;  /**< PWM frame period */
+} TIM_PWM_Latency;
+
 /* Exported variables --------------------------------------------------------*/
 extern TIM_HandleTypeDef htim3;
 
@@ -27,7 +55,7 @@ extern TIM_HandleTypeDef htim3;
 
 /**
  * @brief Initialize TIM3 for 4-channel PWM output
- * @note Configures TIM3 with 50Hz PWM frequency for motor control
+ * @note Configures TIM3 with SERVO_PWM_FRAME_HZ PWM frequency for motor control
  */
 void MX_TIM3_Init(void);
 
@@ -37,6 +65,35 @@ void MX_TIM3_Init(void);
  */
 void HAL_TIM_MspPostInit(TIM_HandleTypeDef *htim);
 
+/**
+ * @brief Write CCR1..CCR4 together, latching at the same update event
+ * @param htim Pointer to TIM handle
+ * @param pulses Compare values for CH1..CH4 (timer ticks)
+ */
+void TIM_PWM_CommitPulses(TIM_HandleTypeDef *htim, const uint16_t pulses[4]);
+
+/**
+ * @brief Timer ticks per microsecond of a PWM timer
+ */
+uint32_t TIM_PWM_TicksPerUs(const TIM_HandleTypeDef *htim);
+
+/**
+ * @brief PWM frame period in microseconds
+ */
+uint32_t TIM_PWM_FrameUs(const TIM_HandleTypeDef *htim);
+
+/**
+ * @brief Read command-to-pulse latency statistics
+ * @note Measured in TIM_PWM_CommitPulses() as the time left until the next
+ *       update event, i.e. until the committed pulse starts on the pin
+ */
+void TIM_PWM_GetLatency(const TIM_HandleTypeDef *htim, TIM_PWM_Latency *out);
+
+/**
+ * @brief Clear latency statistics
+ */
+void TIM_PWM_ResetLatency(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,6 +18,13 @@ extern "C" {
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart2;
 
+/* TX DMA句柄（USART1=DMA1_Channel4，USART2=DMA1_Channel7） */
+extern DMA_HandleTypeDef hdma_usart1_tx;
+extern DMA_HandleTypeDef hdma_usart2_tx;
+
+/* RX DMA句柄（USART2=DMA1_Channel6，循环模式） */
+extern DMA_HandleTypeDef hdma_usart2_rx;
+
 /**
  * @brief 错误处理函数（由main.cpp提供）
  */
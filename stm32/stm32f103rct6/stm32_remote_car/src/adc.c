@@ -1,6 +1,6 @@
 /**
  * @file    adc.c
- * @brief   ADC 配置实现 - 8路灰度传感器采样
+ * @brief   ADC 配置实现 - 8路灰度传感器采样 + 电源电压监测
  * @author  AI Assistant
  * @date    2024
  */
@@ -74,6 +74,27 @@ void MX_ADC1_Init(void)
     sConfig.Channel = ADC_CHANNEL_15;
     sConfig.Rank = ADC_REGULAR_RANK_8;
     HAL_ADC_ConfigChannel(&hadc1, &sConfig);
+    
+    /* ========== 注入组：电源监测 ========== */
+    ADC_InjectionConfTypeDef sConfigInjected = {0};
+    
+    // J1: Vrefint（同时置位 TSVREFE），内部基准要求采样时间 ≥17.1us
+    sConfigInjected.InjectedChannel = ADC_CHANNEL_VREFINT;
+    sConfigInjected.InjectedRank = ADC_INJECTED_RANK_1;
+    sConfigInjected.InjectedNbrOfConversion = ADC_BATTERY_ENABLE ? 2 : 1;
+    sConfigInjected.InjectedSamplingTime = ADC_SAMPLETIME_239CYCLES_5;  // 约20us
+    sConfigInjected.ExternalTrigInjecConv = ADC_INJECTED_SOFTWARE_START;
+    sConfigInjected.AutoInjectedConv = DISABLE;                         // 只在需要时触发
+    sConfigInjected.InjectedDiscontinuousConvMode = DISABLE;
+    sConfigInjected.InjectedOffset = 0;
+    HAL_ADCEx_InjectedConfigChannel(&hadc1, &sConfigInjected);
+    
+#if ADC_BATTERY_ENABLE
+    // J2: 电池分压（高阻分压，同样用长采样时间）
+    sConfigInjected.InjectedChannel = ADC_BATTERY_CHANNEL;
+    sConfigInjected.InjectedRank = ADC_INJECTED_RANK_2;
+    HAL_ADCEx_InjectedConfigChannel(&hadc1, &sConfigInjected);
+#endif
 }
 
 /**
@@ -103,6 +124,14 @@ void HAL_ADC_MspInit(ADC_HandleTypeDef* adcHandle)
         GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
         HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
         
+#if ADC_BATTERY_ENABLE
+        // PA1: 电池分压
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        GPIO_InitStruct.Pin = ADC_BATTERY_PIN;
+        GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+        HAL_GPIO_Init(ADC_BATTERY_PORT, &GPIO_InitStruct);
+#endif
+        
         /* ========== 3. 配置 DMA ========== */
         hdma_adc1.Instance = DMA1_Channel1;
         hdma_adc1.Init.Direction = DMA_PERIPH_TO_MEMORY;       // 外设到内存
@@ -133,6 +162,9 @@ void HAL_ADC_MspDeInit(ADC_HandleTypeDef* adcHandle)
         HAL_GPIO_DeInit(GPIOB, GPIO_PIN_0 | GPIO_PIN_1);
         HAL_GPIO_DeInit(GPIOC, GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | 
                                GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5);
+#if ADC_BATTERY_ENABLE
+        HAL_GPIO_DeInit(ADC_BATTERY_PORT, ADC_BATTERY_PIN);
+#endif
         
         HAL_DMA_DeInit(adcHandle->DMA_Handle);
     }
@@ -197,3 +229,36 @@ void ADC_StartDMA(uint16_t *buffer, uint32_t length)
 {
     HAL_ADC_Start_DMA(&hadc1, (uint32_t*)buffer, length);
 }
+
+/**
+ * @brief  读取电源监测注入组（软件触发，忙等待约40us）
+ * @param  vrefint: Vrefint 原始值
+ * @param  battery: 电池分压原始值（未启用时写0）
+ * @retval 1=成功，0=超时
+ * @note   注入组不使用DMA，可在两次 ADC_ReadAll 之间低频调用
+ */
+uint8_t ADC_ReadSupply(uint16_t *vrefint, uint16_t *battery)
+{
+    if (HAL_ADCEx_InjectedStart(&hadc1) != HAL_OK) {
+        return 0;
+    }
+
+    // 1~2个通道 × 252个ADC周期（12MHz）≈ 42us
+    volatile uint32_t timeout = 1000;
+    while (timeout-- && !__HAL_ADC_GET_FLAG(&hadc1, ADC_FLAG_JEOC)) {
+    }
+
+    uint8_t ok = __HAL_ADC_GET_FLAG(&hadc1, ADC_FLAG_JEOC) ? 1 : 0;
+    if (ok) {
+        *vrefint = (uint16_t)HAL_ADCEx_InjectedGetValue(&hadc1, ADC_INJECTED_RANK_1);
+#if ADC_BATTERY_ENABLE
+        *battery = (uint16_t)HAL_ADCEx_InjectedGetValue(&hadc1, ADC_INJECTED_RANK_2);
+#else
+        *battery = 0;
+#endif
+    }
+    __HAL_ADC_CLEAR_FLAG(&hadc1, ADC_FLAG_JSTRT | ADC_FLAG_JEOC);
+
+    HAL_ADCEx_InjectedStop(&hadc1);
+    return ok;
+}
@@ -7,8 +7,10 @@
 
 #include "../include/common.h"
 #include "../include/bluetooth_control.hpp"
+#include "../include/debug.hpp"
+#include "../include/fixed_math.hpp"
+#include "../include/flight_recorder.hpp"
 #include <cstring>
-#include <cmath>
 
 // 辅助：判断是否为允许的一字节按键命令
 static inline bool isAllowedKey(uint8_t c) {
@@ -22,6 +24,19 @@ static inline bool isAllowedKey(uint8_t c) {
     }
 }
 
+// 辅助：十六进制字符转数值，非法返回-1
+static inline int hexValue(uint8_t c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// 辅助：Q15乘整数，四舍五入（对称）
+static inline int mulQ15Round(int16_t q15, int32_t value) {
+    const int32_t product = q15 * value;
+    return static_cast<int>((product + (product >= 0 ? 16384 : -16384)) / 32768);
+}
+
 // 静态成员初始化
 BluetoothControl* BluetoothControl::instance_ = nullptr;
 
@@ -37,7 +52,7 @@ BluetoothControl::BluetoothControl(RemoteControl& remoteControl)
     instance_ = this;
     memset(joystickBuffer_, 0, sizeof(joystickBuffer_));
     memset(lineBuffer_, 0, sizeof(lineBuffer_));
-    rxqHead_ = rxqTail_ = 0;
+    buildJoystickLuts();
 }
 
 /**
@@ -56,7 +71,12 @@ void BluetoothControl::init() {
     textMode_ = false;
     lineIndex_ = 0;
     memset(lineBuffer_, 0, sizeof(lineBuffer_));
-    rxqHead_ = rxqTail_ = 0;
+    rxRing_.clear();
+#if LATENCY_PROBE_ENABLE
+    rxStamps_.clear();
+    rxBytesIn_ = rxBytesOut_ = 0;
+#endif
+    frameParser_.reset();
 }
 
 /**
@@ -67,25 +87,157 @@ void BluetoothControl::setJoystickMode(bool enable) {
     joystickIndex_ = 0;
 }
 
+void BluetoothControl::pushFromISR(const uint8_t* data, uint16_t len) {
+    // 队列满时丢弃新数据（计入 rxRing_ 溢出计数），主循环读取不需要关中断
+    const uint32_t accepted = rxRing_.pushBulk(data, len);
+    if (accepted < len) {
+        FR_RECORD(FrEvent::QUEUE_OVERFLOW, FrQueue::BT_RX, len - accepted);
+    }
+#if LATENCY_PROBE_ENABLE
+    if (accepted > 0) {
+        rxBytesIn_ += accepted;
+        const RxStamp stamp = {rxBytesIn_, DWT->CYCCNT};
+        rxStamps_.push(stamp);
+    }
+#endif
+}
+
 void BluetoothControl::enqueueFromISR(uint8_t data) {
-    uint16_t nextHead = (uint16_t)((rxqHead_ + 1) % kRxQueueSize);
-    if (nextHead == rxqTail_) {
-        // 队列满，丢弃最旧一个，腾位置（避免卡死）
-        rxqTail_ = (uint16_t)((rxqTail_ + 1) % kRxQueueSize);
+    pushFromISR(&data, 1);
+}
+
+bool BluetoothControl::startDmaReception(UART_HandleTypeDef* huart) {
+    rxUart_ = huart;
+    if (txUart_ == nullptr) {
+        txUart_ = huart;
+    }
+    rxDmaPos_ = 0;
+    if (HAL_UARTEx_ReceiveToIdle_DMA(huart, rxDma_, kRxDmaSize) != HAL_OK) {
+        rxUart_ = nullptr;
+        LOG_E(BT, "[BT] DMA接收启动失败\r\n");
+        return false;
+    }
+    return true;
+}
+
+void BluetoothControl::onRxEventFromISR(UART_HandleTypeDef* huart, uint16_t pos) {
+    if (huart != rxUart_) {
+        return;
+    }
+    // 循环模式下 pos 为DMA写入位置：半满=kRxDmaSize/2，满=kRxDmaSize，空闲线=当前位置。
+    // 半满/满各触发一次，两次事件之间不会超过半个缓冲，不会套圈
+    if (pos >= kRxDmaSize) {
+        pos = 0;
+    }
+    if (pos > rxDmaPos_) {
+        pushFromISR(&rxDma_[rxDmaPos_], (uint16_t)(pos - rxDmaPos_));
+    } else if (pos < rxDmaPos_) {
+        pushFromISR(&rxDma_[rxDmaPos_], (uint16_t)(kRxDmaSize - rxDmaPos_));
+        pushFromISR(&rxDma_[0], pos);
+    }
+    rxDmaPos_ = pos;
+}
+
+void BluetoothControl::onRxErrorFromISR(UART_HandleTypeDef* huart) {
+    if (huart != rxUart_) {
+        return;
+    }
+    // HAL在溢出等错误后会停止DMA接收，已收到的数据先交出再从头开始
+    const uint16_t pos = (uint16_t)(kRxDmaSize - __HAL_DMA_GET_COUNTER(huart->hdmarx));
+    onRxEventFromISR(huart, pos);
+    rxDmaPos_ = 0;
+    HAL_UARTEx_ReceiveToIdle_DMA(huart, rxDma_, kRxDmaSize);
+}
+
+void BluetoothControl::handleBurst(const uint8_t* data, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) {
+        handleData(data[i]);
     }
-    rxQueue_[rxqHead_] = data;
-    rxqHead_ = nextHead;
 }
 
 void BluetoothControl::update() {
-    // 消费队列：逐字节喂给解析器
-    while (rxqTail_ != rxqHead_) {
-        __disable_irq();
-        uint8_t b = rxQueue_[rxqTail_];
-        rxqTail_ = (uint16_t)((rxqTail_ + 1) % kRxQueueSize);
-        __enable_irq();
-        handleData(b);
+    // 消费队列：连续的一段一次交给解析器（最多两段：到缓冲末尾、从头开始）
+    uint32_t len;
+    while (const uint8_t* data = rxRing_.readSpan(len)) {
+#if LATENCY_PROBE_ENABLE
+        for (uint32_t i = 0; i < len; i++) {
+            trackArrival();
+            handleData(data[i]);
+        }
+#else
+        handleBurst(data, (uint16_t)len);
+#endif
+        rxRing_.consume(len);
+        lastRxTick_ = HAL_GetTick();
+    }
+
+    // 帧头之后线路空闲过久：帧被截断或帧头是杂散字节，丢弃未完成的帧，不吞掉下一帧
+    if (frameParser_.busy() && HAL_GetTick() - lastRxTick_ >= bt_protocol::FRAME_GAP_MS) {
+        while (frameParser_.flushIdle() == bt_protocol::FrameParser::Result::FRAME) {
+            handleFrame(frameParser_.frame());
+        }
     }
+
+#if LATENCY_PROBE_ENABLE
+    LatencyResult result;
+    if (LatencyProbe::poll(result)) {
+        sendLatency(result);
+    }
+#endif
+}
+
+#if LATENCY_PROBE_ENABLE
+void BluetoothControl::trackArrival() {
+    // 跳过已取完的段，队首的段就是当前字节所在的段
+    rxBytesOut_++;
+    uint32_t n;
+    const RxStamp* stamp;
+    while ((stamp = rxStamps_.readSpan(n)) != nullptr && (int32_t)(stamp->end - rxBytesOut_) < 0) {
+        rxStamps_.consume(1);
+    }
+    if (stamp != nullptr) {
+        rxArrival_ = stamp->cycles;
+    }
+}
+
+void BluetoothControl::beginProbe(const bt_protocol::Frame& frame, uint8_t offset) {
+    if (frame.length < offset + 4) {
+        return;  // 不带时间戳
+    }
+    const uint8_t* p = &frame.payload[offset];
+    const uint32_t sender_ts = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    LatencyProbe::begin(sender_ts, rxArrival_);
+}
+
+void BluetoothControl::sendLatency(const LatencyResult& result) {
+    const uint32_t tx_us = LatencyProbe::nowUs();
+    const uint32_t words[3] = {result.sender_ts, result.rx_us, tx_us};
+    const uint16_t halves[5] = {result.parse_us, result.accept_us, result.ccr_us, result.edge_us,
+                                result.settle_ms};
+    uint8_t payload[22];
+    uint8_t* p = payload;
+    for (uint32_t w : words) {
+        *p++ = static_cast<uint8_t>(w);
+        *p++ = static_cast<uint8_t>(w >> 8);
+        *p++ = static_cast<uint8_t>(w >> 16);
+        *p++ = static_cast<uint8_t>(w >> 24);
+    }
+    for (uint16_t h : halves) {
+        *p++ = static_cast<uint8_t>(h);
+        *p++ = static_cast<uint8_t>(h >> 8);
+    }
+    sendFrame(bt_protocol::MsgType::LATENCY, payload, sizeof(payload));
+}
+#endif
+
+void BluetoothControl::setScriptEngine(MotionScript* script, EEPROM* eeprom) {
+    script_ = script;
+    scriptEeprom_ = eeprom;
+}
+
+void BluetoothControl::setParamHandler(
+        std::function<bt_protocol::AckStatus(uint8_t id, int16_t value)> handler) {
+    paramHandler_ = handler;
 }
 
 /**
@@ -99,6 +251,19 @@ bool BluetoothControl::isJoystickMode() const {
  * @brief 处理接收到的蓝牙数据（主入口）
  */
 void BluetoothControl::handleData(uint8_t data) {
+    // 二进制帧：0xAA 不会出现在文本协议中，收到后按帧解析直到帧结束
+    if (frameParser_.busy() || data == bt_protocol::FRAME_SYNC) {
+        switch (frameParser_.feed(data)) {
+            case bt_protocol::FrameParser::Result::FRAME:
+                handleFrame(frameParser_.frame());
+                return;
+            case bt_protocol::FrameParser::Result::PENDING:
+                return;
+            case bt_protocol::FrameParser::Result::REJECTED:
+                break;  // 帧头后不是合法长度，该字节按文本处理
+        }
+    }
+
     // 统一大小写：将小写转换为大写，便于解析
     if (data >= 'a' && data <= 'z') {
         data = static_cast<uint8_t>(data - 'a' + 'A');
@@ -110,6 +275,8 @@ void BluetoothControl::handleData(uint8_t data) {
             // 行结束：检查是否恰好是允许的单字节命令行
             if (lineIndex_ == 1 && isAllowedKey(lineBuffer_[0]) && lineBuffer_[0] != 'A') {
                 handleKeyCommand(lineBuffer_[0]);
+            } else if (lineIndex_ >= 3 && lineBuffer_[0] == '$' && lineBuffer_[1] == 'S') {
+                handleScriptLine();
             }
             // 清空并退出文本模式
             textMode_ = false;
@@ -175,6 +342,196 @@ void BluetoothControl::handleKeyCommand(uint8_t data) {
     remoteControl_.handleCommand(static_cast<char>(data));
 }
 
+/**
+ * @brief 处理二进制帧
+ */
+void BluetoothControl::handleFrame(const bt_protocol::Frame& frame) {
+    using bt_protocol::MsgType;
+
+    switch (frame.type) {
+        case MsgType::JOYSTICK: {
+            if (frame.length < 2) return;
+            int straight = static_cast<int8_t>(frame.payload[0]);
+            int turn = static_cast<int8_t>(frame.payload[1]);
+            if (straight > 100) straight = 100;
+            if (straight < -100) straight = -100;
+            if (turn > 100) turn = 100;
+            if (turn < -100) turn = -100;
+#if LATENCY_PROBE_ENABLE
+            beginProbe(frame, 2);
+#endif
+            remoteControl_.handleJoystickSpeeds(straight, turn);
+            break;
+        }
+        case MsgType::KEY: {
+            if (frame.length < 1) return;
+            uint8_t key = frame.payload[0];
+            if (key >= 'a' && key <= 'z') {
+                key = static_cast<uint8_t>(key - 'a' + 'A');
+            }
+            if (isAllowedKey(key)) {
+#if LATENCY_PROBE_ENABLE
+                beginProbe(frame, 1);
+#endif
+                handleKeyCommand(key);
+            }
+            break;
+        }
+        case MsgType::PARAM_SET: {
+            bt_protocol::AckStatus status = bt_protocol::AckStatus::BAD_VALUE;
+            if (frame.length >= 3) {
+                const int16_t value = static_cast<int16_t>(frame.payload[1] | (frame.payload[2] << 8));
+                status = applyParam(frame.payload[0], value);
+            }
+            const uint8_t ack[2] = {frame.seq, static_cast<uint8_t>(status)};
+            sendFrame(MsgType::ACK, ack, sizeof(ack));
+            break;
+        }
+        case MsgType::TELEMETRY_REQ: {
+            const uint32_t values[7] = {
+                frameParser_.getFrameCount(), frameParser_.getCrcErrors(),
+                frameParser_.getLostFrames(), frameParser_.getDuplicates(), rxRing_.overflowCount(),
+                supply_ != nullptr ? supply_->getSupplyMillivolts() : 0u,
+                supply_ != nullptr ? static_cast<uint32_t>(supply_->getGainQ8()) : 0u,
+            };
+            uint8_t payload[14];
+            for (uint8_t i = 0; i < 7; i++) {
+                const uint16_t v = values[i] > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(values[i]);
+                payload[i * 2] = static_cast<uint8_t>(v);
+                payload[i * 2 + 1] = static_cast<uint8_t>(v >> 8);
+            }
+            sendFrame(MsgType::TELEMETRY, payload, sizeof(payload));
+            break;
+        }
+        default:
+            LOG_D(BT, "[BT] 未知帧类型 %d\r\n", static_cast<int>(frame.type));
+            break;
+    }
+}
+
+/**
+ * @brief 设置内置参数，参数号 ≥ USER 时交给自定义处理函数
+ */
+bt_protocol::AckStatus BluetoothControl::applyParam(uint8_t id, int16_t value) {
+    using bt_protocol::AckStatus;
+    using bt_protocol::BtParam;
+
+    if (id >= static_cast<uint8_t>(BtParam::USER)) {
+        return paramHandler_ ? paramHandler_(id, value) : AckStatus::UNKNOWN_PARAM;
+    }
+    if (value < 0) {
+        return AckStatus::BAD_VALUE;
+    }
+    switch (static_cast<BtParam>(id)) {
+        case BtParam::TIMEOUT_MS:
+            remoteControl_.setTimeout(static_cast<uint32_t>(value));
+            break;
+        case BtParam::BASE_SPEED:
+            remoteControl_.setBaseSpeed(value);
+            break;
+        case BtParam::MAX_SPEED:
+            remoteControl_.setMaxSpeed(value);
+            break;
+        case BtParam::SPEED_INCREMENT:
+            remoteControl_.setSpeedIncrement(value);
+            break;
+        case BtParam::TURN_SENSITIVITY:
+            remoteControl_.setTurnSensitivity(value);
+            break;
+        case BtParam::JOY_DEADZONE:
+        case BtParam::JOY_EXPO:
+        case BtParam::JOY_TURN_AT_STOP:
+        case BtParam::JOY_TURN_AT_FULL: {
+            if (value > 100) {
+                return AckStatus::BAD_VALUE;
+            }
+            JoystickCurve curve = joystickCurve_;
+            const uint8_t v = static_cast<uint8_t>(value);
+            switch (static_cast<BtParam>(id)) {
+                case BtParam::JOY_DEADZONE: curve.deadzone = v; break;
+                case BtParam::JOY_EXPO: curve.expo = v; break;
+                case BtParam::JOY_TURN_AT_STOP: curve.turnAtStop = v; break;
+                default: curve.turnAtFull = v; break;
+            }
+            if (!setJoystickCurve(curve)) {
+                return AckStatus::BAD_VALUE;
+            }
+            break;
+        }
+        default:
+            return AckStatus::UNKNOWN_PARAM;
+    }
+    LOG_I(BT, "[BT] 参数%d = %d\r\n", id, value);
+    return AckStatus::OK;
+}
+
+/**
+ * @brief 发送回复帧（主循环中调用，115200波特率下最长帧阻塞约2.3ms）
+ */
+void BluetoothControl::sendFrame(bt_protocol::MsgType type, const uint8_t* payload, uint8_t length) {
+    if (txUart_ == nullptr) {
+        return;
+    }
+    uint8_t buf[bt_protocol::MAX_FRAME];
+    const uint8_t n = bt_protocol::encode(type, txSeq_++, payload, length, buf);
+    if (n > 0) {
+        HAL_UART_Transmit(txUart_, buf, n, 5);
+    }
+}
+
+/**
+ * @brief 处理脚本命令行（$SC / $S+hex / $SR / $SX / $SW / $SL）
+ */
+void BluetoothControl::handleScriptLine() {
+    if (script_ == nullptr) {
+        return;
+    }
+
+    switch (lineBuffer_[2]) {
+        case 'C':
+            script_->clear();
+            LOG_I(SCRIPT, "[Script] 已清空\r\n");
+            break;
+        case '+': {
+            uint8_t chunk[MAX_SCRIPT_CHUNK];
+            uint8_t count = 0;
+            if ((lineIndex_ - 3) % 2 != 0) {
+                LOG_W(SCRIPT, "[Script] 十六进制格式错误\r\n");
+                return;
+            }
+            for (uint8_t i = 3; i + 1 < lineIndex_; i += 2) {
+                int hi = hexValue(lineBuffer_[i]);
+                int lo = hexValue(lineBuffer_[i + 1]);
+                if (hi < 0 || lo < 0 || count >= MAX_SCRIPT_CHUNK) {
+                    LOG_W(SCRIPT, "[Script] 十六进制格式错误\r\n");
+                    return;
+                }
+                chunk[count++] = static_cast<uint8_t>((hi << 4) | lo);
+            }
+            if (!script_->append(chunk, count)) {
+                LOG_W(SCRIPT, "[Script] 脚本超长（最多%d字节）\r\n", MotionScript::MAX_LENGTH);
+                return;
+            }
+            LOG_I(SCRIPT, "[Script] 已接收 %d 字节\r\n", script_->getLength());
+            break;
+        }
+        case 'R':
+            script_->start();
+            break;
+        case 'X':
+            script_->abort();
+            break;
+        case 'W':
+            if (scriptEeprom_ != nullptr) script_->saveToEEPROM(*scriptEeprom_);
+            break;
+        case 'L':
+            if (scriptEeprom_ != nullptr) script_->loadFromEEPROM(*scriptEeprom_);
+            break;
+        default:
+            break;
+    }
+}
+
 /**
  * @brief 处理摇杆模式命令（A[角度]P[力度]\n）
  */
@@ -226,30 +583,70 @@ void BluetoothControl::handleJoystickCommand() {
  * - 180° = 正左（左转）
  * - 270° = 正下（后退）
  * 
- * 策略：
- * - 将360度分为8个区域，映射到 F/B/L/R/W/X/Y/Z
- * - 力度映射为速度百分比
+ * 力度经 powerLut_（死区 + expo）得到幅值，再用Q15正弦表分解：
+ * straight = sin(θ)·幅值，turn = cos(θ)·幅值，转向按 turnLimitLut_ 随直行速度限幅。
+ * 全程整数运算，一帧约百个周期。
  */
 void BluetoothControl::convertJoystickToMotion(int angle, int power) {
-    // 力度为0：停止
-    if (power <= 0) {
+    // 力度为0（或落在死区内）：停止
+    if (power > 99) power = 99;
+    const int32_t magnitude = (power > 0) ? powerLut_[power] : 0;
+    if (magnitude == 0) {
         remoteControl_.handleJoystickSpeeds(0, 0);
         return;
     }
 
-    // 角度归一化
-    angle = angle % 360;
+    // 角度归一化并换算为二进制角度（65536 = 360°）
+    angle %= 360;
+    if (angle < 0) angle += 360;
+    const uint16_t theta = static_cast<uint16_t>(
+        (static_cast<uint32_t>(angle) * fixed_math::ANGLE_FULL_TURN + 180) / 360);
 
-    // 将极坐标(角度,力度0-99)映射为车体坐标：前进/后退(-100..100)、转向(-100..100)
-    // 约定：90°=前，270°=后，0°=右转，180°=左转
-    // 使用正弦/余弦映射：
-    // straight = sin(theta) * magnitude
-    // turn = cos(theta) * magnitude
-    const float rad = static_cast<float>(angle) * 3.1415926f / 180.0f;
-    const float magnitude = static_cast<float>(power) * (100.0f / 99.0f); // 规范化到约0..100
-    int straight = static_cast<int>(std::roundf(std::sin(rad) * magnitude));
-    int turn = static_cast<int>(std::roundf(std::cos(rad) * magnitude));
+    int straight = mulQ15Round(fixed_math::sinQ15(theta), magnitude);
+    int turn = mulQ15Round(fixed_math::cosQ15(theta), magnitude);
+    turn = turn * turnLimitLut_[straight < 0 ? -straight : straight] / 100;
 
     // 将模拟速度交给 RemoteControl（会做限幅与梯形平滑）
     remoteControl_.handleJoystickSpeeds(straight, turn);
 }
+
+/**
+ * @brief 设置角度摇杆响应曲线
+ */
+bool BluetoothControl::setJoystickCurve(const JoystickCurve& curve) {
+    if (curve.deadzone > 50 || curve.expo > 100 || curve.turnAtStop > 100 || curve.turnAtFull > 100) {
+        return false;
+    }
+    joystickCurve_ = curve;
+    buildJoystickLuts();
+    return true;
+}
+
+/**
+ * @brief 生成响应曲线查找表（Q15整数运算）
+ */
+void BluetoothControl::buildJoystickLuts() {
+    const int32_t one = 32767;
+    const int32_t deadzone = joystickCurve_.deadzone * one / 100;
+    const int32_t expo = joystickCurve_.expo;
+
+    for (int32_t p = 0; p < 100; p++) {
+        int32_t x = p * one / 99;
+        if (x <= deadzone) {
+            powerLut_[p] = 0;
+            continue;
+        }
+        x = (x - deadzone) * one / (one - deadzone);
+        const int32_t cube = (((x * x) >> 15) * x) >> 15;
+        const int32_t y = ((100 - expo) * x + expo * cube) / 100;
+        int32_t out = mulQ15Round(static_cast<int16_t>(y), 100);
+        // 出了死区至少给1%，避免刚推出死区时还没有输出
+        powerLut_[p] = static_cast<uint8_t>(out > 0 ? out : 1);
+    }
+
+    const int32_t stop = joystickCurve_.turnAtStop;
+    const int32_t full = joystickCurve_.turnAtFull;
+    for (int32_t s = 0; s <= 100; s++) {
+        turnLimitLut_[s] = static_cast<uint8_t>(stop + ((full - stop) * s + (full >= stop ? 50 : -50)) / 100);
+    }
+}
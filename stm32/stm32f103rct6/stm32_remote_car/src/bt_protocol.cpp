@@ -0,0 +1,141 @@
+/**
+ * @file    bt_protocol.cpp
+ * @brief   蓝牙二进制控制帧实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "bt_protocol.hpp"
+
+#include <string.h>
+
+#include "crc.hpp"
+
+namespace bt_protocol {
+
+FrameParser::FrameParser() {
+    reset();
+}
+
+void FrameParser::reset() {
+    index_ = 0;
+    frame_ = Frame();
+    has_seq_ = false;
+    last_seq_ = 0;
+    frames_ = 0;
+    crc_errors_ = 0;
+    lost_ = 0;
+    duplicates_ = 0;
+    truncated_ = 0;
+}
+
+namespace {
+
+inline bool lengthValid(uint8_t length) {
+    return length >= 1 && length <= MAX_PAYLOAD + 1;
+}
+
+}  // namespace
+
+FrameParser::Result FrameParser::feed(uint8_t byte) {
+    if (index_ == 0 && byte != FRAME_SYNC) {
+        return Result::REJECTED;
+    }
+    if (index_ == 1 && !lengthValid(byte)) {
+        // 帧头后长度非法：多半是文本中的杂散字节，交还给文本协议
+        index_ = 0;
+        return Result::REJECTED;
+    }
+    buf_[index_++] = byte;
+    return process();
+}
+
+FrameParser::Result FrameParser::flushIdle() {
+    if (process() == Result::FRAME) {
+        return Result::FRAME;
+    }
+    if (index_ > 0) {
+        truncated_++;
+        index_ = 0;
+    }
+    return Result::PENDING;
+}
+
+/**
+ * @brief 检查缓冲：得到一帧、需要更多字节，或丢弃坏帧头后从下一个帧头继续
+ *
+ * 重新同步后留下的字节里可能已有完整帧，所以循环检查；得到一帧时剩余字节留在缓冲，
+ * 下次 feed()/flushIdle() 继续。缓冲中的字节数始终小于当前帧长度（最多 MAX_FRAME）。
+ */
+FrameParser::Result FrameParser::process() {
+    while (index_ >= 2) {
+        const uint8_t length = buf_[1];
+        if (!lengthValid(length)) {
+            resync(1);
+            continue;
+        }
+        const uint8_t total = length + 3;
+        if (index_ < total) {
+            return Result::PENDING;
+        }
+        if (crc::crc8(&buf_[1], length + 1) != buf_[total - 1]) {
+            crc_errors_++;
+            resync(1);
+            continue;
+        }
+        const bool fresh = accept();
+        resync(total);
+        if (fresh) {
+            return Result::FRAME;
+        }
+    }
+    return Result::PENDING;
+}
+
+/**
+ * @brief 丢弃 from 之前的字节，并跳到其后第一个帧头
+ */
+void FrameParser::resync(uint8_t from) {
+    uint8_t i = from;
+    while (i < index_ && buf_[i] != FRAME_SYNC) {
+        i++;
+    }
+    memmove(buf_, &buf_[i], index_ - i);
+    index_ -= i;
+}
+
+bool FrameParser::accept() {
+    const uint8_t header = buf_[2];
+    const uint8_t seq = header & 0x0F;
+
+    if (has_seq_) {
+        if (seq == last_seq_) {
+            duplicates_++;
+            return false;
+        }
+        lost_ += (uint8_t)(seq - last_seq_ - 1) & 0x0F;
+    }
+    has_seq_ = true;
+    last_seq_ = seq;
+    frames_++;
+
+    frame_.type = static_cast<MsgType>(header >> 4);
+    frame_.seq = seq;
+    frame_.length = buf_[1] - 1;
+    memcpy(frame_.payload, &buf_[3], frame_.length);
+    return true;
+}
+
+uint8_t encode(MsgType type, uint8_t seq, const uint8_t* payload, uint8_t length, uint8_t* out) {
+    if (length > MAX_PAYLOAD) {
+        return 0;
+    }
+    out[0] = FRAME_SYNC;
+    out[1] = length + 1;
+    out[2] = static_cast<uint8_t>((static_cast<uint8_t>(type) << 4) | (seq & 0x0F));
+    memcpy(&out[3], payload, length);
+    out[length + 3] = crc::crc8(&out[1], length + 2);
+    return length + FRAME_OVERHEAD;
+}
+
+}  // namespace bt_protocol
@@ -24,7 +24,10 @@ Button::Button(GPIO_TypeDef* port, uint16_t pin, ButtonMode mode, uint32_t debou
         , release_triggered_(false)
         , initialized_(false)
         , prev_state_for_release_(false)
-        , prev_state_for_longpress_(false) {
+        , prev_state_for_longpress_(false)
+        , prev_state_for_short_(false)
+        , short_press_armed_(false)
+        , short_press_start_(0) {
     init();
 }
 
@@ -176,6 +179,8 @@ bool Button::isLongPressed(uint32_t long_press_ms) {
 
     // 更新上一次状态
     prev_state_for_longpress_ = current_state_;
+    prev_state_for_short_ = current_state_;
+    short_press_armed_ = false;  // 重置时仍按住，这次释放不算短按
 
     // 如果按钮当前按下，检查持续时间
     if (current_state_) {
@@ -195,6 +200,29 @@ bool Button::isLongPressed(uint32_t long_press_ms) {
     return false;
 }
 
+/**
+ * @brief 检测短按事件
+ */
+bool Button::isShortPressed(uint32_t long_press_ms) {
+    update();
+
+    uint32_t current_time = HAL_GetTick();
+    bool short_press = false;
+
+    if (current_state_ && !prev_state_for_short_) {
+        // 按下：记录时刻
+        short_press_start_ = current_time;
+        short_press_armed_ = true;
+    } else if (!current_state_ && prev_state_for_short_) {
+        // 释放：未达到长按阈值才算短按
+        short_press = short_press_armed_ && (current_time - short_press_start_ < long_press_ms);
+        short_press_armed_ = false;
+    }
+
+    prev_state_for_short_ = current_state_;
+    return short_press;
+}
+
 /**
  * @brief 获取按钮按下持续时间
  */
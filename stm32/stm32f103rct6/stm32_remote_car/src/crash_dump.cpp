@@ -0,0 +1,241 @@
+/**
+ * @file    crash_dump.cpp
+ * @brief   故障现场保存实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "crash_dump.hpp"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "crc.hpp"
+#include "debug.hpp"
+#include "stm32f1xx_hal.h"
+
+extern "C" uint32_t _estack;  // 链接脚本：RAM末尾（初始栈顶）
+
+namespace {
+
+constexpr uint32_t RECORD_MAGIC = 0xC4A5D00Du;
+constexpr uint32_t COUNT_MAGIC = 0x5EC0C0DEu;
+
+/**
+ * @brief 崩溃记录（字段顺序与报告一致）
+ */
+struct CrashRecord {
+    uint32_t magic;
+    uint8_t cause;
+    uint8_t stage;
+    uint16_t log_len;
+    uint32_t tick;
+    uint32_t r0, r1, r2, r3, r12, lr, pc, xpsr;
+    uint32_t sp;          // 异常栈帧地址
+    uint32_t exc_return;
+    uint32_t cfsr, hfsr, mmfar, bfar;
+    uint8_t log[CrashDump::CRASH_LOG_BYTES];
+    uint8_t crc;          // crc8(magic .. log)
+};
+
+struct NoInitState {
+    CrashRecord record;
+    uint32_t count_magic;
+    uint32_t crash_count;
+    uint8_t stage;        // 主循环当前阶段（复位后仍保留，直到下次 setStage）
+};
+
+NoInitState noinit __attribute__((section(".noinit")));
+
+const char* const CAUSE_NAMES[] = {
+    "None", "HardFault", "MemManage", "BusFault", "UsageFault", "Error_Handler",
+};
+static_assert(sizeof(CAUSE_NAMES) / sizeof(CAUSE_NAMES[0]) == static_cast<uint8_t>(CrashCause::COUNT),
+              "CAUSE_NAMES与CrashCause不一致");
+
+const char* const STAGE_NAMES[] = {
+    "TICK", "ADC", "FILTER", "SENSOR_CFG", "POSITION", "PID",
+    "POST", "OUTPUT", "DEBUG", "OLED", "LOOP",
+};
+static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<uint8_t>(BudgetStage::COUNT),
+              "STAGE_NAMES与BudgetStage不一致");
+
+/// CFSR/HFSR 中置位的标志名
+struct FaultBit {
+    uint32_t mask;
+    const char* name;
+};
+
+const FaultBit CFSR_BITS[] = {
+    {SCB_CFSR_IACCVIOL_Msk, "IACCVIOL"},     {SCB_CFSR_DACCVIOL_Msk, "DACCVIOL"},
+    {SCB_CFSR_MUNSTKERR_Msk, "MUNSTKERR"},   {SCB_CFSR_MSTKERR_Msk, "MSTKERR"},
+    {SCB_CFSR_MMARVALID_Msk, "MMARVALID"},   {SCB_CFSR_IBUSERR_Msk, "IBUSERR"},
+    {SCB_CFSR_PRECISERR_Msk, "PRECISERR"},   {SCB_CFSR_IMPRECISERR_Msk, "IMPRECISERR"},
+    {SCB_CFSR_UNSTKERR_Msk, "UNSTKERR"},     {SCB_CFSR_STKERR_Msk, "STKERR"},
+    {SCB_CFSR_BFARVALID_Msk, "BFARVALID"},   {SCB_CFSR_UNDEFINSTR_Msk, "UNDEFINSTR"},
+    {SCB_CFSR_INVSTATE_Msk, "INVSTATE"},     {SCB_CFSR_INVPC_Msk, "INVPC"},
+    {SCB_CFSR_NOCP_Msk, "NOCP"},             {SCB_CFSR_UNALIGNED_Msk, "UNALIGNED"},
+    {SCB_CFSR_DIVBYZERO_Msk, "DIVBYZERO"},
+};
+
+const FaultBit HFSR_BITS[] = {
+    {SCB_HFSR_VECTTBL_Msk, "VECTTBL"},
+    {SCB_HFSR_FORCED_Msk, "FORCED"},
+    {SCB_HFSR_DEBUGEVT_Msk, "DEBUGEVT"},
+};
+
+uint8_t recordCrc(const CrashRecord& r) {
+    return crc::crc8(reinterpret_cast<const uint8_t*>(&r), offsetof(CrashRecord, crc));
+}
+
+/**
+ * @brief 栈帧的8个字是否都在RAM内（栈溢出时可能指向RAM之外）
+ */
+bool frameReadable(const uint32_t* frame) {
+    const uint32_t addr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(frame));
+    const uint32_t ram_end = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&_estack));
+    return (addr & 3u) == 0 && addr >= SRAM_BASE && addr + 8u * sizeof(uint32_t) <= ram_end;
+}
+
+/**
+ * @brief 填写公共字段、保存日志并复位（不返回）
+ */
+__attribute__((noreturn)) void saveAndReset(CrashCause cause) {
+    CrashRecord& r = noinit.record;
+    r.cause = static_cast<uint8_t>(cause);
+    r.stage = noinit.stage;
+    r.tick = HAL_GetTick();
+    r.cfsr = SCB->CFSR;
+    r.hfsr = SCB->HFSR;
+    r.mmfar = SCB->MMFAR;
+    r.bfar = SCB->BFAR;
+    r.log_len = static_cast<uint16_t>(Debug_CopyRecent(r.log, CrashDump::CRASH_LOG_BYTES));
+    r.magic = RECORD_MAGIC;
+    r.crc = recordCrc(r);
+
+    if (noinit.count_magic != COUNT_MAGIC) {
+        noinit.count_magic = COUNT_MAGIC;
+        noinit.crash_count = 0;
+    }
+    noinit.crash_count++;
+
+    __DSB();
+    NVIC_SystemReset();
+}
+
+void printFlags(char* out, uint32_t size, uint32_t value, const FaultBit* bits, uint32_t count) {
+    uint32_t len = strlen(out);
+    for (uint32_t i = 0; i < count; i++) {
+        if ((value & bits[i].mask) == 0) {
+            continue;
+        }
+        const uint32_t n = strlen(bits[i].name);
+        if (len + n + 2 > size) {
+            break;
+        }
+        out[len++] = ' ';
+        memcpy(&out[len], bits[i].name, n + 1);
+        len += n;
+    }
+}
+
+}  // namespace
+
+extern "C" void CrashDump_OnFault(const uint32_t* frame, uint32_t exc_return, uint32_t cause) {
+    CrashRecord& r = noinit.record;
+    r.sp = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(frame));
+    r.exc_return = exc_return;
+    if (frameReadable(frame)) {
+        r.r0 = frame[0];
+        r.r1 = frame[1];
+        r.r2 = frame[2];
+        r.r3 = frame[3];
+        r.r12 = frame[4];
+        r.lr = frame[5];
+        r.pc = frame[6];
+        r.xpsr = frame[7];
+    } else {
+        r.r0 = r.r1 = r.r2 = r.r3 = r.r12 = r.lr = r.pc = r.xpsr = 0;
+    }
+    if (cause >= static_cast<uint32_t>(CrashCause::COUNT)) {
+        cause = static_cast<uint32_t>(CrashCause::HARD_FAULT);
+    }
+    saveAndReset(static_cast<CrashCause>(cause));
+}
+
+extern "C" void CrashDump_OnError(uint32_t caller) {
+    __disable_irq();
+    CrashRecord& r = noinit.record;
+    r.r0 = r.r1 = r.r2 = r.r3 = r.r12 = 0;
+    r.lr = caller;
+    r.pc = caller;
+    r.xpsr = __get_xPSR();
+    r.sp = __get_MSP();
+    r.exc_return = 0;
+    saveAndReset(CrashCause::ERROR_HANDLER);
+}
+
+namespace CrashDump {
+
+void init() {
+    noinit.stage = static_cast<uint8_t>(BudgetStage::COUNT);  // 进入主循环前显示为 INIT
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk;
+}
+
+bool reportIfAny() {
+    CrashRecord& r = noinit.record;
+    const bool valid = r.magic == RECORD_MAGIC && r.crc == recordCrc(r) &&
+                       r.cause < static_cast<uint8_t>(CrashCause::COUNT) &&
+                       r.log_len <= CRASH_LOG_BYTES;
+    if (noinit.count_magic != COUNT_MAGIC) {
+        noinit.count_magic = COUNT_MAGIC;
+        noinit.crash_count = 0;
+    }
+    if (!valid) {
+        r.magic = 0;
+        return false;
+    }
+
+    const char* stage = r.stage < static_cast<uint8_t>(BudgetStage::COUNT) ? STAGE_NAMES[r.stage] : "INIT";
+    Debug_Print_Always("\r\n[CRASH] %s 第%lu次 运行 %lums 阶段=%s 中断=%lu\r\n", CAUSE_NAMES[r.cause],
+                       (unsigned long)noinit.crash_count, (unsigned long)r.tick, stage,
+                       (unsigned long)(r.xpsr & 0x1FFu));
+    Debug_Flush(100);
+    Debug_Print_Always("[CRASH] PC=0x%08lX LR=0x%08lX xPSR=0x%08lX SP=0x%08lX EXC_RETURN=0x%08lX\r\n",
+                       (unsigned long)r.pc, (unsigned long)r.lr, (unsigned long)r.xpsr,
+                       (unsigned long)r.sp, (unsigned long)r.exc_return);
+    Debug_Flush(100);
+    Debug_Print_Always("[CRASH] R0=0x%08lX R1=0x%08lX R2=0x%08lX R3=0x%08lX R12=0x%08lX\r\n",
+                       (unsigned long)r.r0, (unsigned long)r.r1, (unsigned long)r.r2,
+                       (unsigned long)r.r3, (unsigned long)r.r12);
+    Debug_Flush(100);
+
+    char flags[96] = "";
+    printFlags(flags, sizeof(flags), r.cfsr, CFSR_BITS, sizeof(CFSR_BITS) / sizeof(CFSR_BITS[0]));
+    printFlags(flags, sizeof(flags), r.hfsr, HFSR_BITS, sizeof(HFSR_BITS) / sizeof(HFSR_BITS[0]));
+    Debug_Print_Always("[CRASH] CFSR=0x%08lX HFSR=0x%08lX MMFAR=0x%08lX BFAR=0x%08lX%s\r\n",
+                       (unsigned long)r.cfsr, (unsigned long)r.hfsr, (unsigned long)r.mmfar,
+                       (unsigned long)r.bfar, flags);
+    Debug_Flush(100);
+
+    // 原样输出崩溃前的调试字节：文本直接可读，延迟格式化帧由 log_decoder.py 解码
+    Debug_Print_Always("[CRASH] ---- 崩溃前日志 %u 字节 ----\r\n", r.log_len);
+    Debug_Flush(100);
+    Debug_Write(r.log, r.log_len);
+    Debug_Flush(100);
+    Debug_Print_Always("\r\n[CRASH] ---- END ----\r\n");
+    Debug_Flush(100);
+
+    r.magic = 0;
+    return true;
+}
+
+uint32_t getCrashCount() {
+    return noinit.count_magic == COUNT_MAGIC ? noinit.crash_count : 0;
+}
+
+void setStage(BudgetStage stage) {
+    noinit.stage = static_cast<uint8_t>(stage);
+}
+
+}  // namespace CrashDump
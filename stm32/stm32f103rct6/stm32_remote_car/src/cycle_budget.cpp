@@ -0,0 +1,174 @@
+/**
+ * @file    cycle_budget.cpp
+ * @brief   控制周期分段计时实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "cycle_budget.hpp"
+
+#if CYCLE_BUDGET_ENABLE
+
+#include "debug.hpp"
+#include "flight_recorder.hpp"
+#include "tim.h"
+
+namespace {
+
+/**
+ * 对数直方图：每个2的幂区间再分4格（精度约±12%），
+ * 覆盖 64 ~ 2^22 周期（约0.9us ~ 58ms @72MHz）
+ */
+constexpr uint8_t HIST_MIN_SHIFT = 6;
+constexpr uint8_t HIST_SUB_BITS = 2;
+constexpr uint8_t HIST_BUCKETS = 64;
+
+struct StageStats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t budget_cycles;  // 0 = 不检查
+    uint32_t overruns;
+    uint16_t hist[HIST_BUCKETS];
+};
+
+StageStats stats[static_cast<uint8_t>(BudgetStage::COUNT)];
+
+const char* const STAGE_NAMES[] = {
+    "tick", "adc", "filter", "sensor_cfg", "position", "pid",
+    "post", "output", "debug", "oled", "loop",
+};
+static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) ==
+                      static_cast<uint8_t>(BudgetStage::COUNT),
+              "STAGE_NAMES与BudgetStage不一致");
+
+uint8_t bucketOf(uint32_t cycles) {
+    if (cycles < (1u << HIST_MIN_SHIFT)) {
+        return 0;
+    }
+    uint8_t msb = 31 - __CLZ(cycles);
+    uint8_t sub = (cycles >> (msb - HIST_SUB_BITS)) & ((1u << HIST_SUB_BITS) - 1);
+    uint32_t index = (uint32_t)(msb - HIST_MIN_SHIFT) * (1u << HIST_SUB_BITS) + sub;
+    return (index < HIST_BUCKETS) ? index : HIST_BUCKETS - 1;
+}
+
+/// 桶的上界（周期），用于保守地报告p99
+uint32_t bucketUpper(uint8_t index) {
+    uint8_t octave = index >> HIST_SUB_BITS;
+    uint8_t sub = index & ((1u << HIST_SUB_BITS) - 1);
+    uint8_t msb = octave + HIST_MIN_SHIFT;
+    return ((uint32_t)((1u << HIST_SUB_BITS) + sub + 1)) << (msb - HIST_SUB_BITS);
+}
+
+uint32_t cyclesPerUs() {
+    return SystemCoreClock / 1000000u;
+}
+
+/// 周期数转换为0.1us单位
+uint32_t toTenthUs(uint32_t cycles) {
+    return (uint32_t)((uint64_t)cycles * 10u / cyclesPerUs());
+}
+
+}  // namespace
+
+namespace CycleBudget {
+
+void init() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    reset();
+    setBudget(BudgetStage::TICK, CYCLE_BUDGET_DEADLINE_US);
+    setBudget(BudgetStage::LOOP, CYCLE_BUDGET_DEADLINE_US);
+}
+
+void reset() {
+    for (StageStats& s : stats) {
+        uint32_t budget = s.budget_cycles;
+        s = StageStats();
+        s.min = UINT32_MAX;
+        s.budget_cycles = budget;
+    }
+    TIM_PWM_ResetLatency();  // 报告中的PWM延迟与阶段统计同一窗口
+}
+
+void record(BudgetStage stage, uint32_t cycles) {
+    StageStats& s = stats[static_cast<uint8_t>(stage)];
+    s.count++;
+    s.sum += cycles;
+    if (cycles < s.min) s.min = cycles;
+    if (cycles > s.max) s.max = cycles;
+
+    uint16_t& bucket = s.hist[bucketOf(cycles)];
+    if (bucket != UINT16_MAX) {
+        bucket++;
+    }
+
+    if (s.budget_cycles != 0 && cycles > s.budget_cycles) {
+        s.overruns++;
+        const uint32_t us = cycles / cyclesPerUs();
+        FR_RECORD(FrEvent::DEADLINE_MISS, stage, us < INT16_MAX ? us : INT16_MAX);
+    }
+}
+
+void setBudget(BudgetStage stage, uint32_t budget_us) {
+    stats[static_cast<uint8_t>(stage)].budget_cycles = budget_us * cyclesPerUs();
+}
+
+uint32_t getOverruns(BudgetStage stage) {
+    return stats[static_cast<uint8_t>(stage)].overruns;
+}
+
+void report() {
+    Debug_Print_Always("\r\n[CycleBudget] 单位: us (预算 %lu us)\r\n",
+                       (unsigned long)CYCLE_BUDGET_DEADLINE_US);
+    Debug_Print_Always("%-10s %8s %9s %9s %9s %9s %6s\r\n",
+                       "stage", "count", "min", "avg", "max", "p99", "over");
+
+    for (uint8_t i = 0; i < static_cast<uint8_t>(BudgetStage::COUNT); i++) {
+        const StageStats& s = stats[i];
+        if (s.count == 0) {
+            continue;
+        }
+
+        // p99：累计到99%所在桶的上界（不超过实测最大值）
+        uint32_t total = 0;
+        for (uint16_t c : s.hist) total += c;
+        uint32_t target = total - total / 100;
+        uint32_t acc = 0;
+        uint32_t p99 = s.max;
+        for (uint8_t b = 0; b < HIST_BUCKETS; b++) {
+            acc += s.hist[b];
+            if (acc >= target) {
+                p99 = bucketUpper(b);
+                break;
+            }
+        }
+        if (p99 > s.max) p99 = s.max;
+
+        Debug_Flush(100);  // 报告比发送缓冲长，逐行等待发送
+        uint32_t avg = (uint32_t)(s.sum / s.count);
+        uint32_t mn = toTenthUs(s.min), av = toTenthUs(avg), mx = toTenthUs(s.max), pp = toTenthUs(p99);
+        Debug_Print_Always("%-10s %8lu %7lu.%lu %7lu.%lu %7lu.%lu %7lu.%lu %6lu\r\n", STAGE_NAMES[i],
+                           (unsigned long)s.count,
+                           (unsigned long)(mn / 10), (unsigned long)(mn % 10),
+                           (unsigned long)(av / 10), (unsigned long)(av % 10),
+                           (unsigned long)(mx / 10), (unsigned long)(mx % 10),
+                           (unsigned long)(pp / 10), (unsigned long)(pp % 10),
+                           (unsigned long)s.overruns);
+    }
+
+    // 命令提交到舵机看到新脉宽的延迟（等待下一个PWM帧）
+    TIM_PWM_Latency latency;
+    TIM_PWM_GetLatency(&htim3, &latency);
+    Debug_Print_Always("[PWM] 帧周期 %lu us, 命令->脉冲延迟 avg %lu us, max %lu us (n=%lu)\r\n",
+                       (unsigned long)latency.frame_us, (unsigned long)latency.avg_us,
+                       (unsigned long)latency.max_us, (unsigned long)latency.count);
+    Debug_Print_Always("[Debug] 发送缓冲丢弃 %lu 字节\r\n", (unsigned long)Debug_GetDroppedBytes());
+}
+
+}  // namespace CycleBudget
+
+#endif  // CYCLE_BUDGET_ENABLE
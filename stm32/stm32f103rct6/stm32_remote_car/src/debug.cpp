@@ -9,6 +9,15 @@
  * 2. printf重定向到USART2串口
  * 3. 提供Debug_Printf()函数，仅在调试模式启用时输出
  * 4. 提供Debug_Print_Always()函数，不受调试模式控制
+ * 5. DEBUG_TX_DMA_ENABLE=1 时输出不阻塞：数据写入环形缓冲后立即返回，
+ *    由 UART TX DMA 在后台发送，缓冲满时丢弃整条消息并计数
+ * 
+ * 非阻塞发送的线程模型（单生产者/单消费者，无锁）：
+ * - 生产者：主循环中的 Debug_Printf/Debug_Write，只写 tx_head_
+ * - 消费者：调试串口的 USART 中断（Debug_TxService），只写 tx_tail_
+ * - 生产者写完数据后挂起 USART 中断，启动DMA的动作始终在中断里完成，
+ *   因此不需要关中断；DMA发送完成（TC中断）后中断里再启动下一段
+ * - 不要在中断里调用 Debug_Printf（会成为第二个生产者）
  * 
  * 使用示例：
  *   // 启用调试
@@ -28,6 +37,9 @@
  */
 
 #include "debug.hpp"
+#include "debug_config.h"
+#include "flight_recorder.hpp"
+#include "spsc_ring.hpp"
 #include "usart.h"
 #include <string.h>
 
@@ -37,6 +49,146 @@ volatile bool g_debug_enabled = true;
 /* 当前使用的调试串口（默认USART1） */
 UART_HandleTypeDef* g_debug_uart = &huart1;
 
+#if DEBUG_TX_DMA_ENABLE
+/* 发送环形缓冲（主循环写入，串口中断交给DMA；DMA完成后才释放空间） */
+static SpscRing<uint8_t, DEBUG_TX_RING_SIZE> tx_ring_;
+static volatile uint16_t tx_inflight_ = 0;   // 正在DMA发送的字节数
+
+/**
+ * @brief 挂起调试串口中断，由中断上下文启动DMA
+ */
+static void Debug_KickTx(void)
+{
+    if (g_debug_uart->Instance == USART1) {
+        HAL_NVIC_SetPendingIRQ(USART1_IRQn);
+    } else if (g_debug_uart->Instance == USART2) {
+        HAL_NVIC_SetPendingIRQ(USART2_IRQn);
+    }
+}
+#endif
+
+/**
+ * @brief 写入原始字节（非阻塞模式下放入环形缓冲）
+ * @param data 数据
+ * @param len 长度
+ * @return 实际接受的字节数（缓冲满时为0）
+ */
+uint32_t Debug_Write(const uint8_t* data, uint32_t len)
+{
+#if DEBUG_TX_DMA_ENABLE
+    if (!tx_ring_.pushAll(data, len)) {
+        // 缓冲满：整条丢弃，不输出半行
+        FR_RECORD(FrEvent::QUEUE_OVERFLOW, FrQueue::DEBUG_TX, len < INT16_MAX ? len : INT16_MAX);
+        return 0;
+    }
+
+    Debug_KickTx();
+    return len;
+#else
+    HAL_UART_Transmit(g_debug_uart, (uint8_t*)data, len, DEBUG_UART_TIMEOUT);
+    return len;
+#endif
+}
+
+/**
+ * @brief 发送服务（由调试串口的USART中断调用）
+ * @param huart 产生中断的串口
+ *
+ * 上一段DMA发送完成后释放其缓冲空间，再把下一段连续数据交给DMA。
+ */
+void Debug_TxService(UART_HandleTypeDef* huart)
+{
+#if DEBUG_TX_DMA_ENABLE
+    if (huart != g_debug_uart || huart->gState != HAL_UART_STATE_READY) {
+        return;  // 非调试串口，或DMA仍在发送
+    }
+
+    if (tx_inflight_ != 0) {
+        tx_ring_.consume(tx_inflight_);
+        tx_inflight_ = 0;
+    }
+
+    // 只发送到缓冲末尾，回绕部分在下一次完成中断里发送
+    uint32_t chunk;
+    const uint8_t* data = tx_ring_.readSpan(chunk);
+    if (data == nullptr) {
+        return;
+    }
+    if (HAL_UART_Transmit_DMA(huart, const_cast<uint8_t*>(data), (uint16_t)chunk) == HAL_OK) {
+        tx_inflight_ = (uint16_t)chunk;
+    }
+#else
+    (void)huart;
+#endif
+}
+
+/**
+ * @brief 等待缓冲中的数据发送完毕
+ * @param timeout_ms 最长等待时间
+ * @return true=已发送完，false=超时
+ */
+bool Debug_Flush(uint32_t timeout_ms)
+{
+#if DEBUG_TX_DMA_ENABLE
+    if (__get_PRIMASK() != 0U) {
+        return false;  // 关中断时DMA完成中断和SysTick都不会来
+    }
+    const uint32_t start = HAL_GetTick();
+    while (!tx_ring_.empty()) {
+        if (HAL_GetTick() - start >= timeout_ms) {
+            return false;
+        }
+        Debug_KickTx();
+    }
+#else
+    (void)timeout_ms;
+#endif
+    return true;
+}
+
+/**
+ * @brief 发送缓冲剩余空间
+ */
+uint32_t Debug_GetTxSpace(void)
+{
+#if DEBUG_TX_DMA_ENABLE
+    return tx_ring_.space();
+#else
+    return UINT32_MAX;
+#endif
+}
+
+/**
+ * @brief 缓冲满被丢弃的字节数（累计）
+ */
+uint32_t Debug_GetDroppedBytes(void)
+{
+#if DEBUG_TX_DMA_ENABLE
+    return tx_ring_.overflowCount();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief 复制最近写入的输出（含已发送的部分）
+ * @param dst 目标缓冲
+ * @param max 最多复制的字节数
+ * @return 实际复制的字节数（阻塞模式没有缓冲，恒为0）
+ *
+ * 不修改缓冲状态，可在故障处理中调用，用于保存崩溃前的日志。
+ */
+uint32_t Debug_CopyRecent(uint8_t* dst, uint32_t max)
+{
+#if DEBUG_TX_DMA_ENABLE
+    return tx_ring_.copyRecent(dst, max);
+#else
+    (void)dst;
+    (void)max;
+    return 0;
+#endif
+}
+
 /**
  * @brief 启用调试输出
  */
@@ -68,6 +220,8 @@ bool Debug_IsEnabled(void)
  */
 void Debug_SetUart(DebugUart_t uart)
 {
+    // 先把旧串口上排队的数据发完
+    Debug_Flush(DEBUG_UART_TIMEOUT);
     if (uart == DEBUG_UART_1) {
         g_debug_uart = &huart1;
     } else if (uart == DEBUG_UART_2) {
@@ -82,6 +236,7 @@ void Debug_SetUart(DebugUart_t uart)
 void Debug_SetUartHandle(UART_HandleTypeDef* huart)
 {
     if (huart != NULL) {
+        Debug_Flush(DEBUG_UART_TIMEOUT);
         g_debug_uart = huart;
     }
 }
@@ -106,15 +261,21 @@ void Debug_Printf(const char* format, ...)
         return;  // 调试模式未启用，直接返回
     }
     
-    char buffer[256];  // 缓冲区大小可根据需要调整
+    char buffer[DEBUG_BUFFER_SIZE];
     va_list args;
     
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    int len = vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
+    if (len <= 0) {
+        return;
+    }
+    if (len >= (int)sizeof(buffer)) {
+        len = sizeof(buffer) - 1;  // 截断
+    }
     
-    // 通过设置的调试串口发送
-    HAL_UART_Transmit(g_debug_uart, (uint8_t*)buffer, strlen(buffer), 1000);
+    // 放入发送缓冲（DEBUG_TX_DMA_ENABLE=0 时阻塞发送）
+    Debug_Write((const uint8_t*)buffer, (uint32_t)len);
 }
 
 /**
@@ -124,15 +285,21 @@ void Debug_Printf(const char* format, ...)
  */
 void Debug_Print_Always(const char* format, ...)
 {
-    char buffer[256];  // 缓冲区大小可根据需要调整
+    char buffer[DEBUG_BUFFER_SIZE];
     va_list args;
     
     va_start(args, format);
-    vsnprintf(buffer, sizeof(buffer), format, args);
+    int len = vsnprintf(buffer, sizeof(buffer), format, args);
     va_end(args);
+    if (len <= 0) {
+        return;
+    }
+    if (len >= (int)sizeof(buffer)) {
+        len = sizeof(buffer) - 1;  // 截断
+    }
     
-    // 通过设置的调试串口发送
-    HAL_UART_Transmit(g_debug_uart, (uint8_t*)buffer, strlen(buffer), 1000);
+    // 放入发送缓冲（DEBUG_TX_DMA_ENABLE=0 时阻塞发送）
+    Debug_Write((const uint8_t*)buffer, (uint32_t)len);
 }
 
 /**
@@ -155,7 +322,7 @@ int _write(int file, char *ptr, int len)
     }
     
     // 通过设置的调试串口发送数据
-    HAL_UART_Transmit(g_debug_uart, (uint8_t*)ptr, len, 1000);
+    Debug_Write((const uint8_t*)ptr, (uint32_t)len);
     
     return len;
 }
@@ -176,7 +343,8 @@ int fputc(int ch, FILE *f)
     }
     
     // 通过设置的调试串口发送单个字符
-    HAL_UART_Transmit(g_debug_uart, (uint8_t*)&ch, 1, 1000);
+    uint8_t byte = (uint8_t)ch;
+    Debug_Write(&byte, 1);
     
     return ch;
 }
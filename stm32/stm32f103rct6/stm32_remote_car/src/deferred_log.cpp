@@ -0,0 +1,76 @@
+/**
+ * @file    deferred_log.cpp
+ * @brief   延迟格式化二进制日志实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "deferred_log.hpp"
+
+#include <string.h>
+
+#include "crc.hpp"
+#include "debug.hpp"
+
+namespace deferred_log {
+
+namespace {
+uint32_t oversize_count = 0;
+}
+
+Writer::Writer(const char* format) : len_(HEADER), overflow_(false) {
+    const uint16_t id = static_cast<uint16_t>(reinterpret_cast<uintptr_t>(format));
+    buf_[0] = FRAME_SYNC;
+    buf_[1] = 0;
+    put(static_cast<uint8_t>(id & 0xFF));
+    put(static_cast<uint8_t>(id >> 8));
+}
+
+void Writer::putSigned64(int64_t value) {
+    uint64_t zz = (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    while (zz >= 0x80u) {
+        put(static_cast<uint8_t>(zz | 0x80u));
+        zz >>= 7;
+    }
+    put(static_cast<uint8_t>(zz));
+}
+
+void Writer::putFloat(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put(static_cast<uint8_t>(bits));
+    put(static_cast<uint8_t>(bits >> 8));
+    put(static_cast<uint8_t>(bits >> 16));
+    put(static_cast<uint8_t>(bits >> 24));
+}
+
+void Writer::putString(const char* str) {
+    if (str == nullptr) {
+        put(0);
+        return;
+    }
+    uint8_t n = 0;
+    while (n < MAX_STRING && str[n] != '\0') {
+        n++;
+    }
+    put(n);
+    for (uint8_t i = 0; i < n; i++) {
+        put(static_cast<uint8_t>(str[i]));
+    }
+}
+
+void Writer::finish() {
+    if (overflow_) {
+        oversize_count++;
+        return;
+    }
+    buf_[1] = static_cast<uint8_t>(len_ - HEADER);
+    buf_[len_] = crc::crc8(&buf_[1], len_ - 1u);
+    Debug_Write(buf_, len_ + 1u);
+}
+
+uint32_t getOversizeCount() {
+    return oversize_count;
+}
+
+}  // namespace deferred_log
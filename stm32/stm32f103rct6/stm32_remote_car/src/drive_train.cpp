@@ -13,6 +13,7 @@
  */
 
 #include "../include/drive_train.hpp"
+#include "../include/latency_probe.hpp"
 #include "stm32f1xx_hal.h"
 #include <algorithm>
 #include <cmath>
@@ -23,8 +24,6 @@ namespace {
     constexpr int MAX_SPEED = 100;
     constexpr int DEADBAND_THRESHOLD = 5;      // 忽略小于此值的输入
     constexpr float TURN_SENSITIVITY = 0.8f;   // 转向灵敏度 (0.0-1.0)
-    constexpr float SPOT_TURN_REDUCTION = 0.80f; // 原地转向速度降低系数（光滑地面也转不动时用更低值）
-    constexpr int MIN_SPOT_TURN_SPEED = 25;    // 原地转向最小有效速度
 }
 
 /**
@@ -57,7 +56,7 @@ void DriveTrain::init(Motor leftFront, Motor leftBack, Motor rightFront, Motor r
  * @param threshold 死区阈值
  * @return 滤波后的值（死区内返回0）
  */
-int DriveTrain::applyDeadband(int value, int threshold)
+int32_t DriveTrain::applyDeadband(int32_t value, int32_t threshold)
 {
     if (std::abs(value) < threshold) {
         return 0;
@@ -75,27 +74,37 @@ int DriveTrain::clampSpeed(int value)
     return std::max(MIN_SPEED, std::min(MAX_SPEED, value));
 }
 
+/**
+ * @brief 限制Q8速度到有效范围
+ * @param value 输入值（1/256 %）
+ * @return 限幅后的值
+ */
+int32_t DriveTrain::clampSpeedQ8(int32_t value)
+{
+    return fixed_math::clamp(value, MIN_SPEED * fixed_math::Q8_ONE, MAX_SPEED * fixed_math::Q8_ONE);
+}
+
 /**
  * @brief 当速度超出限制时进行归一化
- * @param leftSpeed 左侧速度（会被修改）
- * @param rightSpeed 右侧速度（会被修改）
+ * @param leftSpeed 左侧速度（Q8，会被修改）
+ * @param rightSpeed 右侧速度（Q8，会被修改）
  * 
- * 确保在保持速度比例的同时，将两个速度都控制在有效范围 [-100, 100] 内
+ * 确保在保持速度比例的同时，将两个速度都控制在有效范围 [-100%, 100%] 内
  */
-void DriveTrain::normalizeSpeed(int& leftSpeed, int& rightSpeed)
+void DriveTrain::normalizeSpeed(int32_t& leftSpeed, int32_t& rightSpeed)
 {
     // 找到最大绝对值
-    int maxAbsSpeed = std::max(std::abs(leftSpeed), std::abs(rightSpeed));
+    int32_t maxAbsSpeed = std::max(std::abs(leftSpeed), std::abs(rightSpeed));
+    const int32_t limit = MAX_SPEED * fixed_math::Q8_ONE;
     
     // 如果在限制范围内，无需归一化
-    if (maxAbsSpeed <= MAX_SPEED) {
+    if (maxAbsSpeed <= limit) {
         return;
     }
     
     // 按比例缩放两个速度
-    float scaleFactor = static_cast<float>(MAX_SPEED) / static_cast<float>(maxAbsSpeed);
-    leftSpeed = static_cast<int>(leftSpeed * scaleFactor);
-    rightSpeed = static_cast<int>(rightSpeed * scaleFactor);
+    leftSpeed = static_cast<int32_t>(static_cast<int64_t>(leftSpeed) * limit / maxAbsSpeed);
+    rightSpeed = static_cast<int32_t>(static_cast<int64_t>(rightSpeed) * limit / maxAbsSpeed);
 }
 
 /**
@@ -129,10 +138,13 @@ void DriveTrain::stop()
         return;
     }
     
-    leftFrontMotor_.stop();
-    leftBackMotor_.stop();
-    rightFrontMotor_.stop();
-    rightBackMotor_.stop();
+    leftFrontMotor_.stageStop();
+    leftBackMotor_.stageStop();
+    rightFrontMotor_.stageStop();
+    rightBackMotor_.stageStop();
+    commitMotors();
+    outputLeftQ8_ = 0;
+    outputRightQ8_ = 0;
     
     // 清零速度剖面
     motionStraight_.reset();
@@ -173,6 +185,19 @@ void DriveTrain::setTargetSpeed(int straightSpeed, int turnSpeed)
     motionTurn_.setTarget(clampSpeed(turnSpeed));
 }
 
+/**
+ * @brief 设置目标速度（Q8定点，1/256 %）
+ */
+void DriveTrain::setTargetSpeedQ8(int32_t straightQ8, int32_t turnQ8)
+{
+    if (!initialized_) {
+        return;
+    }
+
+    motionStraight_.setTargetQ8(clampSpeedQ8(straightQ8));
+    motionTurn_.setTargetQ8(clampSpeedQ8(turnQ8));
+}
+
 /**
  * @brief 更新速度轮廓（需在主循环中定期调用）
  * 
@@ -189,6 +214,8 @@ void DriveTrain::update()
     (void)motionStraight_.update(now);
     (void)motionTurn_.update(now);
     applySpeedToMotors();
+    LATENCY_ON_PROFILE(motionStraight_.getCurrentQ8() == motionStraight_.getTargetQ8() &&
+                       motionTurn_.getCurrentQ8() == motionTurn_.getTargetQ8());
 }
 
 /**
@@ -212,28 +239,41 @@ void DriveTrain::update()
  */
 void DriveTrain::applySpeedToMotors()
 {
-    // 从速度剖面读取当前速度并应用死区
-    int filteredStraight = applyDeadband(motionStraight_.getCurrent(), DEADBAND_THRESHOLD);
-    int filteredTurn = applyDeadband(motionTurn_.getCurrent(), DEADBAND_THRESHOLD);
+    // 从速度剖面读取当前速度（Q8，保留亚百分比精度）
+    mixToMotorsQ8(motionStraight_.getCurrentQ8(), motionTurn_.getCurrentQ8());
+}
+
+/**
+ * @brief 差速混合并输出到电机（Q8定点，update() 与 driveImmediate() 共用）
+ * @param straightQ8 直行速度（1/256 %）
+ * @param turnQ8 转向速度（1/256 %）
+ */
+void DriveTrain::mixToMotorsQ8(int32_t straightQ8, int32_t turnQ8)
+{
+    using fixed_math::Q8_ONE;
+
+    // 死区滤波
+    int32_t filteredStraight = applyDeadband(straightQ8, DEADBAND_THRESHOLD * Q8_ONE);
+    int32_t filteredTurn = applyDeadband(turnQ8, DEADBAND_THRESHOLD * Q8_ONE);
     
     // 应用转向灵敏度调整
-    // 使用可调灵敏度
-    // 先放大/翻转转向，再做小死区（1）
-    int adjustedTurn = static_cast<int>(filteredTurn * turn_sensitivity_);
-    if (std::abs(adjustedTurn) < 1) adjustedTurn = 0;
+    // 先放大/翻转转向，再做小死区（1%）
+    int32_t adjustedTurn = static_cast<int32_t>(filteredTurn * turn_sensitivity_);
+    if (std::abs(adjustedTurn) < Q8_ONE) adjustedTurn = 0;
     
     // 检测是否为原地转向（直行速度接近0）
-    bool isSpotTurn = (std::abs(filteredStraight) < 10);
+    bool isSpotTurn = (std::abs(filteredStraight) < 10 * Q8_ONE);
     
     // 差速转向混合算法
     // 左侧: 直行 + 转向 (turnSpeed > 0 时左转)
     // 右侧: 直行 - 转向
-    int leftSpeed = filteredStraight + adjustedTurn;
-    int rightSpeed = filteredStraight - adjustedTurn;
+    int32_t leftSpeed = filteredStraight + adjustedTurn;
+    int32_t rightSpeed = filteredStraight - adjustedTurn;
 
     // 前进时为避免单侧停转：限制转向，使两侧至少保留 min_forward_floor_ 的前进分量
-    if (min_forward_floor_ > 0 && filteredStraight > 0 && adjustedTurn != 0) {
-        int maxTurn = filteredStraight - min_forward_floor_;
+    const int32_t floorQ8 = min_forward_floor_ * Q8_ONE;
+    if (floorQ8 > 0 && filteredStraight > 0 && adjustedTurn != 0) {
+        int32_t maxTurn = filteredStraight - floorQ8;
         if (maxTurn < 0) maxTurn = 0;
         if (adjustedTurn > maxTurn) adjustedTurn = maxTurn;
         if (adjustedTurn < -maxTurn) adjustedTurn = -maxTurn;
@@ -242,22 +282,23 @@ void DriveTrain::applySpeedToMotors()
     }
     
     // 应用最小前进速度底线（仅在前进且存在转向时）
-    if (min_forward_floor_ > 0 && filteredStraight > 0 && adjustedTurn != 0) {
-        if (leftSpeed > 0 && leftSpeed < min_forward_floor_) leftSpeed = min_forward_floor_;
-        if (rightSpeed > 0 && rightSpeed < min_forward_floor_) rightSpeed = min_forward_floor_;
+    if (floorQ8 > 0 && filteredStraight > 0 && adjustedTurn != 0) {
+        if (leftSpeed > 0 && leftSpeed < floorQ8) leftSpeed = floorQ8;
+        if (rightSpeed > 0 && rightSpeed < floorQ8) rightSpeed = floorQ8;
     }
     
     // 原地转向时降低速度，避免堵转和空转
     if (isSpotTurn && adjustedTurn != 0) {
-        leftSpeed = static_cast<int>(leftSpeed * SPOT_TURN_REDUCTION);
-        rightSpeed = static_cast<int>(rightSpeed * SPOT_TURN_REDUCTION);
+        leftSpeed = static_cast<int32_t>(leftSpeed * spot_turn_reduction_);
+        rightSpeed = static_cast<int32_t>(rightSpeed * spot_turn_reduction_);
         
-        // 确保速度不会太低导致电机无法启动
-        if (leftSpeed != 0 && std::abs(leftSpeed) < MIN_SPOT_TURN_SPEED) {
-            leftSpeed = (leftSpeed > 0) ? MIN_SPOT_TURN_SPEED : -MIN_SPOT_TURN_SPEED;
+        // 确保速度不会太低导致车转不动（下限由 SpotTurnCalibration 按地面标定）
+        const int32_t minSpot = min_spot_turn_q8_;
+        if (leftSpeed != 0 && std::abs(leftSpeed) < minSpot) {
+            leftSpeed = (leftSpeed > 0) ? minSpot : -minSpot;
         }
-        if (rightSpeed != 0 && std::abs(rightSpeed) < MIN_SPOT_TURN_SPEED) {
-            rightSpeed = (rightSpeed > 0) ? MIN_SPOT_TURN_SPEED : -MIN_SPOT_TURN_SPEED;
+        if (rightSpeed != 0 && std::abs(rightSpeed) < minSpot) {
+            rightSpeed = (rightSpeed > 0) ? minSpot : -minSpot;
         }
     }
     
@@ -265,21 +306,73 @@ void DriveTrain::applySpeedToMotors()
     normalizeSpeed(leftSpeed, rightSpeed);
     
     // 限幅到绝对限制（安全检查）
-    leftSpeed = clampSpeed(leftSpeed);
-    rightSpeed = clampSpeed(rightSpeed);
-    
-    // 反转方向（修正前后反向问题）
-    leftSpeed = -leftSpeed;
-    rightSpeed = -rightSpeed;
+    leftSpeed = clampSpeedQ8(leftSpeed);
+    rightSpeed = clampSpeedQ8(rightSpeed);
     
-    // 应用到电机
+    outputWheelsQ8(leftSpeed, rightSpeed);
+}
+
+/**
+ * @brief 左右轮速度输出到四个电机（前进为正）
+ */
+void DriveTrain::outputWheelsQ8(int32_t leftSpeed, int32_t rightSpeed)
+{
+    outputLeftQ8_ = leftSpeed;
+    outputRightQ8_ = rightSpeed;
+
+    // 电源电压补偿：电池电压下降时等比放大，保持实际转速
+    if (supply_ != nullptr) {
+        supply_->compensate(leftSpeed, rightSpeed);
+    }
+
+    // 四轮滑移转向：转弯时前后轮按到ICR的距离给速度（blend为0时同侧相同）
+    const skid_steer::WheelSpeeds wheels = skid_steer::mix(skidSteer_, leftSpeed, rightSpeed);
+
+    // 应用到电机，反转方向（修正前后反向问题）
     // 左侧电机（正速度 = 前进）
-    leftFrontMotor_.setSpeed(leftSpeed);
-    leftBackMotor_.setSpeed(leftSpeed);
+    leftFrontMotor_.stageSpeedQ8(-wheels.left_front);
+    leftBackMotor_.stageSpeedQ8(-wheels.left_rear);
     
     // 右侧电机（需要反向，因为电机安装方向相反）
-    rightFrontMotor_.setSpeed(-rightSpeed);
-    rightBackMotor_.setSpeed(-rightSpeed);
+    rightFrontMotor_.stageSpeedQ8(wheels.right_front);
+    rightBackMotor_.stageSpeedQ8(wheels.right_rear);
+    commitMotors();
+}
+
+/**
+ * @brief 直接输出左右轮速度（不经混合与速度剖面）
+ * @param leftQ8 左轮速度（1/256 %，前进为正）
+ * @param rightQ8 右轮速度（1/256 %，前进为正）
+ *
+ * 同时把速度剖面同步到等效的直行/转向速度，之后切回 setTargetSpeed()
+ * 时从当前速度平滑过渡（无扰切换）。
+ */
+void DriveTrain::driveWheelsQ8(int32_t leftQ8, int32_t rightQ8)
+{
+    if (!initialized_) {
+        return;
+    }
+
+    leftQ8 = clampSpeedQ8(leftQ8);
+    rightQ8 = clampSpeedQ8(rightQ8);
+    outputWheelsQ8(leftQ8, rightQ8);
+
+    // 混合的逆运算：left = s + t·k，right = s - t·k
+    int32_t straight = (leftQ8 + rightQ8) / 2;
+    int32_t turn = 0;
+    if (turn_sensitivity_ > 0.0f) {
+        turn = static_cast<int32_t>((leftQ8 - rightQ8) / (2.0f * turn_sensitivity_));
+    }
+    motionStraight_.sync(straight);
+    motionTurn_.sync(turn);
+}
+
+/**
+ * @brief 四个电机的脉宽一次性写入，在同一个PWM更新事件生效
+ */
+void DriveTrain::commitMotors()
+{
+    Motor::commit(leftFrontMotor_, leftBackMotor_, rightFrontMotor_, rightBackMotor_);
 }
 
 /**
@@ -295,8 +388,21 @@ void DriveTrain::setAcceleration(int acceleration, int deceleration, int reverse
 }
 
 /**
- * @brief 设置速度更新间隔
- * @param intervalMs 更新间隔（毫秒）
+ * @brief 设置S曲线加速度与加加速度限制
+ * @param acceleration 加速度（%/s）
+ * @param deceleration 减速度（%/s）
+ * @param reverseDeceleration 反向刹车减速度（%/s）
+ * @param jerk 加加速度（%/s²）
+ */
+void DriveTrain::setMotionLimits(int acceleration, int deceleration, int reverseDeceleration, int jerk)
+{
+    motionStraight_.setLimits(acceleration, deceleration, reverseDeceleration, jerk);
+    motionTurn_.setLimits(acceleration, deceleration, reverseDeceleration, jerk);
+}
+
+/**
+ * @brief 设置速度最小更新间隔
+ * @param intervalMs 最小更新间隔（毫秒）
  */
 void DriveTrain::setUpdateInterval(uint32_t intervalMs)
 {
@@ -308,58 +414,29 @@ void DriveTrain::setUpdateInterval(uint32_t intervalMs)
  * @brief 立即驱动（无梯形速度轮廓）
  */
 void DriveTrain::driveImmediate(int straightSpeed, int turnSpeed)
+{
+    driveImmediateQ8(straightSpeed * fixed_math::Q8_ONE, turnSpeed * fixed_math::Q8_ONE);
+}
+
+/**
+ * @brief 立即驱动（浮点速度，不丢失小数部分）
+ */
+void DriveTrain::driveImmediate(float straightSpeed, float turnSpeed)
+{
+    driveImmediateQ8(fixed_math::toQ8(straightSpeed), fixed_math::toQ8(turnSpeed));
+}
+
+/**
+ * @brief 立即驱动（Q8定点速度）
+ */
+void DriveTrain::driveImmediateQ8(int32_t straightQ8, int32_t turnQ8)
 {
     if (!initialized_) {
         return;
     }
 
     // 直接使用输入值，套用同样的混合与保护逻辑
-    int filteredStraight = applyDeadband(clampSpeed(straightSpeed), DEADBAND_THRESHOLD);
-    int filteredTurn = applyDeadband(clampSpeed(turnSpeed), DEADBAND_THRESHOLD);
-
-    int adjustedTurn = static_cast<int>(filteredTurn * turn_sensitivity_);
-    if (std::abs(adjustedTurn) < 1) adjustedTurn = 0;
-    bool isSpotTurn = (std::abs(filteredStraight) < 10);
-
-    int leftSpeed = filteredStraight + adjustedTurn;
-    int rightSpeed = filteredStraight - adjustedTurn;
-
-    if (min_forward_floor_ > 0 && filteredStraight > 0 && adjustedTurn != 0) {
-        int maxTurn = filteredStraight - min_forward_floor_;
-        if (maxTurn < 0) maxTurn = 0;
-        if (adjustedTurn > maxTurn) adjustedTurn = maxTurn;
-        if (adjustedTurn < -maxTurn) adjustedTurn = -maxTurn;
-        leftSpeed  = filteredStraight + adjustedTurn;
-        rightSpeed = filteredStraight - adjustedTurn;
-    }
-    
-    if (min_forward_floor_ > 0 && filteredStraight > 0 && adjustedTurn != 0) {
-        if (leftSpeed > 0 && leftSpeed < min_forward_floor_) leftSpeed = min_forward_floor_;
-        if (rightSpeed > 0 && rightSpeed < min_forward_floor_) rightSpeed = min_forward_floor_;
-    }
-
-    if (isSpotTurn && adjustedTurn != 0) {
-        leftSpeed = static_cast<int>(leftSpeed * SPOT_TURN_REDUCTION);
-        rightSpeed = static_cast<int>(rightSpeed * SPOT_TURN_REDUCTION);
-        if (leftSpeed != 0 && std::abs(leftSpeed) < MIN_SPOT_TURN_SPEED) {
-            leftSpeed = (leftSpeed > 0) ? MIN_SPOT_TURN_SPEED : -MIN_SPOT_TURN_SPEED;
-        }
-        if (rightSpeed != 0 && std::abs(rightSpeed) < MIN_SPOT_TURN_SPEED) {
-            rightSpeed = (rightSpeed > 0) ? MIN_SPOT_TURN_SPEED : -MIN_SPOT_TURN_SPEED;
-        }
-    }
-
-    normalizeSpeed(leftSpeed, rightSpeed);
-    leftSpeed = clampSpeed(leftSpeed);
-    rightSpeed = clampSpeed(rightSpeed);
-
-    // 反向修正与实际输出
-    leftSpeed = -leftSpeed;
-    rightSpeed = -rightSpeed;
-    leftFrontMotor_.setSpeed(leftSpeed);
-    leftBackMotor_.setSpeed(leftSpeed);
-    rightFrontMotor_.setSpeed(-rightSpeed);
-    rightBackMotor_.setSpeed(-rightSpeed);
+    mixToMotorsQ8(clampSpeedQ8(straightQ8), clampSpeedQ8(turnQ8));
 }
 
 // === 新增：参数设置接口 ===
@@ -377,3 +454,31 @@ void DriveTrain::setMinForwardFloor(int floor)
     if (floor > MAX_SPEED) floor = MAX_SPEED;
     min_forward_floor_ = floor;
 }
+
+/**
+ * @brief 设置四轮滑移转向几何
+ */
+void DriveTrain::setSkidSteerGeometry(const skid_steer::Geometry& geometry)
+{
+    skidSteer_ = geometry;
+}
+
+/**
+ * @brief 设置原地转向速度降低系数
+ */
+void DriveTrain::setSpotTurnReduction(float reduction)
+{
+    if (reduction < 0.1f) reduction = 0.1f;
+    if (reduction > 1.0f) reduction = 1.0f;
+    spot_turn_reduction_ = reduction;
+}
+
+/**
+ * @brief 设置原地转向最小轮速
+ *
+ * 标定值是刚好转不动的轮速，这里留出 SPOT_TURN_MARGIN 余量，保证低速转向指令也能转起来
+ */
+void DriveTrain::setMinSpotTurnSpeedQ8(int32_t minSpeedQ8)
+{
+    min_spot_turn_q8_ = clampSpeedQ8(std::max<int32_t>(0, minSpeedQ8) + SPOT_TURN_MARGIN * fixed_math::Q8_ONE);
+}
@@ -181,10 +181,23 @@ void E49_Wireless::setDataReceivedCallback(std::function<void(uint8_t)> callback
  */
 void E49_Wireless::onDataReceived(uint8_t data)
 {
-    // 如果设置了回调函数，则调用
-    if(dataCallback_)
+    // 中断里只入队，队列满时丢弃（计入溢出计数）
+    rxRing_.push(data);
+}
+
+/**
+ * @brief 处理接收队列（主循环中调用）
+ */
+void E49_Wireless::poll()
+{
+    uint8_t data;
+    while(rxRing_.pop(data))
     {
-        dataCallback_(data);
+        // 如果设置了回调函数，则调用
+        if(dataCallback_)
+        {
+            dataCallback_(data);
+        }
     }
 }
 
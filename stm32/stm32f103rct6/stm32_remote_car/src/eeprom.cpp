@@ -6,6 +6,7 @@
  */
 
 #include "eeprom.hpp"
+#include "crc.hpp"
 
 /**
  * @brief 初始化EEPROM
@@ -236,19 +237,6 @@ bool EEPROM::isDeviceReady() {
  * @note 使用CRC-8-CCITT多项式: 0x07
  */
 uint8_t EEPROM::calculateCRC(const uint8_t* data, uint16_t length) {
-    uint8_t crc = 0x00;
-    
-    for (uint16_t i = 0; i < length; i++) {
-        crc ^= data[i];
-        
-        for (uint8_t bit = 0; bit < 8; bit++) {
-            if (crc & 0x80) {
-                crc = (crc << 1) ^ 0x07;
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-    
-    return crc;
+    // CRC-8（多项式0x07，初值0），与串口帧共用查表实现
+    return crc::crc8(data, length);
 }
@@ -0,0 +1,46 @@
+/**
+ * @file    fixed_math.cpp
+ * @brief   定点数学工具实现（Q15正弦表）
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "fixed_math.hpp"
+
+namespace {
+
+/// sin(i * 90° / 64)，Q15，i = 0..64（表放在Flash中，所有模块共用）
+const int16_t SINE_QUARTER[65] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+    6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+}  // namespace
+
+namespace fixed_math {
+
+int16_t sinQ15(uint16_t angle) {
+    // 高2位：象限；接下来6位：表索引；低8位：插值系数
+    uint8_t quadrant = angle >> 14;
+    uint16_t phase = angle & 0x3FFF;
+    if (quadrant & 1) {
+        phase = 0x4000 - phase;  // 第2、4象限镜像
+    }
+
+    uint8_t index = phase >> 8;
+    int32_t frac = phase & 0xFF;
+    int32_t value = SINE_QUARTER[index];
+    if (index < 64) {
+        value += ((SINE_QUARTER[index + 1] - value) * frac) >> 8;
+    }
+    return static_cast<int16_t>((quadrant & 2) ? -value : value);
+}
+
+}  // namespace fixed_math
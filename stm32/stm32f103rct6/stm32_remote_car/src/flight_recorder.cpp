@@ -0,0 +1,254 @@
+/**
+ * @file    flight_recorder.cpp
+ * @brief   控制事件飞行记录仪实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "flight_recorder.hpp"
+
+#if FLIGHT_RECORDER_ENABLE
+
+#include "debug.hpp"
+#include "stm32f1xx_hal.h"
+
+namespace {
+
+static_assert((FLIGHT_RECORDER_EVENTS & (FLIGHT_RECORDER_EVENTS - 1)) == 0,
+              "FLIGHT_RECORDER_EVENTS必须是2的幂");
+constexpr uint32_t EVENT_MASK = FLIGHT_RECORDER_EVENTS - 1;
+
+struct Event {
+    uint32_t cycles;   // DWT->CYCCNT
+    uint8_t type;
+    uint8_t a;
+    int16_t b;
+};
+static_assert(sizeof(Event) == 8, "Event应为8字节");
+
+Event events[FLIGHT_RECORDER_EVENTS];
+
+volatile uint32_t head = 0;         // 已记录的总条数（写入位置 = head & EVENT_MASK）
+volatile bool frozen = false;
+volatile bool paused = false;       // dump() 期间暂停记录
+bool triggered = false;
+uint32_t post_events = FLIGHT_RECORDER_EVENTS / 4;
+uint32_t remaining = 0;             // 触发后还要记录的条数
+uint32_t trigger_index = 0;         // TRIGGER 事件的序号（head 计数）
+uint32_t trigger_tick = 0;
+uint8_t trigger_reason = static_cast<uint8_t>(FrTrigger::NONE);
+
+// 丢线时长触发：由 STATE 事件维护，update() 中判断
+uint16_t line_lost_ms = FLIGHT_RECORDER_LINE_LOST_MS;
+volatile bool line_lost = false;
+volatile uint32_t lost_since = 0;
+
+const char* const EVENT_NAMES[] = {
+    "state", "recovery", "source", "command", "param",
+    "deadline", "overflow", "button", "trigger", "mark",
+};
+static_assert(sizeof(EVENT_NAMES) / sizeof(EVENT_NAMES[0]) == static_cast<uint8_t>(FrEvent::COUNT),
+              "EVENT_NAMES与FrEvent不一致");
+
+const char* const TRIGGER_NAMES[] = {"none", "line_lost", "button", "manual"};
+static_assert(sizeof(TRIGGER_NAMES) / sizeof(TRIGGER_NAMES[0]) == static_cast<uint8_t>(FrTrigger::COUNT),
+              "TRIGGER_NAMES与FrTrigger不一致");
+
+// 分批导出：dump() 只记下窗口，之后每次 update() 在发送缓冲有空间时输出一行
+constexpr uint32_t DUMP_LINE_MAX = 64;   // 一行输出的最大长度
+bool dumping = false;
+bool rearm_after_dump = false;          // 按钮导出完成后重新开始记录
+bool dump_header = false;               // 还没输出 FLIGHT BEGIN
+uint32_t dump_begin = 0;
+uint32_t dump_end = 0;
+uint32_t dump_next = 0;                 // 下一条要输出的事件（head 计数）
+int64_t dump_ref_cycles = 0;            // 时间零点相对窗口第一条的周期数
+int64_t dump_t_cycles = 0;              // 当前事件相对窗口第一条的周期数
+
+/**
+ * @brief 写入一条事件（调用者已关中断）
+ */
+inline void append(FrEvent type, uint8_t a, int16_t b) {
+    const uint32_t now = DWT->CYCCNT;
+    Event& e = events[head & EVENT_MASK];
+    e.cycles = now;
+    e.type = static_cast<uint8_t>(type);
+    e.a = a;
+    e.b = b;
+    head = head + 1;
+
+    if (type == FrEvent::STATE) {
+        if (a == FR_STATE_LINE_LOST) {
+            if (!line_lost) {
+                line_lost = true;
+                lost_since = now;
+            }
+        } else {
+            line_lost = false;
+        }
+    }
+}
+
+/**
+ * @brief 输出导出内容的下一行（发送缓冲空间不足时等下次）
+ * @return true=已全部输出
+ */
+bool dumpStep() {
+    if (Debug_GetTxSpace() < DUMP_LINE_MAX) {
+        return false;
+    }
+
+    if (dump_header) {
+        dump_header = false;
+        Debug_Print_Always("\r\nFLIGHT BEGIN events=%lu trigger=%s tick=%lu post=%lu frozen=%d\r\n",
+                           (unsigned long)(dump_end - dump_begin), TRIGGER_NAMES[trigger_reason],
+                           (unsigned long)trigger_tick, (unsigned long)post_events, frozen ? 1 : 0);
+        return false;
+    }
+
+    if (dump_next == dump_end) {
+        Debug_Print_Always("FLIGHT END\r\n");
+        return true;
+    }
+
+    const uint32_t i = dump_next++;
+    const Event& e = events[i & EVENT_MASK];
+    if (i != dump_begin) {
+        dump_t_cycles += static_cast<uint32_t>(e.cycles - events[(i - 1) & EVENT_MASK].cycles);
+    }
+    const uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    const long t_us = static_cast<long>((dump_t_cycles - dump_ref_cycles) / static_cast<int64_t>(cycles_per_us));
+    const char* name = e.type < static_cast<uint8_t>(FrEvent::COUNT) ? EVENT_NAMES[e.type] : "?";
+    Debug_Print_Always("%10ld us  %-10s a=%u b=%d\r\n", t_us, name, e.a, e.b);
+    return false;
+}
+
+}  // namespace
+
+namespace FlightRecorder {
+
+void init(uint16_t post) {
+    // 与 CycleBudget 共用DWT，这里只使能、不清零计数器
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    post_events = post < FLIGHT_RECORDER_EVENTS ? post : FLIGHT_RECORDER_EVENTS - 1;
+    rearm();
+}
+
+void record(FrEvent type, uint8_t a, int16_t b) {
+    if (frozen || paused) {
+        return;
+    }
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!frozen) {
+        append(type, a, b);
+        if (triggered && --remaining == 0) {
+            frozen = true;
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+void trigger(FrTrigger reason, int16_t arg) {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!triggered) {
+        trigger_index = head;
+        trigger_tick = HAL_GetTick();
+        trigger_reason = static_cast<uint8_t>(reason);
+        append(FrEvent::TRIGGER, static_cast<uint8_t>(reason), arg);
+        triggered = true;
+        remaining = post_events;
+        frozen = (remaining == 0);
+    }
+    __set_PRIMASK(primask);
+}
+
+void update() {
+    if (dumping) {
+        if (dumpStep()) {
+            dumping = false;
+            paused = false;
+            if (rearm_after_dump) {
+                rearm_after_dump = false;
+                rearm();
+            }
+        }
+        return;
+    }
+    if (triggered || !line_lost || line_lost_ms == 0) {
+        return;
+    }
+    const uint32_t lost_ms = (DWT->CYCCNT - lost_since) / (SystemCoreClock / 1000u);
+    if (lost_ms >= line_lost_ms) {
+        trigger(FrTrigger::LINE_LOST, static_cast<int16_t>(line_lost_ms));
+    }
+}
+
+void setLineLostTrigger(uint16_t ms) {
+    line_lost_ms = ms;
+}
+
+void onButton() {
+    if (dumping) {
+        return;
+    } else if (frozen) {
+        rearm_after_dump = true;
+        dump();
+    } else {
+        record(FrEvent::BUTTON, 1, 0);
+        trigger(FrTrigger::BUTTON);
+    }
+}
+
+bool isFrozen() {
+    return frozen;
+}
+
+void dump() {
+    if (dumping) {
+        return;
+    }
+    paused = true;
+
+    const uint32_t end = head;
+    const uint32_t count = end < FLIGHT_RECORDER_EVENTS ? end : FLIGHT_RECORDER_EVENTS;
+    dump_begin = end - count;
+    dump_end = end;
+    dump_next = dump_begin;
+    dump_header = true;
+    // 时间零点：触发点（仍在窗口内时），否则为最新一条
+    const uint32_t ref = (triggered && trigger_index >= dump_begin) ? trigger_index : end - 1;
+
+    // 相邻事件的周期差逐条累加，窗口跨度超过计数器回绕周期（72MHz时约59秒）也不会错
+    dump_ref_cycles = 0;
+    for (uint32_t i = dump_begin + 1; i <= ref && count > 0; i++) {
+        dump_ref_cycles += static_cast<uint32_t>(events[i & EVENT_MASK].cycles - events[(i - 1) & EVENT_MASK].cycles);
+    }
+    dump_t_cycles = 0;
+    dumping = true;
+}
+
+bool isDumping() {
+    return dumping;
+}
+
+void rearm() {
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    head = 0;
+    triggered = false;
+    remaining = 0;
+    trigger_index = 0;
+    trigger_tick = 0;
+    trigger_reason = static_cast<uint8_t>(FrTrigger::NONE);
+    lost_since = DWT->CYCCNT;  // 仍在丢线时从现在重新计时，避免重新开始后立即触发
+    frozen = false;
+    __set_PRIMASK(primask);
+}
+
+}  // namespace FlightRecorder
+
+#endif  // FLIGHT_RECORDER_ENABLE
@@ -0,0 +1,143 @@
+/**
+ * @file    latency_probe.cpp
+ * @brief   指令端到端延迟探针实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "latency_probe.hpp"
+
+#if LATENCY_PROBE_ENABLE
+
+#include "tim.h"
+
+namespace {
+
+enum class Stage : uint8_t {
+    IDLE,        // 未跟踪
+    PARSED,      // 已解析，等待提交给仲裁器
+    SUBMITTED,   // 已提交，等待仲裁器选中
+    ACCEPTED,    // 已选中，等待CCR写入
+    COMMITTED,   // 已写入CCR，等待速度剖面到位
+    DONE,        // 全部阶段完成，等待 poll()
+};
+
+Stage stage = Stage::IDLE;
+uint32_t start_tick;
+uint32_t sender;
+uint8_t source;
+uint32_t rx_cyc;
+uint32_t parse_cyc;
+uint32_t accept_cyc;
+uint32_t ccr_cyc;
+uint32_t edge_cyc;
+uint32_t settle_cyc;
+bool accepted;
+bool committed;
+bool settled;
+
+uint16_t toUs(uint32_t cycles, bool reached) {
+    if (!reached) {
+        return LATENCY_MISSING;
+    }
+    const uint32_t us = (cycles - rx_cyc) / (SystemCoreClock / 1000000u);
+    return us < LATENCY_MISSING ? static_cast<uint16_t>(us) : LATENCY_MISSING - 1;
+}
+
+}  // namespace
+
+namespace LatencyProbe {
+
+void init() {
+    // 与 CycleBudget / FlightRecorder 共用DWT，这里只使能、不清零计数器
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    stage = Stage::IDLE;
+}
+
+uint32_t nowUs() {
+    uint32_t ms;
+    uint32_t val;
+    do {
+        ms = HAL_GetTick();
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick());  // 读取期间跨过毫秒边界时重读
+    const uint32_t load = SysTick->LOAD + 1u;
+    return ms * 1000u + ((load - 1u - val) * 1000u) / load;
+}
+
+bool begin(uint32_t sender_ts, uint32_t rx_cycles) {
+    if (stage != Stage::IDLE) {
+        return false;
+    }
+    parse_cyc = DWT->CYCCNT;
+    rx_cyc = rx_cycles;
+    sender = sender_ts;
+    start_tick = HAL_GetTick();
+    accepted = committed = settled = false;
+    stage = Stage::PARSED;
+    return true;
+}
+
+void onSubmit(uint8_t src) {
+    if (stage == Stage::PARSED) {
+        source = src;
+        stage = Stage::SUBMITTED;
+    }
+}
+
+void onArbiter(uint8_t winner) {
+    if (stage == Stage::SUBMITTED && winner == source) {
+        accept_cyc = DWT->CYCCNT;
+        accepted = true;
+        stage = Stage::ACCEPTED;
+    }
+}
+
+void onPwmCommit(TIM_HandleTypeDef* htim) {
+    // PARSED：RemoteControl 未接仲裁器，解析时已直接设定目标
+    if (stage != Stage::ACCEPTED && stage != Stage::PARSED) {
+        return;
+    }
+    ccr_cyc = DWT->CYCCNT;
+    TIM_PWM_Latency latency;
+    TIM_PWM_GetLatency(htim, &latency);
+    edge_cyc = ccr_cyc + latency.last_us * (SystemCoreClock / 1000000u);
+    committed = true;
+    stage = Stage::COMMITTED;
+}
+
+void onProfile(bool at_target) {
+    if (stage == Stage::COMMITTED && at_target) {
+        settle_cyc = DWT->CYCCNT;
+        settled = true;
+        stage = Stage::DONE;
+    }
+}
+
+bool poll(LatencyResult& out) {
+    if (stage == Stage::IDLE) {
+        return false;
+    }
+    if (stage != Stage::DONE && HAL_GetTick() - start_tick < LATENCY_PROBE_TIMEOUT_MS) {
+        return false;
+    }
+
+    // 以当前时刻为基准把DWT计数换算成本机微秒时间
+    const uint32_t now_cyc = DWT->CYCCNT;
+    const uint32_t now_us = nowUs();
+    out.sender_ts = sender;
+    out.rx_us = now_us - (now_cyc - rx_cyc) / (SystemCoreClock / 1000000u);
+    out.parse_us = toUs(parse_cyc, true);
+    out.accept_us = toUs(accept_cyc, accepted);
+    out.ccr_us = toUs(ccr_cyc, committed);
+    out.edge_us = toUs(edge_cyc, committed);
+    out.settle_ms = settled ? static_cast<uint16_t>((settle_cyc - rx_cyc) / (SystemCoreClock / 1000u))
+                            : LATENCY_MISSING;
+    stage = Stage::IDLE;
+    return true;
+}
+
+}  // namespace LatencyProbe
+
+#endif  // LATENCY_PROBE_ENABLE
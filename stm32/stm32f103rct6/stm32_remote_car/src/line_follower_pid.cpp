@@ -6,10 +6,16 @@
  */
 
 #include "line_follower_pid.hpp"
+#include "cycle_budget.hpp"
 #include "debug.hpp"
+#include "flight_recorder.hpp"
+#include "motion_arbiter.hpp"
 #include <stdio.h>
 #include <math.h>
 
+static_assert(static_cast<uint8_t>(LineFollowerPID::State::LINE_LOST) == FR_STATE_LINE_LOST,
+              "FR_STATE_LINE_LOST与LineFollowerPID::State不一致");
+
 /**
  * @brief 构造函数
  */
@@ -50,7 +56,7 @@ LineFollowerPID::LineFollowerPID(LineSensor& sensor,
     // 配置PID控制器 - 输出限制将动态设置（在setBaseSpeed中）
     pid_.setSampleTime(0.01f);  // 10ms采样时间（与控制周期一致）
     pid_.setAntiWindup(true);   // 启用积分抗饱和
-    pid_.setDerivativeFilter(0.6f);  // 降低D项高频跟随，减少边缘符号抖动
+    // D项使用跟踪器给出的位置变化率，不再需要微分滤波
 
     // 初始化动态PID输出限制
     updatePIDOutputLimits();
@@ -70,9 +76,11 @@ void LineFollowerPID::init() {
     pid_output_ = 0.0f;
     left_speed_ = 0;
     right_speed_ = 0;
+    last_differential_ = 0.0f;
+    tracker_.reset();
     last_update_time_ = HAL_GetTick();
     
-    Debug_Printf("[LineFollower] 初始化完成\r\n");
+    LOG_I(LINE, "[LineFollower] 初始化完成\r\n");
 }
 
 /**
@@ -80,10 +88,14 @@ void LineFollowerPID::init() {
  */
 void LineFollowerPID::start() {
     state_ = State::RUNNING;
+    FR_RECORD(FrEvent::STATE, state_, 0);
     pid_.reset();  // 重置PID状态
+    post_chain_.reset();
     last_position_ = 0.0f;
+    last_differential_ = 0.0f;
+    tracker_.reset();
     last_update_time_ = HAL_GetTick();
-    Debug_Printf("[LineFollower] 启动巡线\r\n");
+    LOG_I(LINE, "[LineFollower] 启动巡线\r\n");
 }
 
 /**
@@ -91,17 +103,24 @@ void LineFollowerPID::start() {
  */
 void LineFollowerPID::stop() {
     state_ = State::STOPPED;
+    FR_RECORD(FrEvent::STATE, state_, last_position_);
     
-    // 停止所有电机
-    motor_lf_.stop();
-    motor_lb_.stop();
-    motor_rf_.stop();
-    motor_rb_.stop();
+    // 停止所有电机（经仲裁器时撤销租期，由其他指令源或减速停车接管）
+    if (output_sink_ != nullptr) {
+        output_sink_->release(MotionSource::LINE_FOLLOWER);
+    } else {
+        motor_lf_.stageStop();
+        motor_lb_.stageStop();
+        motor_rf_.stageStop();
+        motor_rb_.stageStop();
+        Motor::commit(motor_lf_, motor_lb_, motor_rf_, motor_rb_);
+    }
     
     left_speed_ = 0;
     right_speed_ = 0;
+    last_differential_ = 0.0f;
     
-    Debug_Printf("[LineFollower] 停止巡线\r\n");
+    LOG_I(LINE, "[LineFollower] 停止巡线\r\n");
 }
 
 /**
@@ -111,6 +130,8 @@ void LineFollowerPID::update() {
     if (state_ == State::STOPPED) {
         return;
     }
+
+    CYCLE_BUDGET_SCOPE(BudgetStage::TICK);
     
     // 计算时间间隔
     uint32_t current_time = HAL_GetTick();
@@ -123,6 +144,7 @@ void LineFollowerPID::update() {
 
     // 传感器预自适应：在采样前根据上次位置调整滤波和采样次数以提升响应
     {
+        CYCLE_BUDGET_SCOPE(BudgetStage::SENSOR_CFG);
         float prev_ratio = fabsf(last_position_) / 1000.0f; // [0,1]
         if (prev_ratio > 1.0f) prev_ratio = 1.0f;
         float alpha = 0.6f + 0.25f * prev_ratio; // 0.6~0.85，避免过快导致噪声放大
@@ -162,7 +184,7 @@ void LineFollowerPID::update() {
             if (orientation_frames_ >= 5) {
                 if (orientation_mismatch_ >= 3) {
                     invert_position_ = !invert_position_;
-                    Debug_Printf("[LineFollower] 自动方向校正: invert_position=%d\r\n", invert_position_);
+                    LOG_D(LINE, "[LineFollower] 自动方向校正: invert_position=%d\r\n", invert_position_);
                 }
                 orientation_confirmed_ = true;
             }
@@ -173,6 +195,9 @@ void LineFollowerPID::update() {
         line_position = -line_position;
     }
 
+    // 状态估计：以上一帧指令差速作为过程输入进行预测
+    tracker_.predict(dt, last_differential_);
+
     // 检查是否丢线（使用isnan判断）或位置异常
     bool position_invalid = isnan(line_position) ||
                            fabs(line_position) > 1000.0f;
@@ -184,6 +209,7 @@ void LineFollowerPID::update() {
     if (count_on < line_lost_threshold_ || count_on == 8) lost_by_count = true;
 
     if (position_invalid || lost_by_count) {
+        const bool just_lost = (state_ != State::LINE_LOST);
         state_ = State::LINE_LOST;
 
         // 丢线处理：使用上次位置继续，但如果上次位置也异常则归零
@@ -194,106 +220,78 @@ void LineFollowerPID::update() {
         line_position = last_position_;
 
         // 降低速度（保持一定巡线能力，同时避免误判激进转向）
-        left_speed_ = static_cast<int>(base_speed_ * 0.6f);
-        right_speed_ = static_cast<int>(base_speed_ * 0.6f);
+        left_speed_ = base_speed_ * 0.6f;
+        right_speed_ = base_speed_ * 0.6f;
+
+        if (just_lost) {
+            FR_RECORD(FrEvent::STATE, state_, last_position_);
+            FR_RECORD(FrEvent::RECOVERY, 0, left_speed_);
+        }
 
         if (debug_enabled_) {
-            Debug_Printf("[LineFollower] 丢线! 使用上次位置: %d\r\n", (int)(last_position_ * 1000.0f));
+            LOG_D(LINE, "[LineFollower] 丢线! 使用上次位置: %d\r\n", (int)(last_position_ * 1000.0f));
         }
     } else {
+        // 丢线恢复后从新测量值重新开始估计
+        if (state_ == State::LINE_LOST) {
+            tracker_.reset(line_position);
+            FR_RECORD(FrEvent::STATE, State::RUNNING, line_position);
+            FR_RECORD(FrEvent::RECOVERY, 1, line_position);
+        }
         state_ = State::RUNNING;
 
+        CYCLE_BUDGET_SCOPE(BudgetStage::PID);
+
+        // 量测更新（探头间隙造成的大跳变会被门限拒绝）
+        tracker_.correct(line_position);
+        float filtered_position = tracker_.getPosition();
+
         // 只保存有效位置
-        last_position_ = line_position;
+        last_position_ = filtered_position;
         
         // 误差 = 目标位置(0) - 当前位置
-        error_ = 0.0f - line_position;
+        error_ = 0.0f - filtered_position;
         
         // PID计算速度调整（输出范围已根据baseSpeed动态限制）
-        pid_output_ = pid_.compute(0.0f, line_position, dt);
+        // P/I使用滤波后位置，D使用估计的位置变化率，避免差分放大量化噪声
+        pid_output_ = pid_.compute(0.0f, filtered_position, tracker_.getRate(), dt);
 
         // 自适应传感器滤波：误差越大，滤波越弱（提升响应速度）
         // 运行中不再重复调整采样次数，仅保持采样前的α设置
 
-        // 简化的非线性映射：减少复杂层次，提高响应性
-        float abs_output = fabs(pid_output_);
-        float max_output = base_speed_ * pid_output_ratio_;  // 最大PID输出范围
-
-        // 直接使用PID输出，避免多层衰减
-        float adjusted_output = pid_output_;
-
-        // 限制在最大范围内，避免过度调整
-        if (abs_output > max_output) {
-            adjusted_output = (pid_output_ > 0) ? max_output : -max_output;
-        }
-
-        // 基于百分比的速度计算
-        float speed_adjustment_ratio = adjusted_output / max_output;  // 归一化到[-1, 1]
-        // 防抖门限+滞回（使用方向滞回决定符号，避免历史输出符号误导）
-        const float dead_low = 0.06f;   // 低阈值：小于此认为0
-        const float dead_high = 0.10f;  // 高阈值：大于此才认为非0
-        float mag = fabsf(speed_adjustment_ratio);
-        if (mag < dead_low) {
-            speed_adjustment_ratio = 0.0f;
-        } else if (mag < dead_high) {
-            speed_adjustment_ratio = (speed_adjustment_ratio >= 0.0f ? 1.0f : -1.0f) * dead_high;
-        }
-
-        // 自适应差速幅度与最小速度：偏差越大，允许更大转向，内侧速度最低可降至0
-        float error_ratio = fabsf(line_position) / 1000.0f;  // [0,1]
+        // 后处理链：限幅 → 归一化 → 动态调整幅度 → 差速混合 → 速度保护
+        // 差速控制（左右电机硬件方向相反）：线在左时“左轮更慢、右轮更快”，
+        // applySpeed() 内部对左侧速度取反，右侧保持正向
+        float error_ratio = fabsf(filtered_position) / 1000.0f;  // [0,1]
         if (error_ratio > 1.0f) error_ratio = 1.0f;
-        const float HARD_MAX_ADJ = 1.0f;   // 大偏差时最大允许调整幅度（100%）
-        const float HARD_MIN_RATIO = 0.0f; // 大偏差时内侧车轮最低比例（0%）
-        float dynamic_max_adj = max_adjustment_ratio_ + (HARD_MAX_ADJ - max_adjustment_ratio_) * error_ratio;
-        float dynamic_min_ratio = min_speed_ratio_ * (1.0f - error_ratio) + HARD_MIN_RATIO * error_ratio; // 线性到0
-        if (dynamic_min_ratio < 0.0f) dynamic_min_ratio = 0.0f;
-
-        float target_adjustment = speed_adjustment_ratio * dynamic_max_adj;
-
-        // 方向滞回：仅用位置符号决定内外侧，且设置切换滞回区间
-        // 更新 last_inner_left_：|position|>dir_hyst_high_ 才切换；|position|<dir_hyst_low_ 保持
-        float pos_abs = fabsf(line_position);
-        if (pos_abs > dir_hyst_high_) {
-            last_inner_left_ = (line_position < 0.0f); // 负值=线在左 → 左为内侧
-        } // 否则保持原值
-
-        // 抖动抑制：调整系数限斜率（同向快、反向慢）
-        float max_delta_same = 8.0f * dt;  // 同向快速上升（~0.125/帧）
-        float max_delta_flip = 2.0f * dt;  // 反向缓慢变化（~0.025/帧）
-        float delta = target_adjustment - last_adjustment_factor_;
-        if ((delta > 0.0f && last_adjustment_factor_ >= 0.0f) || (delta < 0.0f && last_adjustment_factor_ <= 0.0f)) {
-            if (delta > max_delta_same) delta = max_delta_same;
-            if (delta < -max_delta_same) delta = -max_delta_same;
-        } else {
-            if (delta > max_delta_flip) delta = max_delta_flip;
-            if (delta < -max_delta_flip) delta = -max_delta_flip;
-        }
-        float adjustment_factor = last_adjustment_factor_ + delta;
-        // 轻微一阶低通平滑
-        adjustment_factor = 0.6f * adjustment_factor + 0.4f * last_adjustment_factor_;
-        last_adjustment_factor_ = adjustment_factor;
-
-        // 差速控制（左右电机硬件方向相反）：
-        // 为实现“线在左时向左纠偏”，应当“左轮更慢、右轮更快”
-        // 注意：applySpeed() 内部对左侧速度取反，右侧保持正向
-        float left_speed_f  = base_speed_ * (1.0f - adjustment_factor);
-        float right_speed_f = base_speed_ * (1.0f + adjustment_factor);
-
-        // 双向速度保护：统一最小/最大速度，避免限幅破坏差速方向
-        float min_speed = base_speed_ * min_speed_ratio_;
-        float max_speed = base_speed_ * max_speed_ratio_;
-        
-        if (left_speed_f < min_speed)  left_speed_f = min_speed;
-        if (left_speed_f > max_speed)  left_speed_f = max_speed;
-        if (right_speed_f < min_speed) right_speed_f = min_speed;
-        if (right_speed_f > max_speed) right_speed_f = max_speed;
 
-        left_speed_  = static_cast<int>(left_speed_f);
-        right_speed_ = static_cast<int>(right_speed_f);
+        signal_chain::Context ctx;
+        ctx.dt = dt;
+        ctx.base_speed = static_cast<float>(base_speed_);
+        ctx.max_output = base_speed_ * pid_output_ratio_;
+        ctx.error_ratio = error_ratio;
+        ctx.max_adjustment_ratio = max_adjustment_ratio_;
+        ctx.min_speed = base_speed_ * min_speed_ratio_;
+        ctx.max_speed = base_speed_ * max_speed_ratio_;
+
+        signal_chain::WheelPair wheels;
+        {
+            CYCLE_BUDGET_SCOPE(BudgetStage::POST);
+            wheels = post_chain_.process(pid_output_, ctx);
+        }
+        // 保留小数部分，小的转向修正不再被取整吃掉
+        left_speed_  = wheels.left;
+        right_speed_ = wheels.right;
     }
+
+    // 记录本帧指令差速，作为下一帧预测的过程输入
+    last_differential_ = right_speed_ - left_speed_;
     
     // 应用速度到电机
-    applySpeed(left_speed_, right_speed_);
+    {
+        CYCLE_BUDGET_SCOPE(BudgetStage::OUTPUT);
+        applySpeed(left_speed_, right_speed_);
+    }
     
     // 调试输出（减少频率以提升性能）
     if (debug_enabled_) {
@@ -303,6 +301,7 @@ void LineFollowerPID::update() {
         // 每100ms输出一次调试信息，而不是每次控制循环都输出
         if (current_time - last_debug_time >= 100) {
             last_debug_time = current_time;
+            CYCLE_BUDGET_SCOPE(BudgetStage::DEBUG);
             printDebugInfo(last_sensor_data_, last_binary_data_);
         }
     }
@@ -311,14 +310,34 @@ void LineFollowerPID::update() {
 /**
  * @brief 应用速度到电机
  */
-void LineFollowerPID::applySpeed(int left_speed, int right_speed) {
-    // 左侧电机（前后同步）- 需要反向补偿机械安装方向
-    motor_lf_.setSpeed(-left_speed);
-    motor_lb_.setSpeed(-left_speed);
-
-    // 右侧电机（前后同步）- 正方向为前进
-    motor_rf_.setSpeed(right_speed);
-    motor_rb_.setSpeed(right_speed);
+void LineFollowerPID::applySpeed(float left_speed, float right_speed) {
+    const int32_t left_q8 = fixed_math::toQ8(left_speed);
+    const int32_t right_q8 = fixed_math::toQ8(right_speed);
+
+    // 经仲裁器输出：只提交指令，电机由仲裁器通过 DriveTrain 统一写入
+    if (output_sink_ != nullptr) {
+        output_sink_->submitWheels(MotionSource::LINE_FOLLOWER, left_q8, right_q8, OUTPUT_LEASE_MS);
+        return;
+    }
+
+    // 电源电压补偿，再做四轮滑移转向混合（blend为0时前后同步）
+    int32_t left_out = left_q8;
+    int32_t right_out = right_q8;
+    if (supply_ != nullptr) {
+        supply_->compensate(left_out, right_out);
+    }
+    const skid_steer::WheelSpeeds wheels = skid_steer::mix(skid_steer_, left_out, right_out);
+
+    // 左侧电机 - 需要反向补偿机械安装方向
+    motor_lf_.stageSpeedQ8(-wheels.left_front);
+    motor_lb_.stageSpeedQ8(-wheels.left_rear);
+
+    // 右侧电机 - 正方向为前进
+    motor_rf_.stageSpeedQ8(wheels.right_front);
+    motor_rb_.stageSpeedQ8(wheels.right_rear);
+
+    // 四路脉宽一次写入，在同一个PWM帧生效
+    Motor::commit(motor_lf_, motor_lb_, motor_rf_, motor_rb_);
 }
 
 void LineFollowerPID::getLastSensorData(uint16_t out[8]) const {
@@ -346,7 +365,20 @@ int LineFollowerPID::clampSpeed(int speed) {
  */
 void LineFollowerPID::setPID(float kp, float ki, float kd) {
     pid_.setTunings(kp, ki, kd);
-    Debug_Printf("[LineFollower] PID参数: Kp=%.3f, Ki=%.3f, Kd=%.3f\r\n", kp, ki, kd);
+    FR_RECORD(FrEvent::PARAM, FrParam::KP, kp * 1000.0f);
+    FR_RECORD(FrEvent::PARAM, FrParam::KI, ki * 1000.0f);
+    FR_RECORD(FrEvent::PARAM, FrParam::KD, kd * 1000.0f);
+    LOG_I(LINE, "[LineFollower] PID参数: Kp=%.3f, Ki=%.3f, Kd=%.3f\r\n", kp, ki, kd);
+}
+
+/**
+ * @brief 设置线位置跟踪器参数
+ */
+void LineFollowerPID::setTrackerParameters(float alpha, float beta, float input_gain) {
+    tracker_.setGains(alpha, beta);
+    tracker_.setInputGain(input_gain);
+    LOG_I(LINE, "[LineFollower] 跟踪器参数: alpha=%.2f, beta=%.2f, 输入增益=%.1f\r\n",
+                alpha, beta, input_gain);
 }
 
 /**
@@ -355,12 +387,13 @@ void LineFollowerPID::setPID(float kp, float ki, float kd) {
 void LineFollowerPID::setBaseSpeed(int speed) {
     if (speed >= 0 && speed <= 100) {
         base_speed_ = speed;
+        FR_RECORD(FrEvent::PARAM, FrParam::BASE_SPEED, speed);
 
         // 动态调整PID输出限制
         updatePIDOutputLimits();
 
-        Debug_Printf("[LineFollower] 基础速度: %d (PID限制: ±%.1f)\r\n",
-                     speed, base_speed_ * 0.6f);
+        LOG_I(LINE, "[LineFollower] 基础速度: %d (PID限制: ±%.1f)\r\n",
+                    speed, base_speed_ * 0.6f);
     }
 }
 
@@ -370,7 +403,7 @@ void LineFollowerPID::setBaseSpeed(int speed) {
 void LineFollowerPID::setLineMode(LineMode mode) {
     line_mode_ = mode;
     const char* mode_str = (mode == LineMode::WHITE_ON_BLACK) ? "黑底白线" : "白底黑线";
-    Debug_Printf("[LineFollower] 线模式: %s\r\n", mode_str);
+    LOG_I(LINE, "[LineFollower] 线模式: %s\r\n", mode_str);
 }
 
 /**
@@ -379,9 +412,9 @@ void LineFollowerPID::setLineMode(LineMode mode) {
 void LineFollowerPID::setThreshold(uint16_t threshold) {
     threshold_ = threshold;
     if (threshold == 0) {
-        Debug_Printf("[LineFollower] 阈值: 使用传感器校准值\r\n");
+        LOG_I(LINE, "[LineFollower] 阈值: 使用传感器校准值\r\n");
     } else {
-        Debug_Printf("[LineFollower] 阈值: %d\r\n", threshold);
+        LOG_I(LINE, "[LineFollower] 阈值: %d\r\n", threshold);
     }
 }
 
@@ -391,7 +424,7 @@ void LineFollowerPID::setThreshold(uint16_t threshold) {
 void LineFollowerPID::setLineLostThreshold(int min_sensors) {
     if (min_sensors >= 0 && min_sensors <= 8) {
         line_lost_threshold_ = min_sensors;
-        Debug_Printf("[LineFollower] 丢线阈值: %d个传感器\r\n", min_sensors);
+        LOG_I(LINE, "[LineFollower] 丢线阈值: %d个传感器\r\n", min_sensors);
     }
 }
 
@@ -400,7 +433,7 @@ void LineFollowerPID::setLineLostThreshold(int min_sensors) {
  */
 void LineFollowerPID::enableDebug(bool enable) {
     debug_enabled_ = enable;
-    Debug_Printf("[LineFollower] 调试输出: %s\r\n", enable ? "启用" : "禁用");
+    LOG_I(LINE, "[LineFollower] 调试输出: %s\r\n", enable ? "启用" : "禁用");
 }
 
 /**
@@ -408,43 +441,39 @@ void LineFollowerPID::enableDebug(bool enable) {
  */
 void LineFollowerPID::resetPID() {
     pid_.reset();
+    post_chain_.reset();
     last_position_ = 0.0f;
-    Debug_Printf("[LineFollower] PID已重置\r\n");
+    LOG_I(LINE, "[LineFollower] PID已重置\r\n");
 }
 
 /**
  * @brief 打印调试信息
  */
 void LineFollowerPID::printDebugInfo(const uint16_t sensor_data[8], const bool binary_data[8]) {
-    // 格式: Pos:xxx.x Err:xxx.x PID:xx.x L:xx R:xx | S:xxxx xxxx xxxx xxxx xxxx xxxx xxxx xxxx | B:████
-    
-    // 位置、误差、PID输出、速度（将浮点数转换为整数，乘以1000表示3位小数）
-    Debug_Printf("Pos:%d Err:%d PID:%d L:%d R:%d | ",
-                 static_cast<int>(last_position_ * 1000.0f),  // 乘以1000转换为整数
-                 static_cast<int>(error_ * 1000.0f),
-                 static_cast<int>(pid_output_ * 1000.0f),
-                 left_speed_,
-                 right_speed_);
-    
-    // 传感器数据
-    Debug_Printf("S:");
-    for (int i = 0; i < 8; i++) {
-        Debug_Printf("%4d ", sensor_data[i]);
-    }
-    
-    // 二值化数据（使用ASCII字符表示）
-    Debug_Printf("| B:");
+    // 格式: Pos:xxx Err:xxx PID:xxx L:xx R:xx | S:xxxx xxxx xxxx xxxx xxxx xxxx xxxx xxxx | B:WWWBBWWW
+    // 一次调用输出整行：延迟格式化后端下只发送一帧（约30字节），文本后端下只格式化一次
+    char binary[9];
     for (int i = 0; i < 8; i++) {
-        Debug_Printf("%c", binary_data[i] ? 'B' : 'W');
+        binary[i] = binary_data[i] ? 'B' : 'W';
     }
-    
+    binary[8] = '\0';
+
+    // 位置、误差、PID输出乘以1000转换为整数（避免 %f）
+    LOG_D(LINE, "Pos:%d Err:%d PID:%d L:%d R:%d | S:%4u %4u %4u %4u %4u %4u %4u %4u | B:%s\r\n",
+                static_cast<int>(last_position_ * 1000.0f),
+                static_cast<int>(error_ * 1000.0f),
+                static_cast<int>(pid_output_ * 1000.0f),
+                static_cast<int>(left_speed_),
+                static_cast<int>(right_speed_),
+                sensor_data[0], sensor_data[1], sensor_data[2], sensor_data[3],
+                sensor_data[4], sensor_data[5], sensor_data[6], sensor_data[7],
+                binary);
+
     // PID各项（可选，用于深度调试）
-    // Debug_Printf("| P:%.1f I:%.1f D:%.1f",
-    //              pid_.getProportional(),
-    //              pid_.getIntegral(),
-    //              pid_.getDerivative());
-    
-    Debug_Printf("\r\n");
+    // LOG_D(LINE, "| P:%.1f I:%.1f D:%.1f\r\n",
+    //            pid_.getProportional(),
+    //            pid_.getIntegral(),
+    //            pid_.getDerivative());
 }
 
 /**
@@ -461,8 +490,8 @@ void LineFollowerPID::updatePIDOutputLimits() {
  */
 void LineFollowerPID::constrainSpeeds() {
     // 计算速度范围（使用可调参数）
-    int min_speed = static_cast<int>(base_speed_ * min_speed_ratio_);
-    int max_speed = static_cast<int>(base_speed_ * max_speed_ratio_);
+    float min_speed = base_speed_ * min_speed_ratio_;
+    float max_speed = base_speed_ * max_speed_ratio_;
 
     // 约束速度范围
     if (left_speed_ < min_speed) left_speed_ = min_speed;
@@ -486,8 +515,8 @@ void LineFollowerPID::setControlParameters(float max_adjustment_ratio,
     // 重新计算PID输出限制
     updatePIDOutputLimits();
 
-    Debug_Printf("[LineFollower] 控制参数更新: 调整幅度=%.0f%%, 速度范围=%.0f%%-%.0f%%, PID限制=%.0f%%\r\n",
-                 max_adjustment_ratio * 100, min_speed_ratio * 100, max_speed_ratio * 100, pid_output_ratio * 100);
+    LOG_I(LINE, "[LineFollower] 控制参数更新: 调整幅度=%.0f%%, 速度范围=%.0f%%-%.0f%%, PID限制=%.0f%%\r\n",
+                max_adjustment_ratio * 100, min_speed_ratio * 100, max_speed_ratio * 100, pid_output_ratio * 100);
 }
 
 /**
@@ -506,8 +535,8 @@ void LineFollowerPID::setNonLinearParameters(float small_threshold,
     medium_gain_ = medium_gain;
     large_gain_ = large_gain;
 
-    Debug_Printf("[LineFollower] 非线性参数更新: 阈值=%.2f/%.2f/%.2f, 增益=%.2f/%.2f/%.2f\r\n",
-                 small_threshold, medium_threshold, large_threshold, small_gain, medium_gain, large_gain);
+    LOG_I(LINE, "[LineFollower] 非线性参数更新: 阈值=%.2f/%.2f/%.2f, 增益=%.2f/%.2f/%.2f\r\n",
+                small_threshold, medium_threshold, large_threshold, small_gain, medium_gain, large_gain);
 }
 
 /**
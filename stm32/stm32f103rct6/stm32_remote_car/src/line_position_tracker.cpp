@@ -0,0 +1,91 @@
+/**
+ * @file    line_position_tracker.cpp
+ * @brief   线位置 α-β 跟踪器实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "line_position_tracker.hpp"
+#include <math.h>
+
+namespace {
+constexpr float POSITION_LIMIT = 1000.0f;   // 位置范围
+constexpr float VELOCITY_LIMIT = 20000.0f;  // 漂移速度上限（单位/秒）
+}
+
+LinePositionTracker::LinePositionTracker()
+    : position_(0.0f)
+    , velocity_(0.0f)
+    , rate_(0.0f)
+    , dt_(0.01f)
+    , alpha_(0.5f)
+    , beta_(0.15f)
+    , input_gain_(20.0f)
+    , gate_(450.0f)      // 大于一个探头间隔（285.7）
+    , max_rejects_(3)
+    , reject_streak_(0)
+    , total_rejects_(0)
+    , initialized_(false)
+{
+}
+
+void LinePositionTracker::reset(float position) {
+    position_ = position;
+    velocity_ = 0.0f;
+    rate_ = 0.0f;
+    reject_streak_ = 0;
+    initialized_ = true;
+}
+
+void LinePositionTracker::predict(float dt, float differential) {
+    if (dt <= 0.0f) {
+        return;
+    }
+    dt_ = dt;
+    rate_ = velocity_ + input_gain_ * differential;
+    position_ += rate_ * dt;
+
+    if (position_ > POSITION_LIMIT) position_ = POSITION_LIMIT;
+    if (position_ < -POSITION_LIMIT) position_ = -POSITION_LIMIT;
+}
+
+bool LinePositionTracker::correct(float measured) {
+    if (!initialized_) {
+        reset(measured);
+        return true;
+    }
+
+    float residual = measured - position_;
+
+    // 跳变门限：短暂的大残差视为探头间隙跳变，只做预测
+    if (fabsf(residual) > gate_) {
+        total_rejects_++;
+        if (++reject_streak_ <= max_rejects_) {
+            return false;
+        }
+        // 连续多帧都偏离：线确实移动了，重新锚定
+        reset(measured);
+        return true;
+    }
+    reject_streak_ = 0;
+
+    position_ += alpha_ * residual;
+    velocity_ += (beta_ / dt_) * residual;
+
+    if (velocity_ > VELOCITY_LIMIT) velocity_ = VELOCITY_LIMIT;
+    if (velocity_ < -VELOCITY_LIMIT) velocity_ = -VELOCITY_LIMIT;
+
+    // 修正后的总变化率供PID微分使用
+    rate_ += (beta_ / dt_) * residual;
+    return true;
+}
+
+void LinePositionTracker::setGains(float alpha, float beta) {
+    if (alpha > 0.0f && alpha <= 1.0f) alpha_ = alpha;
+    if (beta >= 0.0f && beta <= 1.0f) beta_ = beta;
+}
+
+void LinePositionTracker::setGate(float gate, uint8_t max_rejects) {
+    if (gate > 0.0f) gate_ = gate;
+    max_rejects_ = max_rejects;
+}
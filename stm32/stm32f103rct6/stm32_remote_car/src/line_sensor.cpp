@@ -1,6 +1,7 @@
 #include "adc.h"
 #include "button.hpp"
 #include "common.h"
+#include "cycle_budget.hpp"
 #include "debug.hpp"
 #include "gpio.h"
 #include "line_sensor.hpp"
@@ -32,12 +33,16 @@ LineSensor::LineSensor() { MX_ADC1_Init(); }
 
 void LineSensor::getRawData(uint16_t data[8]) {
     ADC_ReadAll(data);
-    Debug_Printf("[LineSensor] Raw Data: %d, %d, %d, %d, %d, %d, %d, %d\n", data[0], data[1],
-                 data[2], data[3], data[4], data[5], data[6], data[7]);
+    LOG_D(SENSOR, "[LineSensor] Raw Data: %d, %d, %d, %d, %d, %d, %d, %d\n", data[0], data[1],
+                  data[2], data[3], data[4], data[5], data[6], data[7]);
 }
 
 void LineSensor::getData(uint16_t data[8]) {
-    medianFilter(data);
+    {
+        CYCLE_BUDGET_SCOPE(BudgetStage::ADC);
+        medianFilter(data);
+    }
+    CYCLE_BUDGET_SCOPE(BudgetStage::FILTER);
     lowPassFilter(data);
 
     // 应用传感器偏移补偿
@@ -120,8 +125,8 @@ void LineSensor::lowPassFilter(uint16_t data[8]) {
         }
         filter_initialized_ = true;
 
-        Debug_Printf("[LineSensor] 低通滤波器已初始化 (α=%.2f)\r\n",
-                     (float)alpha_numerator_ / ALPHA_DENOMINATOR);
+        LOG_D(SENSOR, "[LineSensor] 低通滤波器已初始化 (α=%.2f)\r\n",
+                      (float)alpha_numerator_ / ALPHA_DENOMINATOR);
         return;  // 第一次不进行滤波，直接返回
     }
 
@@ -187,9 +192,13 @@ void LineSensor::setFilterAlpha(float alpha) {
     }
 
     // 转换为定点数：α * 256
-    alpha_numerator_ = (uint16_t)(alpha * ALPHA_DENOMINATOR);
+    const uint16_t numerator = (uint16_t)(alpha * ALPHA_DENOMINATOR);
+    if (numerator == alpha_numerator_) {
+        return;  // 巡线控制器每个周期都会调用，未变化时不输出
+    }
+    alpha_numerator_ = numerator;
 
-    Debug_Printf("[LineSensor] 滤波系数已设置: α=%.2f (%d/256)\r\n", alpha, alpha_numerator_);
+    LOG_D(SENSOR, "[LineSensor] 滤波系数已设置: α=%.2f (%d/256)\r\n", alpha, alpha_numerator_);
 }
 
 /**
@@ -204,8 +213,8 @@ void LineSensor::setFilterAlphaRaw(uint16_t alpha_numerator) {
 
     alpha_numerator_ = alpha_numerator;
 
-    Debug_Printf("[LineSensor] 滤波系数已设置: α=%d/256 (%.2f)\r\n", alpha_numerator_,
-                 (float)alpha_numerator_ / ALPHA_DENOMINATOR);
+    LOG_D(SENSOR, "[LineSensor] 滤波系数已设置: α=%d/256 (%.2f)\r\n", alpha_numerator_,
+                  (float)alpha_numerator_ / ALPHA_DENOMINATOR);
 }
 
 /**
@@ -226,7 +235,7 @@ void LineSensor::resetFilter() {
     // 标记为未初始化
     filter_initialized_ = false;
 
-    Debug_Printf("[LineSensor] 滤波器已重置\r\n");
+    LOG_I(SENSOR, "[LineSensor] 滤波器已重置\r\n");
 }
 
 /**
@@ -248,15 +257,15 @@ void LineSensor::setFilterBySpeed(float speed_mps) {
     if (speed_mps < 0.3f) {
         // 低速：强滤波，确保数据稳定
         new_alpha = 77;  // α = 0.3
-        Debug_Printf("[LineSensor] 低速模式: α=0.3\r\n");
+        LOG_D(SENSOR, "[LineSensor] 低速模式: α=0.3\r\n");
     } else if (speed_mps < 0.6f) {
         // 中速：平衡滤波
         new_alpha = 102;  // α = 0.4
-        Debug_Printf("[LineSensor] 中速模式: α=0.4\r\n");
+        LOG_D(SENSOR, "[LineSensor] 中速模式: α=0.4\r\n");
     } else {
         // 高速：弱滤波，确保快速响应
         new_alpha = 179;  // α = 0.7
-        Debug_Printf("[LineSensor] 高速模式: α=0.7\r\n");
+        LOG_D(SENSOR, "[LineSensor] 高速模式: α=0.7\r\n");
     }
 
     alpha_numerator_ = new_alpha;
@@ -269,8 +278,8 @@ void LineSensor::setFilterBySpeed(float speed_mps) {
  * @note 采集当前传感器在白色区域的读数
  */
 void LineSensor::calibrateWhite() {
-    Debug_Printf("[LineSensor] 开始白色校准...\r\n");
-    Debug_Printf("[LineSensor] 请将传感器放在白色区域上\r\n");
+    LOG_I(SENSOR, "[LineSensor] 开始白色校准...\r\n");
+    LOG_I(SENSOR, "[LineSensor] 请将传感器放在白色区域上\r\n");
     // 延迟让用户看到提示
     HAL_Delay(2000);
 
@@ -294,11 +303,11 @@ void LineSensor::calibrateWhite() {
         white_calibration_[i] = sum[i] / SAMPLES;
     }
 
-    Debug_Printf("[LineSensor] 白色校准完成: ");
+    LOG_I(SENSOR, "[LineSensor] 白色校准完成: ");
     for (int i = 0; i < 8; i++) {
-        Debug_Printf("%d ", white_calibration_[i]);
+        LOG_I(SENSOR, "%d ", white_calibration_[i]);
     }
-    Debug_Printf("\r\n");
+    LOG_I(SENSOR, "\r\n");
 }
 
 /**
@@ -306,8 +315,8 @@ void LineSensor::calibrateWhite() {
  * @note 采集当前传感器在黑色线上的读数
  */
 void LineSensor::calibrateBlack() {
-    Debug_Printf("[LineSensor] 开始黑色校准...\r\n");
-    Debug_Printf("[LineSensor] 请将传感器放在黑色线上\r\n");
+    LOG_I(SENSOR, "[LineSensor] 开始黑色校准...\r\n");
+    LOG_I(SENSOR, "[LineSensor] 请将传感器放在黑色线上\r\n");
 
     // 延迟让用户看到提示
     HAL_Delay(2000);
@@ -332,11 +341,11 @@ void LineSensor::calibrateBlack() {
         black_calibration_[i] = sum[i] / SAMPLES;
     }
 
-    Debug_Printf("[LineSensor] 黑色校准完成: ");
+    LOG_I(SENSOR, "[LineSensor] 黑色校准完成: ");
     for (int i = 0; i < 8; i++) {
-        Debug_Printf("%d ", black_calibration_[i]);
+        LOG_I(SENSOR, "%d ", black_calibration_[i]);
     }
-    Debug_Printf("\r\n");
+    LOG_I(SENSOR, "\r\n");
 }
 
 /**
@@ -345,27 +354,27 @@ void LineSensor::calibrateBlack() {
  * @note 等待按钮按下，分三步完成校准
  */
 void LineSensor::autoCalibrate(Button& button) {
-    Debug_Printf("\r\n╔══════════════════════════════════════════╗\r\n");
-    Debug_Printf("║      传感器手动分步校准                  ║\r\n");
-    Debug_Printf("╚══════════════════════════════════════════╝\r\n");
+    LOG_I(SENSOR, "\r\n╔══════════════════════════════════════════╗\r\n");
+    LOG_I(SENSOR, "║      传感器手动分步校准                  ║\r\n");
+    LOG_I(SENSOR, "╚══════════════════════════════════════════╝\r\n");
     
     /* ========== 等待按钮释放（避免长按触发后直接进入下一步） ========== */
-    Debug_Printf("\r\n⏳ 请先释放按钮...\r\n");
+    LOG_I(SENSOR, "\r\n⏳ 请先释放按钮...\r\n");
     while (button.read()) {
         HAL_Delay(10);  // 等待按钮释放
     }
-    Debug_Printf("✅ 按钮已释放\r\n");
+    LOG_I(SENSOR, "✅ 按钮已释放\r\n");
     
     // 重置按钮状态，清除之前的触发标志
     button.reset();
     HAL_Delay(500);  // 给用户缓冲时间
 
     /* ========== 步骤1：白色校准 ========== */
-    Debug_Printf("\r\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
-    Debug_Printf("📍 步骤 1/3：白色校准\r\n");
-    Debug_Printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
-    Debug_Printf("请将传感器放在【白色区域】上\r\n");
-    Debug_Printf("准备好后，按下按钮开始采集...\r\n\r\n");
+    LOG_I(SENSOR, "\r\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
+    LOG_I(SENSOR, "📍 步骤 1/3：白色校准\r\n");
+    LOG_I(SENSOR, "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
+    LOG_I(SENSOR, "请将传感器放在【白色区域】上\r\n");
+    LOG_I(SENSOR, "准备好后，按下按钮开始采集...\r\n\r\n");
 
     // LED闪烁等待
     while (!button.isPressed()) {
@@ -375,21 +384,21 @@ void LineSensor::autoCalibrate(Button& button) {
         HAL_Delay(100);
     }
 
-    Debug_Printf("✅ 按钮已按下，开始采集白色值...\r\n");
+    LOG_I(SENSOR, "✅ 按钮已按下，开始采集白色值...\r\n");
     HAL_GPIO_WritePin(LED_PORT, LED_PIN, GPIO_PIN_SET);  // LED常亮
     HAL_Delay(200);  // 防抖延迟
 
     calibrateWhite();
 
-    Debug_Printf("✅ 白色校准完成！\r\n\r\n");
+    LOG_I(SENSOR, "✅ 白色校准完成！\r\n\r\n");
     HAL_Delay(500);
 
     /* ========== 步骤2：黑色校准 ========== */
-    Debug_Printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
-    Debug_Printf("📍 步骤 2/3：黑色校准\r\n");
-    Debug_Printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
-    Debug_Printf("请将传感器放在【黑色线】上\r\n");
-    Debug_Printf("准备好后，按下按钮开始采集...\r\n\r\n");
+    LOG_I(SENSOR, "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
+    LOG_I(SENSOR, "📍 步骤 2/3：黑色校准\r\n");
+    LOG_I(SENSOR, "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
+    LOG_I(SENSOR, "请将传感器放在【黑色线】上\r\n");
+    LOG_I(SENSOR, "准备好后，按下按钮开始采集...\r\n\r\n");
 
     // LED闪烁等待
     while (!button.isPressed()) {
@@ -399,20 +408,20 @@ void LineSensor::autoCalibrate(Button& button) {
         HAL_Delay(100);
     }
 
-    Debug_Printf("✅ 按钮已按下，开始采集黑色值...\r\n");
+    LOG_I(SENSOR, "✅ 按钮已按下，开始采集黑色值...\r\n");
     HAL_GPIO_WritePin(LED_PORT, LED_PIN, GPIO_PIN_RESET);  // LED常亮
     HAL_Delay(200);                                        // 防抖延迟
 
     calibrateBlack();
 
-    Debug_Printf("✅ 黑色校准完成！\r\n\r\n");
+    LOG_I(SENSOR, "✅ 黑色校准完成！\r\n\r\n");
     HAL_Delay(500);
 
     /* ========== 步骤3：计算阈值 ========== */
-    Debug_Printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
-    Debug_Printf("📍 步骤 3/3：计算阈值并保存\r\n");
-    Debug_Printf("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
-    Debug_Printf("按下按钮完成校准...\r\n\r\n");
+    LOG_I(SENSOR, "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
+    LOG_I(SENSOR, "📍 步骤 3/3：计算阈值并保存\r\n");
+    LOG_I(SENSOR, "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
+    LOG_I(SENSOR, "按下按钮完成校准...\r\n\r\n");
 
     // LED快速闪烁等待
     while (!button.isPressed()) {
@@ -422,7 +431,7 @@ void LineSensor::autoCalibrate(Button& button) {
         HAL_Delay(50);
     }
 
-    Debug_Printf("✅ 按钮已按下，开始计算阈值...\r\n");
+    LOG_I(SENSOR, "✅ 按钮已按下，开始计算阈值...\r\n");
     HAL_Delay(200);  // 防抖延迟
 
     // 计算平均值和阈值
@@ -443,20 +452,20 @@ void LineSensor::autoCalibrate(Button& button) {
     }
 
     // 显示校准结果
-    Debug_Printf("\r\n传感器  白色值  黑色值  阈值\r\n");
-    Debug_Printf("━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
+    LOG_I(SENSOR, "\r\n传感器  白色值  黑色值  阈值\r\n");
+    LOG_I(SENSOR, "━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
     for (int i = 0; i < 8; i++) {
-        Debug_Printf("  [%d]   %4d    %4d    %4d\r\n", i, white_calibration_[i], black_calibration_[i], thresholds_[i]);
+        LOG_I(SENSOR, "  [%d]   %4d    %4d    %4d\r\n", i, white_calibration_[i], black_calibration_[i], thresholds_[i]);
     }
-    Debug_Printf("━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
+    LOG_I(SENSOR, "━━━━━━━━━━━━━━━━━━━━━━━━━━\r\n");
 
-    Debug_Printf("\r\n[LineSensor] 白色平均值: %lu\r\n", white_avg);
-    Debug_Printf("[LineSensor] 黑色平均值: %lu\r\n", black_avg);
+    LOG_I(SENSOR, "\r\n[LineSensor] 白色平均值: %lu\r\n", white_avg);
+    LOG_I(SENSOR, "[LineSensor] 黑色平均值: %lu\r\n", black_avg);
 
-    Debug_Printf("\r\n╔══════════════════════════════════════════╗\r\n");
-    Debug_Printf("║      ✅ 校准完成！                       ║\r\n");
-    Debug_Printf("╚══════════════════════════════════════════╝\r\n");
-    Debug_Printf("提示：调用 saveCalibration() 保存到EEPROM\r\n\r\n");
+    LOG_I(SENSOR, "\r\n╔══════════════════════════════════════════╗\r\n");
+    LOG_I(SENSOR, "║      ✅ 校准完成！                       ║\r\n");
+    LOG_I(SENSOR, "╚══════════════════════════════════════════╝\r\n");
+    LOG_I(SENSOR, "提示：调用 saveCalibration() 保存到EEPROM\r\n\r\n");
 
     // LED熄灭
     HAL_GPIO_WritePin(LED_PORT, LED_PIN, GPIO_PIN_SET);
@@ -469,7 +478,7 @@ void LineSensor::autoCalibrate(Button& button) {
  * @return false 加载失败（使用默认值）
  */
 bool LineSensor::loadCalibration(EEPROM& eeprom) {
-    Debug_Printf("[LineSensor] 正在从EEPROM加载校准数据...\r\n");
+    LOG_I(SENSOR, "[LineSensor] 正在从EEPROM加载校准数据...\r\n");
 
     SensorCalibration calib;
 
@@ -477,19 +486,19 @@ bool LineSensor::loadCalibration(EEPROM& eeprom) {
     if (eeprom.readStructCRC(CALIBRATION_EEPROM_ADDR, calib)) {
         // CRC校验通过，检查魔术数字
         if (calib.magic_number == CALIBRATION_MAGIC) {
-            Debug_Printf("[LineSensor] 校准数据有效，应用配置\r\n");
+            LOG_I(SENSOR, "[LineSensor] 校准数据有效，应用配置\r\n");
 
             // 应用校准数据
             applyCalibration(calib);
 
-            Debug_Printf("[LineSensor] 各传感器阈值已计算并应用\r\n");
+            LOG_I(SENSOR, "[LineSensor] 各传感器阈值已计算并应用\r\n");
 
             return true;
         } else {
-            Debug_Printf("[LineSensor] 魔术数字不匹配，使用默认值\r\n");
+            LOG_W(SENSOR, "[LineSensor] 魔术数字不匹配，使用默认值\r\n");
         }
     } else {
-        Debug_Printf("[LineSensor] CRC校验失败或数据未初始化，使用默认值\r\n");
+        LOG_W(SENSOR, "[LineSensor] CRC校验失败或数据未初始化，使用默认值\r\n");
     }
 
     // 使用默认阈值（所有传感器设置为相同值）
@@ -497,7 +506,7 @@ bool LineSensor::loadCalibration(EEPROM& eeprom) {
     for (int i = 0; i < 8; i++) {
         thresholds_[i] = default_threshold;
     }
-    Debug_Printf("[LineSensor] 使用默认阈值: %d\r\n", default_threshold);
+    LOG_I(SENSOR, "[LineSensor] 使用默认阈值: %d\r\n", default_threshold);
 
     return false;
 }
@@ -509,7 +518,7 @@ bool LineSensor::loadCalibration(EEPROM& eeprom) {
  * @return false 保存失败
  */
 bool LineSensor::saveCalibration(EEPROM& eeprom) {
-    Debug_Printf("[LineSensor] 正在保存校准数据到EEPROM...\r\n");
+    LOG_I(SENSOR, "[LineSensor] 正在保存校准数据到EEPROM...\r\n");
 
     SensorCalibration calib;
 
@@ -518,12 +527,12 @@ bool LineSensor::saveCalibration(EEPROM& eeprom) {
 
     // 保存到EEPROM（带CRC校验）
     if (eeprom.writeStructCRC(CALIBRATION_EEPROM_ADDR, calib)) {
-        Debug_Printf("[LineSensor] 校准数据保存成功！\r\n");
-        Debug_Printf("[LineSensor] 地址: 0x%02X\r\n", CALIBRATION_EEPROM_ADDR);
-        Debug_Printf("[LineSensor] 大小: %d 字节（含CRC）\r\n", sizeof(calib) + 1);
+        LOG_I(SENSOR, "[LineSensor] 校准数据保存成功！\r\n");
+        LOG_I(SENSOR, "[LineSensor] 地址: 0x%02X\r\n", CALIBRATION_EEPROM_ADDR);
+        LOG_I(SENSOR, "[LineSensor] 大小: %d 字节（含CRC）\r\n", sizeof(calib) + 1);
         return true;
     } else {
-        Debug_Printf("[LineSensor] 校准数据保存失败！\r\n");
+        LOG_E(SENSOR, "[LineSensor] 校准数据保存失败！\r\n");
         return false;
     }
 }
@@ -581,11 +590,11 @@ void LineSensor::setSensorOffsets(const int16_t offsets[8]) {
         sensor_offsets_[i] = offsets[i];
     }
 
-    Debug_Printf("[LineSensor] 传感器补偿已设置: ");
+    LOG_I(SENSOR, "[LineSensor] 传感器补偿已设置: ");
     for (int i = 0; i < 8; i++) {
-        Debug_Printf("%+d ", sensor_offsets_[i]);
+        LOG_I(SENSOR, "%+d ", sensor_offsets_[i]);
     }
-    Debug_Printf("\r\n");
+    LOG_I(SENSOR, "\r\n");
 }
 
 /**
@@ -595,7 +604,7 @@ void LineSensor::clearSensorOffsets() {
     for (int i = 0; i < 8; i++) {
         sensor_offsets_[i] = 0;
     }
-    Debug_Printf("[LineSensor] 传感器补偿已清除\r\n");
+    LOG_I(SENSOR, "[LineSensor] 传感器补偿已清除\r\n");
 }
 
 /**
@@ -685,6 +694,8 @@ float LineSensor::getLinePositionWithData(uint16_t sensor_data[8], bool binary_d
     uint16_t phys_data[8];
     getData(phys_data);
 
+    CYCLE_BUDGET_SCOPE(BudgetStage::POSITION);
+
     // 将物理顺序映射为逻辑左→右，同时输出映射后的原始数据（供显示）
     for (int i = 0; i < 8; i++) {
         int src = reverse_order_ ? (7 - i) : i;
@@ -792,6 +803,9 @@ bool LineSensor::isLineDetected(int min_sensors, LineMode mode, uint16_t thresho
 void LineSensor::setMedianSamples(uint8_t samples) {
     if (samples < 1) samples = 1;
     if (samples > 5) samples = 5;
+    if (samples == median_samples_) {
+        return;
+    }
     median_samples_ = samples;
-    Debug_Printf("[LineSensor] 中值采样次数=%d\r\n", median_samples_);
+    LOG_D(SENSOR, "[LineSensor] 中值采样次数=%d\r\n", median_samples_);
 }
@@ -24,12 +24,23 @@
 
 // 功能模块
 #include "button.hpp"
+#include "crash_dump.hpp"
+#include "cycle_budget.hpp"
+#include "sampling_profiler.hpp"
 #include "debug.hpp"
+#include "drive_train.hpp"
 #include "eeprom.hpp"
+#include "flight_recorder.hpp"
+#include "latency_probe.hpp"
 #include "line_follower_pid.hpp"
 #include "line_sensor.hpp"
+#include "motion_arbiter.hpp"
 #include "motor.hpp"
+#include "motor_calibration.hpp"
 #include "oled_display.hpp"
+#include "pose_estimator.hpp"
+#include "spot_turn_calibration.hpp"
+#include "supply_monitor.hpp"
 
 // 第三方库
 #include <U8g2lib.h>
@@ -46,6 +57,16 @@ Button calib_button(GPIOD, GPIO_PIN_2, ButtonMode::PULL_UP, 200);
 // 巡线控制器
 LineFollowerPID* follower = nullptr;
 
+// 运动输出：所有指令源经仲裁器、由 DriveTrain 统一写电机
+DriveTrain* drive_train = nullptr;
+MotionArbiter* arbiter = nullptr;
+
+// 航位推算（指令轮速 + 电机模型，线位置修正横向偏差）
+PoseEstimator pose;
+
+// 电源电压监测（Vrefint 注入采样，电池电压下降时补偿轮速）
+SupplyMonitor supply;
+
 // 系统状态
 enum class SystemState {
     STOPPED,      // 停止（等待校准）
@@ -66,13 +87,18 @@ void HAL_MspInit(void);
 void initHardware();
 void initSystem();
 bool loadCalibrationData();
+void loadMotorCurves();
 void performCalibration();
+void updatePose(uint32_t dt_ms);
 void updateOLEDDisplay();
 void setLED(bool on);
 
 /* ========== 主程序 ========== */
 
 int main(void) {
+    // 故障现场保存（早于其它初始化，初始化过程中的故障也能记录）
+    CrashDump::init();
+
     // 硬件初始化
     initHardware();
 
@@ -90,29 +116,65 @@ int main(void) {
     while (1) {
         uint32_t now = HAL_GetTick();
 
-        // 检查校准按钮（长按3秒）
-        if (calib_button.isLongPressed(3000)) {
-            if (follower) follower->stop();
-            setLED(true);
-            performCalibration();
-            setLED(false);
-            if (follower) follower->start();
-            system_state = SystemState::RUNNING;
-        }
+        {
+            // 一轮主循环耗时（不含WFI）
+            CYCLE_BUDGET_SCOPE(BudgetStage::LOOP);
+            CrashDump::setStage(BudgetStage::LOOP);
+
+#if CYCLE_BUDGET_ENABLE || PROFILER_SAMPLING_ENABLE || FLIGHT_RECORDER_ENABLE
+            // 短按（3秒内松开）输出分段计时报告和采样直方图，冻结/导出飞行记录；长按3秒为校准
+            if (calib_button.isShortPressed(3000)) {
+                CYCLE_BUDGET_REPORT();
+                PROFILER_DUMP();
+                FR_BUTTON();
+            }
+#endif
+
+            // 检查校准按钮（长按3秒）
+            if (calib_button.isLongPressed(3000)) {
+                if (follower) follower->stop();
+                setLED(true);
+                performCalibration();
+                setLED(false);
+                calib_button.reset();  // 校准结束时仍按住，松开不算短按
+                if (follower) follower->start();
+                system_state = SystemState::RUNNING;
+            }
+
+            // 控制循环更新（20ms）
+            if (now - last_control_update >= CONTROL_INTERVAL) {
+                uint32_t dt_ms = now - last_control_update;
+                last_control_update = now;
+
+                // 控制周期被拖长（阻塞调用、长中断）
+                if (dt_ms >= 2 * CONTROL_INTERVAL) {
+                    FR_RECORD(FrEvent::DEADLINE_MISS, BudgetStage::TICK, dt_ms < 32 ? dt_ms * 1000 : INT16_MAX);
+                }
 
-        // 控制循环更新（20ms）
-        if (now - last_control_update >= CONTROL_INTERVAL) {
-            last_control_update = now;
+                if (system_state == SystemState::RUNNING && follower) {
+                    CrashDump::setStage(BudgetStage::TICK);
+                    follower->update();
+                }
 
-            if (system_state == SystemState::RUNNING && follower) {
-                follower->update();
+                // 电源电压（内部限频50ms，紧跟传感器扫描之后采样）
+                supply.update();
+
+                // 选出优先级最高的有效指令并输出（无指令时平滑减速到0）
+                CrashDump::setStage(BudgetStage::OUTPUT);
+                arbiter->update();
+                updatePose(dt_ms);
+
+                // 丢线持续过久时冻结飞行记录
+                FR_UPDATE();
             }
-        }
 
-        // OLED显示更新（100ms）
-        if (now - last_oled_update >= OLED_INTERVAL) {
-            last_oled_update = now;
-            updateOLEDDisplay();
+            // OLED显示更新（100ms）
+            if (now - last_oled_update >= OLED_INTERVAL) {
+                last_oled_update = now;
+                CYCLE_BUDGET_SCOPE(BudgetStage::OLED);
+                CrashDump::setStage(BudgetStage::OLED);
+                updateOLEDDisplay();
+            }
         }
 
         // CPU空闲时进入低功耗等待，而不是阻塞延迟
@@ -164,6 +226,18 @@ void initHardware() {
     // EEPROM初始化
     eeprom.init();
 
+    // 分段计时（CYCLE_BUDGET_ENABLE=0时为空）
+    CYCLE_BUDGET_INIT();
+
+    // 采样分析器（PROFILER_SAMPLING_ENABLE=0时为空）
+    PROFILER_INIT();
+
+    // 飞行记录仪（在 CYCLE_BUDGET_INIT 之后，共用DWT计数器）
+    FR_INIT();
+
+    // 指令延迟探针（LATENCY_PROBE_ENABLE=0时为空）
+    LATENCY_INIT();
+
     HAL_Delay(100);
 }
 
@@ -171,11 +245,32 @@ void initHardware() {
  * @brief 系统初始化
  */
 void initSystem() {
+    // 上次复位由崩溃引起时先输出故障报告
+    CrashDump::reportIfAny();
+
     // 尝试加载校准数据
     bool calibration_loaded = loadCalibrationData();
 
-    // 创建巡线控制器
+    // 加载电机速度曲线（死区/非线性补偿），无数据时保持线性映射
+    loadMotorCurves();
+
+    // 创建运动输出通道和仲裁器
+    drive_train = new DriveTrain(motor_lf, motor_lr, motor_rf, motor_rr);
+    arbiter = new MotionArbiter(*drive_train);
+
+    // 电源电压补偿：标称电压取本次上电时的测量值
+    supply.init();
+    drive_train->setSupplyMonitor(&supply);
+
+    // 原地转向最小有效轮速（按地面标定，无数据时保持默认）
+    SpotTurnCalibrationData spot_model;
+    if (SpotTurnCalibration::load(eeprom, spot_model)) {
+        SpotTurnCalibration::apply(spot_model, *drive_train);
+    }
+
+    // 创建巡线控制器（轮速经仲裁器输出）
     follower = new LineFollowerPID(line_sensor, motor_lf, motor_lr, motor_rf, motor_rr);
+    follower->setOutputSink(arbiter);
 
     // 配置巡线参数
     follower->setLineMode(LineSensor::LineMode::BLACK_ON_WHITE);
@@ -261,14 +356,14 @@ void initSystem() {
     if (calibration_loaded) {
         follower->start();
         system_state = SystemState::RUNNING;
-        Debug_Printf("[系统] 自动启动巡线\r\n");
+        LOG_I(SYSTEM, "[系统] 自动启动巡线\r\n");
     } else {
         system_state = SystemState::STOPPED;
         g_oled.clear();
         g_oled.printLine(0, "Need Calibration");
         g_oled.printLine(1, "Hold BTN 3s");
         g_oled.show();
-        Debug_Printf("[系统] 等待校准\r\n");
+        LOG_I(SYSTEM, "[系统] 等待校准\r\n");
     }
 }
 
@@ -277,14 +372,14 @@ void initSystem() {
  * @return true=成功，false=失败
  */
 bool loadCalibrationData() {
-    Debug_Printf("[系统] 加载校准数据...\r\n");
+    LOG_I(SYSTEM, "[系统] 加载校准数据...\r\n");
 
     if (!line_sensor.loadCalibration(eeprom)) {
-        Debug_Printf("[系统] 无校准数据\r\n");
+        LOG_I(SYSTEM, "[系统] 无校准数据\r\n");
         return false;
     }
 
-    Debug_Printf("[系统] 校准数据加载成功\r\n");
+    LOG_I(SYSTEM, "[系统] 校准数据加载成功\r\n");
 
     // 显示校准数据
     uint16_t white_vals[8], black_vals[8];
@@ -318,13 +413,31 @@ bool loadCalibrationData() {
     return true;
 }
 
+/**
+ * @brief 加载电机速度曲线并安装到各电机
+ */
+void loadMotorCurves() {
+    MotorCalibrationData motor_calib;
+    if (!MotorCalibration::load(eeprom, motor_calib)) {
+        return;
+    }
+    MotorCalibration::apply(motor_calib, motor_lf);
+    MotorCalibration::apply(motor_calib, motor_lr);
+    MotorCalibration::apply(motor_calib, motor_rf);
+    MotorCalibration::apply(motor_calib, motor_rr);
+}
+
 /**
  * @brief 执行传感器校准
  */
 void performCalibration() {
     system_state = SystemState::CALIBRATING;
 
-    Debug_Printf("\r\n========== 开始校准 ==========\r\n");
+    // 校准期间由失效保护接管，立即停车
+    arbiter->submitStop(MotionSource::FAILSAFE, MotionArbiter::LEASE_FOREVER);
+    arbiter->update();
+
+    LOG_I(SYSTEM, "\r\n========== 开始校准 ==========\r\n");
 
     // 进入校准界面（阻塞流程下主动刷新一次显示）
     if (g_oled.isInitialized()) {
@@ -342,9 +455,9 @@ void performCalibration() {
 
     // 保存到EEPROM
     if (line_sensor.saveCalibration(eeprom)) {
-        Debug_Printf("[校准] 保存成功\r\n");
+        LOG_I(SYSTEM, "[校准] 保存成功\r\n");
     } else {
-        Debug_Printf("[校准] 保存失败\r\n");
+        LOG_E(SYSTEM, "[校准] 保存失败\r\n");
     }
 
     // 重新初始化控制器
@@ -353,10 +466,25 @@ void performCalibration() {
         follower->resetPID();
     }
 
-    Debug_Printf("========== 校准完成 ==========\r\n\r\n");
+    pose.reset();
+    arbiter->release(MotionSource::FAILSAFE);
+
+    LOG_I(SYSTEM, "========== 校准完成 ==========\r\n\r\n");
     HAL_Delay(500);
 }
 
+/**
+ * @brief 位姿估计：用本周期实际输出的轮速积分，巡线接管时用线位置修正
+ * @param dt_ms 距上次控制周期的时间
+ */
+void updatePose(uint32_t dt_ms) {
+    pose.predict(drive_train->getLeftOutputQ8(), drive_train->getRightOutputQ8(), dt_ms);
+    if (follower->getState() == LineFollowerPID::State::RUNNING &&
+        arbiter->getActiveSource() == MotionSource::LINE_FOLLOWER) {
+        pose.observeLine(static_cast<int32_t>(follower->getPosition()));
+    }
+}
+
 /**
  * @brief 更新OLED显示
  */
@@ -401,8 +529,15 @@ void updateOLEDDisplay() {
     snprintf(line, sizeof(line), "L:%d R:%d", left_speed, right_speed);
     g_oled.printLine(0, line);
 
-    // 第1行：位置和误差（显示实际值，乘以1000以显示整数）
-    snprintf(line, sizeof(line), "P:%4d E:%4d", (int)(position), (int)(error));
+    // 第1行：沿线距离（cm）和横向偏差（mm）
+    snprintf(line, sizeof(line), "S:%ldcm D:%ld", (long)(pose.getDistance() / 10),
+             (long)pose.getCrossTrack());
+    g_oled.printLine(1, line);
+
+    // 第2行：位置、误差和供电电压
+    const uint16_t supply_mv = supply.getSupplyMillivolts();
+    snprintf(line, sizeof(line), "P:%4d E:%4d %d.%dV", (int)(position), (int)(error),
+             supply_mv / 1000, (supply_mv % 1000) / 100);
     g_oled.printLine(2, line);
 
     // 第2-4行：传感器位图（使用Follower缓存，避免重复采样）
@@ -484,10 +619,8 @@ void SystemClock_Config(void) {
 }
 
 void Error_Handler(void) {
-    __disable_irq();
-    while (1) {
-        // 可以添加LED闪烁指示错误
-    }
+    // 保存调用位置和崩溃前日志后复位，下次启动时输出报告
+    CrashDump_OnError(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(__builtin_return_address(0))));
 }
 
 void HAL_MspInit(void) {
@@ -498,7 +631,7 @@ void HAL_MspInit(void) {
 
 #ifdef USE_FULL_ASSERT
 void assert_failed(uint8_t* file, uint32_t line) {
-    Debug_Printf("Assert failed: %s:%lu\r\n", file, line);
+    LOG_E(SYSTEM, "Assert failed: %s:%lu\r\n", file, line);
 }
 #endif
 
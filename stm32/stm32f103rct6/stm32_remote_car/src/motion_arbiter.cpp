@@ -0,0 +1,150 @@
+/**
+ * @file    motion_arbiter.cpp
+ * @brief   运动指令仲裁器实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "motion_arbiter.hpp"
+
+#include "debug.hpp"
+#include "flight_recorder.hpp"
+#include "latency_probe.hpp"
+#include "stm32f1xx_hal.h"
+
+namespace {
+
+const char* const SOURCE_NAMES[] = {
+    "failsafe", "obstacle", "script", "bt_joystick", "e49_keys", "line_follower",
+};
+static_assert(sizeof(SOURCE_NAMES) / sizeof(SOURCE_NAMES[0]) ==
+                      static_cast<uint8_t>(MotionSource::COUNT),
+              "SOURCE_NAMES与MotionSource不一致");
+
+}  // namespace
+
+MotionArbiter::MotionArbiter(DriveTrain& drive)
+    : drive_(drive), active_(MotionSource::COUNT), switch_count_(0) {
+    for (Slot& slot : slots_) {
+        slot = Slot();
+        slot.mode = Mode::NONE;
+    }
+}
+
+void MotionArbiter::submitTarget(MotionSource source, int32_t straight_q8, int32_t turn_q8,
+                                 uint32_t lease_ms) {
+    store(source, Mode::TARGET, straight_q8, turn_q8, lease_ms);
+}
+
+void MotionArbiter::submitWheels(MotionSource source, int32_t left_q8, int32_t right_q8,
+                                 uint32_t lease_ms) {
+    store(source, Mode::WHEELS, left_q8, right_q8, lease_ms);
+}
+
+void MotionArbiter::submitStop(MotionSource source, uint32_t lease_ms) {
+    store(source, Mode::STOP, 0, 0, lease_ms);
+}
+
+void MotionArbiter::release(MotionSource source) {
+    store(source, Mode::NONE, 0, 0, 0);
+}
+
+/**
+ * @brief 写入指令槽
+ *
+ * 遥控指令可能在串口中断回调里提交，写槽期间关中断，
+ * 保证 update() 不会读到一半新一半旧的指令。
+ */
+void MotionArbiter::store(MotionSource source, Mode mode, int32_t a_q8, int32_t b_q8,
+                          uint32_t lease_ms) {
+    if (source >= MotionSource::COUNT) {
+        return;
+    }
+    Slot slot;
+    slot.mode = mode;
+    slot.a_q8 = a_q8;
+    slot.b_q8 = b_q8;
+    slot.start_ms = HAL_GetTick();
+    slot.lease_ms = lease_ms;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    slots_[static_cast<uint8_t>(source)] = slot;
+    __set_PRIMASK(primask);
+
+    // 巡线每个周期都提交，不记录；其它指令源的每条指令都记录
+    if (source != MotionSource::LINE_FOLLOWER) {
+        FR_RECORD(FrEvent::COMMAND, source, mode);
+        LATENCY_ON_SUBMIT(source);
+    }
+}
+
+bool MotionArbiter::expired(const Slot& slot, uint32_t now) {
+    if (slot.mode == Mode::NONE) {
+        return true;
+    }
+    return slot.lease_ms != LEASE_FOREVER && (now - slot.start_ms) >= slot.lease_ms;
+}
+
+bool MotionArbiter::isActive(MotionSource source) const {
+    if (source >= MotionSource::COUNT) {
+        return false;
+    }
+    return !expired(slots_[static_cast<uint8_t>(source)], HAL_GetTick());
+}
+
+void MotionArbiter::update() {
+    uint32_t now = HAL_GetTick();
+
+    // 按优先级找第一个有效指令（拷贝出来，避免中断中途改写）
+    MotionSource winner = MotionSource::COUNT;
+    Slot command = Slot();
+    command.mode = Mode::NONE;
+    for (uint8_t i = 0; i < static_cast<uint8_t>(MotionSource::COUNT); i++) {
+        uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        Slot slot = slots_[i];
+        __set_PRIMASK(primask);
+
+        if (!expired(slot, now)) {
+            winner = static_cast<MotionSource>(i);
+            command = slot;
+            break;
+        }
+    }
+
+    if (winner != active_) {
+        switch_count_++;
+        LOG_D(DRIVE, "[Arbiter] %s -> %s\r\n", sourceName(active_), sourceName(winner));
+        FR_RECORD(FrEvent::SOURCE_SWITCH, winner, active_);
+        active_ = winner;
+    }
+    LATENCY_ON_ARBITER(winner);
+
+    // 唯一的执行路径
+    switch (command.mode) {
+        case Mode::TARGET:
+            drive_.setTargetSpeedQ8(command.a_q8, command.b_q8);
+            drive_.update();
+            break;
+        case Mode::WHEELS:
+            drive_.driveWheelsQ8(command.a_q8, command.b_q8);
+            break;
+        case Mode::STOP:
+            drive_.stop();
+            break;
+        case Mode::NONE:
+        default:
+            // 无人控制：按速度剖面平滑减速到0
+            drive_.setTargetSpeedQ8(0, 0);
+            drive_.update();
+            break;
+    }
+}
+
+const char* MotionArbiter::sourceName(MotionSource source) {
+    if (source >= MotionSource::COUNT) {
+        return "none";
+    }
+    return SOURCE_NAMES[static_cast<uint8_t>(source)];
+}
@@ -0,0 +1,341 @@
+/**
+ * @file    motion_script.cpp
+ * @brief   运动脚本解释器实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "motion_script.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "debug.hpp"
+#include "fixed_math.hpp"
+#include "stm32f1xx_hal.h"
+
+namespace {
+
+/// 单次 update() 最多连续执行的指令数（防止空循环体卡住主循环）
+constexpr uint8_t MAX_STEPS_PER_UPDATE = 8;
+
+bool speedInRange(int8_t speed) {
+    return speed >= -100 && speed <= 100;
+}
+
+}  // namespace
+
+MotionScript::MotionScript(MotionArbiter& arbiter, const PoseEstimator& pose)
+    : arbiter_(arbiter),
+      pose_(pose),
+      length_(0),
+      state_(State::IDLE),
+      pc_(0),
+      entered_(false),
+      step_start_ms_(0),
+      step_start_mm_(0),
+      turned_(0),
+      last_heading_(0),
+      left_line_(false),
+      loop_depth_(0) {
+    memset(code_, 0, sizeof(code_));
+    memset(&spot_model_, 0, sizeof(spot_model_));
+    memset(loops_, 0, sizeof(loops_));
+}
+
+uint8_t MotionScript::instructionLength(uint8_t op) {
+    switch (static_cast<Op>(op)) {
+        case Op::END:
+        case Op::NEXT:
+            return 1;
+        case Op::REPEAT:
+            return 2;
+        case Op::FOLLOW_TO_MARKER:
+        case Op::WAIT:
+            return 3;
+        case Op::SPOT_UNTIL_LINE:
+        case Op::SPOT_ANGLE:
+            return 4;
+        case Op::DRIVE_TIME:
+        case Op::DRIVE_DIST:
+        case Op::ARC:
+            return 5;
+        default:
+            return 0;
+    }
+}
+
+bool MotionScript::validate(const uint8_t* code, uint8_t length) {
+    if (code == nullptr || length == 0 || length > MAX_LENGTH) {
+        return false;
+    }
+
+    uint8_t depth = 0;
+    uint8_t pc = 0;
+    uint8_t prev_op = static_cast<uint8_t>(Op::END);
+    while (pc < length) {
+        uint8_t size = instructionLength(code[pc]);
+        if (size == 0 || pc + size > length) {
+            return false;
+        }
+
+        // 参数在 size 检查之后读取，不会越界
+        switch (static_cast<Op>(code[pc])) {
+            case Op::DRIVE_TIME:
+            case Op::DRIVE_DIST:
+                if (!speedInRange(static_cast<int8_t>(code[pc + 1])) ||
+                    !speedInRange(static_cast<int8_t>(code[pc + 2]))) {
+                    return false;
+                }
+                break;
+            case Op::ARC:
+                if (!speedInRange(static_cast<int8_t>(code[pc + 1])) || code[pc + 2] == 0) {
+                    return false;
+                }
+                break;
+            case Op::SPOT_UNTIL_LINE:
+            case Op::SPOT_ANGLE:
+                if (!speedInRange(static_cast<int8_t>(code[pc + 1]))) return false;
+                break;
+            case Op::REPEAT:
+                if (++depth > MAX_LOOP_DEPTH) return false;
+                break;
+            case Op::NEXT:
+                // 空循环体没有意义，REPEAT 0 时还会原地空转
+                if (depth == 0 || prev_op == static_cast<uint8_t>(Op::REPEAT)) return false;
+                depth--;
+                break;
+            default:
+                break;
+        }
+        prev_op = code[pc];
+        pc += size;
+    }
+    return depth == 0;
+}
+
+bool MotionScript::load(const uint8_t* code, uint8_t length) {
+    if (!validate(code, length)) {
+        LOG_W(SCRIPT, "[Script] 字节码非法（%d字节）\r\n", length);
+        return false;
+    }
+    abort();
+    memcpy(code_, code, length);
+    length_ = length;
+    return true;
+}
+
+bool MotionScript::append(const uint8_t* code, uint8_t length) {
+    if (code == nullptr || length_ + length > MAX_LENGTH) {
+        return false;
+    }
+    abort();
+    memcpy(code_ + length_, code, length);
+    length_ += length;
+    return true;
+}
+
+void MotionScript::clear() {
+    abort();
+    length_ = 0;
+}
+
+bool MotionScript::start() {
+    if (!validate(code_, length_)) {
+        LOG_W(SCRIPT, "[Script] 无法启动：脚本为空或非法\r\n");
+        state_ = State::ERROR;
+        return false;
+    }
+    pc_ = 0;
+    loop_depth_ = 0;
+    entered_ = false;
+    state_ = State::RUNNING;
+    LOG_I(SCRIPT, "[Script] 开始执行（%d字节）\r\n", length_);
+    return true;
+}
+
+void MotionScript::abort() {
+    if (state_ == State::RUNNING) {
+        finish(State::IDLE);
+    }
+}
+
+void MotionScript::finish(State state) {
+    arbiter_.release(MotionSource::SCRIPT);
+    state_ = state;
+    if (state == State::ERROR) {
+        LOG_W(SCRIPT, "[Script] 失败 pc=%d op=0x%02X\r\n", pc_, code_[pc_]);
+    } else {
+        LOG_I(SCRIPT, "[Script] %s pc=%d\r\n", state == State::DONE ? "完成" : "中止", pc_);
+    }
+}
+
+void MotionScript::update(const Inputs& inputs) {
+    if (state_ != State::RUNNING) {
+        return;
+    }
+
+    const uint32_t now = HAL_GetTick();
+    for (uint8_t i = 0; i < MAX_STEPS_PER_UPDATE; i++) {
+        if (pc_ >= length_ || code_[pc_] == static_cast<uint8_t>(Op::END)) {
+            finish(State::DONE);
+            return;
+        }
+
+        Step step = execute(inputs, now);
+        if (step == Step::BUSY) {
+            return;
+        }
+        if (step == Step::FAIL) {
+            finish(State::ERROR);
+            return;
+        }
+        // NEXT 跳回循环体时自己设置 pc_，其他情况顺序执行
+        if (step == Step::NEXT) {
+            pc_ += instructionLength(code_[pc_]);
+        }
+        entered_ = false;
+    }
+}
+
+/**
+ * @brief 执行当前指令一个周期
+ *
+ * 指令第一次执行时记录起始时间、距离和航向，之后每个周期续约指令并检查结束条件。
+ */
+MotionScript::Step MotionScript::execute(const Inputs& inputs, uint32_t now) {
+    if (!entered_) {
+        entered_ = true;
+        step_start_ms_ = now;
+        step_start_mm_ = pose_.getPathLength();
+        turned_ = 0;
+        last_heading_ = pose_.getHeading();
+        left_line_ = false;
+    }
+    const uint32_t elapsed = now - step_start_ms_;
+
+    switch (static_cast<Op>(code_[pc_])) {
+        case Op::DRIVE_TIME:
+            arbiter_.submitTarget(MotionSource::SCRIPT, argI8(1) * fixed_math::Q8_ONE,
+                                  argI8(2) * fixed_math::Q8_ONE, LEASE_MS);
+            return (elapsed >= argU16(3)) ? Step::NEXT : Step::BUSY;
+
+        case Op::DRIVE_DIST: {
+            arbiter_.submitTarget(MotionSource::SCRIPT, argI8(1) * fixed_math::Q8_ONE,
+                                  argI8(2) * fixed_math::Q8_ONE, LEASE_MS);
+            // 累计路程：ARC/原地转向后沿线距离几乎不再增加，不能用来计量
+            int32_t travelled = pose_.getPathLength() - step_start_mm_;
+            return (travelled >= argU16(3)) ? Step::NEXT : Step::BUSY;
+        }
+
+        case Op::ARC: {
+            // 内外轮速度按半径比例分配：v·(R∓W/2)/R，超过100%时等比缩小
+            const int32_t speed = argI8(1) * fixed_math::Q8_ONE;
+            const int32_t radius = argI8(2) * 10;
+            const int32_t half_track = pose_.getParams().track_mm / 2;
+            int32_t left = speed * (radius - half_track) / radius;
+            int32_t right = speed * (radius + half_track) / radius;
+            const int32_t peak = std::max(std::abs(left), std::abs(right));
+            if (peak > 100 * fixed_math::Q8_ONE) {
+                left = static_cast<int32_t>(static_cast<int64_t>(left) * 100 * fixed_math::Q8_ONE / peak);
+                right = static_cast<int32_t>(static_cast<int64_t>(right) * 100 * fixed_math::Q8_ONE / peak);
+            }
+            arbiter_.submitWheels(MotionSource::SCRIPT, left, right, LEASE_MS);
+
+            const uint16_t heading = pose_.getHeading();
+            turned_ += static_cast<int16_t>(heading - last_heading_);
+            last_heading_ = heading;
+            const int32_t goal = static_cast<int32_t>(argU16(3)) * fixed_math::ANGLE_FULL_TURN / 360;
+            return (std::abs(turned_) >= goal) ? Step::NEXT : Step::BUSY;
+        }
+
+        case Op::SPOT_UNTIL_LINE: {
+            const int32_t turn = argI8(1) * fixed_math::Q8_ONE;
+            arbiter_.submitWheels(MotionSource::SCRIPT, -turn, turn, LEASE_MS);
+            if (!inputs.line_seen) {
+                left_line_ = true;
+            } else if (left_line_) {
+                return Step::NEXT;
+            }
+            const uint16_t timeout = argU16(2);
+            return (timeout != 0 && elapsed >= timeout) ? Step::FAIL : Step::BUSY;
+        }
+
+        case Op::SPOT_ANGLE: {
+            // 开环：按标定的 ω = gain·(|cmd| − min) 算转动时间
+            const int32_t turn = argI8(1) * fixed_math::Q8_ONE;
+            const uint32_t duration = SpotTurnCalibration::durationFor(spot_model_, turn, argU16(2));
+            if (duration == 0 && argU16(2) != 0) {
+                return Step::FAIL;
+            }
+            arbiter_.submitWheels(MotionSource::SCRIPT, -turn, turn, LEASE_MS);
+            return (elapsed >= duration) ? Step::NEXT : Step::BUSY;
+        }
+
+        case Op::FOLLOW_TO_MARKER: {
+            // 让出控制权，由低优先级指令源（巡线）驱动，只等标记
+            arbiter_.release(MotionSource::SCRIPT);
+            if (!inputs.marker) {
+                left_line_ = true;
+            } else if (left_line_) {
+                return Step::NEXT;
+            }
+            const uint16_t timeout = argU16(1);
+            return (timeout != 0 && elapsed >= timeout) ? Step::FAIL : Step::BUSY;
+        }
+
+        case Op::WAIT:
+            arbiter_.submitTarget(MotionSource::SCRIPT, 0, 0, LEASE_MS);
+            return (elapsed >= argU16(1)) ? Step::NEXT : Step::BUSY;
+
+        case Op::REPEAT:
+            if (loop_depth_ >= MAX_LOOP_DEPTH) {
+                return Step::FAIL;
+            }
+            loops_[loop_depth_].body_pc = pc_ + instructionLength(code_[pc_]);
+            loops_[loop_depth_].remaining = argU8(1);
+            loop_depth_++;
+            return Step::NEXT;
+
+        case Op::NEXT: {
+            if (loop_depth_ == 0) {
+                return Step::FAIL;
+            }
+            Loop& loop = loops_[loop_depth_ - 1];
+            if (loop.remaining == 0 || --loop.remaining > 0) {
+                pc_ = loop.body_pc;
+                return Step::JUMP;
+            }
+            loop_depth_--;
+            return Step::NEXT;
+        }
+
+        default:
+            return Step::FAIL;
+    }
+}
+
+bool MotionScript::saveToEEPROM(EEPROM& eeprom) const {
+    MotionScriptData data;
+    memset(&data, 0, sizeof(data));
+    data.magic_number = MAGIC;
+    data.length = length_;
+    memcpy(data.code, code_, length_);
+
+    if (!eeprom.writeStructCRC(EEPROM_ADDR, data)) {
+        LOG_E(SCRIPT, "[Script] 脚本保存失败！\r\n");
+        return false;
+    }
+    LOG_I(SCRIPT, "[Script] 脚本已保存（地址0x%02X，%d字节）\r\n", EEPROM_ADDR, length_);
+    return true;
+}
+
+bool MotionScript::loadFromEEPROM(EEPROM& eeprom) {
+    MotionScriptData data;
+    if (!eeprom.readStructCRC(EEPROM_ADDR, data) || data.magic_number != MAGIC) {
+        LOG_I(SCRIPT, "[Script] EEPROM中没有脚本\r\n");
+        return false;
+    }
+    return load(data.code, data.length);
+}
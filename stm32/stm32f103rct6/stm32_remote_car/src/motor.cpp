@@ -8,54 +8,207 @@
  */
 
 #include "../include/motor.hpp"
+#include "tim.h"
+#include "latency_probe.hpp"
+
+namespace {
+constexpr uint16_t NEUTRAL_PULSE_US = 1500;
+constexpr uint16_t MIN_PULSE_US = 500;
+constexpr uint16_t MAX_PULSE_US = 2500;
+constexpr uint16_t FRAME_GUARD_US = 100;   // Minimum low time left in each frame
+}
 
 Motor::Motor(TIM_HandleTypeDef* htim, uint32_t channel)
-        : htim_(htim), channel_(channel), initialized_(true) {}
+        : htim_(htim), channel_(channel), initialized_(true) {
+    configureTiming();
+}
 
 void Motor::init(TIM_HandleTypeDef* htim, uint32_t channel) {
     htim_ = htim;
     channel_ = channel;
     initialized_ = true;
-    __HAL_TIM_SET_COMPARE(htim_, channel_, 1500);
+    configureTiming();
+    pulse_ = toTicks(NEUTRAL_PULSE_US);
+    __HAL_TIM_SET_COMPARE(htim_, channel_, pulse_);
+}
+
+/**
+ * @brief Derive pulse scaling and limits from the timer configuration
+ *
+ * The timer must already be initialized (MX_TIM3_Init), so the frame rate
+ * chosen in tim.h is picked up automatically.
+ */
+void Motor::configureTiming() {
+    ticks_per_us_ = static_cast<uint8_t>(TIM_PWM_TicksPerUs(htim_));
+    uint32_t frame_us = TIM_PWM_FrameUs(htim_);
+    max_pulse_us_ = MAX_PULSE_US;
+    if (frame_us < MAX_PULSE_US + FRAME_GUARD_US) {
+        max_pulse_us_ = static_cast<uint16_t>(frame_us - FRAME_GUARD_US);
+    }
+}
+
+uint16_t Motor::toTicks(uint16_t pulse_us) const {
+    return toTicksQ8(static_cast<int32_t>(pulse_us) * fixed_math::Q8_ONE);
+}
+
+/**
+ * @brief Clamp a Q8 pulse width and round it to the nearest timer tick
+ *
+ * At 3+ ticks/us this keeps sub-microsecond resolution, so small speed
+ * corrections are no longer lost to 2.5us steps.
+ */
+uint16_t Motor::toTicksQ8(int32_t pulse_q8) const {
+    const int32_t lo = static_cast<int32_t>(MIN_PULSE_US) * fixed_math::Q8_ONE;
+    const int32_t hi = static_cast<int32_t>(max_pulse_us_) * fixed_math::Q8_ONE;
+    pulse_q8 = fixed_math::clamp(pulse_q8, lo, hi);
+    return static_cast<uint16_t>((pulse_q8 * ticks_per_us_ + fixed_math::Q8_ONE / 2) / fixed_math::Q8_ONE);
 }
 
 /**
  * @brief Set motor speed
  * @param speed Speed range: -100 to 100
  * 
- * PWM pulse calculation:
+ * PWM pulse calculation (uncalibrated):
  * - Neutral (stop): 1500us
  * - Forward max (+100): 1750us (1500 + 100 * 5/2)
  * - Reverse max (-100): 1250us (1500 - 100 * 5/2)
+ *
+ * The pulse width is converted to timer ticks for the frame rate
+ * configured in tim.h (SERVO_PWM_FRAME_HZ).
+ *
+ * With a calibrated curve the pulse is interpolated from the curve instead,
+ * see pulseForSpeedQ8().
  */
 void Motor::setSpeed(int speed) {
+    setSpeedQ8(speed * fixed_math::Q8_ONE);
+}
+
+void Motor::setSpeedQ8(int32_t speed_q8) {
     if (!initialized_) {
         return;
     }
-    __HAL_TIM_SET_COMPARE(htim_, channel_, 1500 + speed * 5 / 2);
-    speed_ = speed;
+    __HAL_TIM_SET_COMPARE(htim_, channel_, stageSpeedQ8(speed_q8));
+}
+
+uint16_t Motor::stageSpeed(int speed) {
+    return stageSpeedQ8(speed * fixed_math::Q8_ONE);
+}
+
+uint16_t Motor::stageSpeedQ8(int32_t speed_q8) {
+    speed_q8 = fixed_math::clamp(speed_q8, -100 * fixed_math::Q8_ONE, 100 * fixed_math::Q8_ONE);
+    pulse_ = toTicksQ8(pulseForSpeedQ8(speed_q8));
+    speed_q8_ = speed_q8;
+    return pulse_;
+}
+
+void Motor::stageStop() {
+    pulse_ = toTicks(NEUTRAL_PULSE_US);
+    speed_q8_ = 0;
+}
+
+/**
+ * @brief Write staged pulses of a group of motors together
+ *
+ * The first motor's timer gets a single CCR1..CCR4 burst; channels not in the
+ * group keep their current compare value. Motors on any other timer fall back
+ * to individual writes (still preloaded, so they latch on their own update).
+ */
+void Motor::commit(Motor* const motors[], uint8_t count) {
+    TIM_HandleTypeDef* htim = nullptr;
+    uint16_t pulses[4];
+
+    for (uint8_t i = 0; i < count; i++) {
+        Motor* m = motors[i];
+        if (!m->initialized_) {
+            continue;
+        }
+        if (htim == nullptr) {
+            htim = m->htim_;
+            pulses[0] = static_cast<uint16_t>(htim->Instance->CCR1);
+            pulses[1] = static_cast<uint16_t>(htim->Instance->CCR2);
+            pulses[2] = static_cast<uint16_t>(htim->Instance->CCR3);
+            pulses[3] = static_cast<uint16_t>(htim->Instance->CCR4);
+        }
+        if (m->htim_ == htim) {
+            pulses[m->channelIndex()] = m->pulse_;
+        } else {
+            __HAL_TIM_SET_COMPARE(m->htim_, m->channel_, m->pulse_);
+        }
+    }
+
+    if (htim != nullptr) {
+        TIM_PWM_CommitPulses(htim, pulses);
+        LATENCY_ON_PWM(htim);
+    }
 }
 
 void Motor::maxSpeed() {
     if (!initialized_) {
         return;
     }
-    __HAL_TIM_SET_COMPARE(htim_, channel_, 1750);
-    speed_ = 100;
+    __HAL_TIM_SET_COMPARE(htim_, channel_, stageSpeed(100));
 }
 
 void Motor::reverse() {
     if (!initialized_) {
         return;
     }
-    __HAL_TIM_SET_COMPARE(htim_, channel_, 1500 - speed_ * 5 / 2);
-    speed_ = -speed_;
+    __HAL_TIM_SET_COMPARE(htim_, channel_, stageSpeedQ8(-speed_q8_));
 }
 
 void Motor::stop() {
     if (!initialized_) {
         return;
     }
-    __HAL_TIM_SET_COMPARE(htim_, channel_, 1500);
-    speed_ = 0;
+    stageStop();
+    __HAL_TIM_SET_COMPARE(htim_, channel_, pulse_);
+}
+
+void Motor::setPulseWidth(uint16_t pulse_us) {
+    if (!initialized_) {
+        return;
+    }
+    pulse_ = toTicks(pulse_us);
+    __HAL_TIM_SET_COMPARE(htim_, channel_, pulse_);
+}
+
+void Motor::setCurve(const MotorCurve& curve) {
+    curve_ = curve;
+    has_curve_ = true;
+}
+
+void Motor::clearCurve() {
+    has_curve_ = false;
+}
+
+/**
+ * @brief Map a Q8 speed command to a Q8 pulse width (1/256 us)
+ *
+ * Speed 0 is always the neutral pulse. Any other speed is interpolated
+ * between the curve points of its direction, so |speed| in (0, 25] lands
+ * between the dead-band edge and the 25% point.
+ */
+int32_t Motor::pulseForSpeedQ8(int32_t speed_q8) const {
+    const int32_t neutral_q8 = static_cast<int32_t>(NEUTRAL_PULSE_US) * fixed_math::Q8_ONE;
+    if (!has_curve_) {
+        return neutral_q8 + speed_q8 * 5 / 2;
+    }
+    if (speed_q8 == 0) {
+        return neutral_q8;
+    }
+
+    const uint8_t* points = (speed_q8 > 0) ? curve_.forward : curve_.reverse;
+    int32_t magnitude = (speed_q8 > 0) ? speed_q8 : -speed_q8;
+    const int32_t step_q8 = MotorCurve::STEP * fixed_math::Q8_ONE;
+
+    int32_t segment = magnitude / step_q8;
+    if (segment >= MotorCurve::POINTS - 1) {
+        segment = MotorCurve::POINTS - 2;
+    }
+    int32_t lower = points[segment];
+    int32_t upper = points[segment + 1];
+    int32_t offset_q8 = lower * fixed_math::Q8_ONE +
+                        (upper - lower) * (magnitude - segment * step_q8) / MotorCurve::STEP;
+
+    return (speed_q8 > 0) ? neutral_q8 + offset_q8 : neutral_q8 - offset_q8;
 }
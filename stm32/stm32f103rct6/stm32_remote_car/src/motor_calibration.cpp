@@ -0,0 +1,84 @@
+/**
+ * @file    motor_calibration.cpp
+ * @brief   舵机电机速度曲线校准实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "motor_calibration.hpp"
+#include "debug.hpp"
+
+bool MotorCalibration::load(EEPROM& eeprom, MotorCalibrationData& data) {
+    if (!eeprom.readStructCRC(EEPROM_ADDR, data)) {
+        LOG_W(MOTOR, "[MotorCal] CRC校验失败或数据未初始化，使用线性曲线\r\n");
+        return false;
+    }
+    if (data.magic_number != MAGIC) {
+        LOG_W(MOTOR, "[MotorCal] 魔术数字不匹配，使用线性曲线\r\n");
+        return false;
+    }
+    LOG_I(MOTOR, "[MotorCal] 电机曲线加载成功\r\n");
+    return true;
+}
+
+bool MotorCalibration::save(EEPROM& eeprom, const MotorCalibrationData& data) {
+    if (!eeprom.writeStructCRC(EEPROM_ADDR, data)) {
+        LOG_E(MOTOR, "[MotorCal] 电机曲线保存失败！\r\n");
+        return false;
+    }
+    LOG_I(MOTOR, "[MotorCal] 电机曲线已保存（地址0x%02X，%d字节含CRC）\r\n", EEPROM_ADDR,
+                 sizeof(data) + 1);
+    return true;
+}
+
+void MotorCalibration::apply(const MotorCalibrationData& data, Motor& motor) {
+    uint8_t index = motor.channelIndex();
+    if (index < 4) {
+        motor.setCurve(data.curves[index]);
+    }
+}
+
+void MotorCalibration::makeLinear(MotorCurve& curve) {
+    for (uint8_t i = 0; i < MotorCurve::POINTS; i++) {
+        uint8_t offset = static_cast<uint8_t>(i * MotorCurve::STEP * 5 / 2);
+        curve.forward[i] = offset;
+        curve.reverse[i] = offset;
+    }
+}
+
+bool MotorCalibration::fitDirection(const uint16_t* offsets_us, const float* rpm, uint8_t count,
+                                    float full_scale_rpm, uint8_t out[MotorCurve::POINTS]) {
+    if (count < 2 || full_scale_rpm <= 0.0f) {
+        return false;
+    }
+
+    // 第0点：死区边缘
+    out[0] = static_cast<uint8_t>(offsets_us[0] > MAX_OFFSET_US ? MAX_OFFSET_US : offsets_us[0]);
+
+    uint8_t seg = 0;
+    for (uint8_t k = 1; k < MotorCurve::POINTS; k++) {
+        float target = full_scale_rpm * k / (MotorCurve::POINTS - 1);
+
+        // 找到包含目标转速的区间（实测曲线按单调处理）
+        while (seg + 1 < count - 1 && rpm[seg + 1] < target) {
+            seg++;
+        }
+        float r0 = rpm[seg];
+        float r1 = rpm[seg + 1];
+        if (r1 < target - 0.5f || r1 <= r0) {
+            return false;
+        }
+
+        float t = (target - r0) / (r1 - r0);
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+        float offset = offsets_us[seg] + t * (offsets_us[seg + 1] - offsets_us[seg]);
+        if (offset > MAX_OFFSET_US) offset = MAX_OFFSET_US;
+
+        out[k] = static_cast<uint8_t>(offset + 0.5f);
+        if (out[k] < out[k - 1]) {
+            out[k] = out[k - 1];
+        }
+    }
+    return true;
+}
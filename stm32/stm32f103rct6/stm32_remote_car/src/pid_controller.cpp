@@ -64,6 +64,20 @@ float PIDController::compute(float setpoint, float input) {
  * @brief 计算PID输出（使用自定义时间间隔）
  */
 float PIDController::compute(float setpoint, float input, float dt) {
+    return computeImpl(setpoint, input, dt, nullptr);
+}
+
+/**
+ * @brief 计算PID输出（由外部提供测量值变化率）
+ */
+float PIDController::compute(float setpoint, float input, float input_rate, float dt) {
+    return computeImpl(setpoint, input, dt, &input_rate);
+}
+
+/**
+ * @brief PID计算主体
+ */
+float PIDController::computeImpl(float setpoint, float input, float dt, const float* input_rate) {
     // 如果是手动模式，直接返回当前输出
     if (mode_ == Mode::MANUAL) {
         return output_;
@@ -116,7 +130,10 @@ float PIDController::compute(float setpoint, float input, float dt) {
     
     // === 微分项 ===
     // 使用 derivative on measurement 避免setpoint突变导致的微分冲击
-    if (first_run_) {
+    if (input_rate != nullptr) {
+        // 外部估计器已给出平滑的变化率，无需差分
+        derivative_ = -kd_ * (*input_rate);
+    } else if (first_run_) {
         derivative_ = 0.0f;
     } else {
         // 计算测量值的变化率（取负是因为我们要的是error的导数）
@@ -124,7 +141,9 @@ float PIDController::compute(float setpoint, float input, float dt) {
     }
     
     // 微分滤波（低通滤波）
-    if (d_filter_alpha_ > 0.0f) {
+    if (input_rate != nullptr) {
+        d_term_ = derivative_;
+    } else if (d_filter_alpha_ > 0.0f) {
         if (first_run_) {
             filtered_derivative_ = derivative_;
         } else {
@@ -0,0 +1,132 @@
+/**
+ * @file    pose_estimator.cpp
+ * @brief   航位推算位姿估计实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "pose_estimator.hpp"
+
+#include "fixed_math.hpp"
+
+namespace {
+
+/// 1弧度对应的32位二进制角度：2^32 / (2π)
+constexpr int64_t ANGLE_PER_RADIAN = 683565276;
+
+/// Q8毫米乘Q15三角函数值
+inline int32_t mulQ15(int32_t value_q8, int16_t trig_q15) {
+    return static_cast<int32_t>((static_cast<int64_t>(value_q8) * trig_q15) >> 15);
+}
+
+}  // namespace
+
+PoseEstimator::Params PoseEstimator::defaultParams() {
+    Params p;
+    p.full_scale_mm_s = 600;
+    p.tau_ms = 120;
+    p.deadband_pct = 3;
+    p.track_mm = 130;
+    p.sensor_lead_mm = 60;
+    p.sensor_half_width_mm = 35;
+    p.lateral_gain_q8 = 64;   // 0.25
+    p.heading_gain_q8 = 16;   // 0.06
+    return p;
+}
+
+PoseEstimator::PoseEstimator() : params_(defaultParams()) {
+    reset();
+}
+
+void PoseEstimator::setParams(const Params& params) {
+    params_ = params;
+    if (params_.track_mm == 0) params_.track_mm = 1;
+    if (params_.sensor_lead_mm == 0) params_.sensor_lead_mm = 1;
+}
+
+void PoseEstimator::reset() {
+    v_left_q8_ = 0;
+    v_right_q8_ = 0;
+    x_q8_ = 0;
+    y_q8_ = 0;
+    heading_ = 0;
+    distance_q8_ = 0;
+    path_q8_ = 0;
+    cross_q8_ = 0;
+    line_heading_ = 0;
+    step_remainder_ = 0;
+}
+
+/**
+ * @brief 指令 → 稳态轮速（Q8 mm/s）
+ *
+ * 电机曲线已由 MotorCurve 校准为线性，这里只保留死区和满量程比例。
+ */
+int32_t PoseEstimator::wheelTarget(int32_t command_q8) const {
+    int32_t magnitude = (command_q8 >= 0) ? command_q8 : -command_q8;
+    if (magnitude < params_.deadband_pct * fixed_math::Q8_ONE) {
+        return 0;
+    }
+    return command_q8 * params_.full_scale_mm_s / 100;
+}
+
+/**
+ * @brief 一阶滞后离散化：v += (target - v) · dt / (τ + dt)
+ */
+int32_t PoseEstimator::applyLag(int32_t speed_q8, int32_t target_q8, uint32_t dt_ms) const {
+    int64_t delta = static_cast<int64_t>(target_q8 - speed_q8) * dt_ms;
+    return speed_q8 + static_cast<int32_t>(delta / (params_.tau_ms + dt_ms));
+}
+
+void PoseEstimator::predict(int32_t left_q8, int32_t right_q8, uint32_t dt_ms) {
+    if (dt_ms == 0) {
+        return;
+    }
+
+    v_left_q8_ = applyLag(v_left_q8_, wheelTarget(left_q8), dt_ms);
+    v_right_q8_ = applyLag(v_right_q8_, wheelTarget(right_q8), dt_ms);
+
+    // 位移（Q8 mm），余数保留到下一帧，低速时不丢失
+    int32_t velocity_sum = v_left_q8_ + v_right_q8_;
+    int32_t numerator = velocity_sum * static_cast<int32_t>(dt_ms) + step_remainder_;
+    int32_t step_q8 = numerator / 2000;
+    step_remainder_ = numerator - step_q8 * 2000;
+    path_q8_ += (step_q8 >= 0) ? step_q8 : -step_q8;
+
+    // 航向增量：(v_r - v_l)·dt / 轮距，换算为32位二进制角度
+    int64_t turn = static_cast<int64_t>(v_right_q8_ - v_left_q8_) * dt_ms * ANGLE_PER_RADIAN;
+    int32_t dtheta = static_cast<int32_t>(turn / (static_cast<int64_t>(params_.track_mm) * 1000 * 256));
+
+    // 用半步航向积分（中点法），弧线上误差更小
+    uint16_t mid = static_cast<uint16_t>((heading_ + static_cast<uint32_t>(dtheta / 2)) >> 16);
+    x_q8_ += mulQ15(step_q8, fixed_math::cosQ15(mid));
+    y_q8_ += mulQ15(step_q8, fixed_math::sinQ15(mid));
+    heading_ += static_cast<uint32_t>(dtheta);
+
+    // 赛道坐标系
+    uint16_t mid_line = static_cast<uint16_t>((line_heading_ + static_cast<uint32_t>(dtheta / 2)) >> 16);
+    distance_q8_ += mulQ15(step_q8, fixed_math::cosQ15(mid_line));
+    cross_q8_ += mulQ15(step_q8, fixed_math::sinQ15(mid_line));
+    line_heading_ += static_cast<uint32_t>(dtheta);
+}
+
+void PoseEstimator::observeLine(int32_t position) {
+    const int32_t lead_q8 = static_cast<int32_t>(params_.sensor_lead_mm) * fixed_math::Q8_ONE;
+
+    // 观测模型：传感器处横向偏差 = d + L·sinψ
+    int32_t measured_q8 = position * params_.sensor_half_width_mm * fixed_math::Q8_ONE / 1000;
+    int32_t predicted_q8 = cross_q8_ + mulQ15(lead_q8, fixed_math::sinQ15(line_heading_ >> 16));
+    int32_t residual_q8 = measured_q8 - predicted_q8;
+
+    cross_q8_ += residual_q8 * params_.lateral_gain_q8 / 256;
+
+    // ψ修正：残差 / L（弧度）× β
+    int64_t correction = static_cast<int64_t>(residual_q8) * params_.heading_gain_q8 * ANGLE_PER_RADIAN;
+    line_heading_ += static_cast<uint32_t>(static_cast<int32_t>(correction / (static_cast<int64_t>(lead_q8) * 256)));
+}
+
+int16_t PoseEstimator::angleToDeg(uint32_t angle) {
+    // 按有符号角度换算到 -180..180
+    int32_t signed_angle = static_cast<int32_t>(angle);
+    return static_cast<int16_t>((static_cast<int64_t>(signed_angle) * 360) >> 32);
+}
@@ -55,7 +55,10 @@ void RemoteControl::init() {
 /**
  * @brief 更新函数（主循环中调用）
  */
-void RemoteControl::update() { checkTimeout(); }
+void RemoteControl::update() {
+    wireless_.poll();
+    checkTimeout();
+}
 
 /**
  * @brief 设置超时时间
@@ -163,7 +166,7 @@ void RemoteControl::handleCommand(char command) {
                 }
             }
             currentTargetTurnSpeed_ = 0;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
@@ -179,7 +182,7 @@ void RemoteControl::handleCommand(char command) {
                 }
             }
             currentTargetTurnSpeed_ = 0;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
@@ -195,7 +198,7 @@ void RemoteControl::handleCommand(char command) {
                 }
             }
             currentTargetStraightSpeed_ = 0;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
@@ -211,14 +214,14 @@ void RemoteControl::handleCommand(char command) {
                 }
             }
             currentTargetStraightSpeed_ = 0;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
         case 'U':  // 上（直接最大速度）
             currentTargetStraightSpeed_ = maxSpeed_;
             currentTargetTurnSpeed_ = 0;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
@@ -235,7 +238,7 @@ void RemoteControl::handleCommand(char command) {
                 }
             }
             currentTargetTurnSpeed_ = -(currentTargetStraightSpeed_ * turnSensitivity_) / 100;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
@@ -249,7 +252,7 @@ void RemoteControl::handleCommand(char command) {
                 }
             }
             currentTargetTurnSpeed_ = (currentTargetStraightSpeed_ * turnSensitivity_) / 100;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
@@ -263,7 +266,7 @@ void RemoteControl::handleCommand(char command) {
                 }
             }
             currentTargetTurnSpeed_ = (currentTargetStraightSpeed_ * turnSensitivity_) / 100;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
@@ -277,7 +280,7 @@ void RemoteControl::handleCommand(char command) {
                 }
             }
             currentTargetTurnSpeed_ = -(currentTargetStraightSpeed_ * turnSensitivity_) / 100;
-            driveTrain_.setTargetSpeed(currentTargetStraightSpeed_, currentTargetTurnSpeed_);
+            applyTarget(currentTargetStraightSpeed_, currentTargetTurnSpeed_, MotionSource::E49_KEYS);
             isMoving_ = true;
             break;
 
@@ -309,8 +312,13 @@ void RemoteControl::stop() {
     currentTargetStraightSpeed_ = 0;
     currentTargetTurnSpeed_ = 0;
     
-    // 设置目标速度为0，让梯形速度轮廓平滑减速
-    driveTrain_.setTargetSpeed(0, 0);
+    // 设置目标速度为0，让速度轮廓平滑减速；经仲裁器时撤销租期，由低优先级指令源接管
+    if (arbiter_ != nullptr) {
+        arbiter_->release(MotionSource::E49_KEYS);
+        arbiter_->release(MotionSource::BT_JOYSTICK);
+    } else {
+        driveTrain_.setTargetSpeed(0, 0);
+    }
     isMoving_ = false;
     
     // LED 调试：停止状态全灭
@@ -332,6 +340,19 @@ void RemoteControl::handleJoystickSpeeds(int straightSpeed, int turnSpeed)
     if (limitedTurn > maxSpeed_) limitedTurn = maxSpeed_;
     if (limitedTurn < -maxSpeed_) limitedTurn = -maxSpeed_;
 
-    // 设置目标速度（梯形速度轮廓会平滑到该目标）
-    driveTrain_.setTargetSpeed(limitedStraight, limitedTurn);
+    // 设置目标速度（速度轮廓会平滑到该目标）
+    applyTarget(limitedStraight, limitedTurn, MotionSource::BT_JOYSTICK);
+}
+
+/**
+ * @brief 输出目标速度
+ */
+void RemoteControl::applyTarget(int straightSpeed, int turnSpeed, MotionSource source)
+{
+    if (arbiter_ != nullptr) {
+        arbiter_->submitTarget(source, straightSpeed * fixed_math::Q8_ONE,
+                               turnSpeed * fixed_math::Q8_ONE, timeout_);
+        return;
+    }
+    driveTrain_.setTargetSpeed(straightSpeed, turnSpeed);
 }
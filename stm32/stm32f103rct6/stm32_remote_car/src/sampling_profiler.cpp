@@ -0,0 +1,112 @@
+/**
+ * @file    sampling_profiler.cpp
+ * @brief   统计采样分析器实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "sampling_profiler.hpp"
+
+#if PROFILER_SAMPLING_ENABLE
+
+#include "debug.hpp"
+#include "stm32f1xx_hal.h"
+
+namespace {
+
+constexpr uint32_t FLASH_START = FLASH_BASE;
+constexpr uint32_t FLASH_SPAN = 256u * 1024u;  // STM32F103RC
+constexpr uint32_t BUCKET_COUNT = FLASH_SPAN >> PROFILER_BUCKET_SHIFT;
+
+uint16_t buckets[BUCKET_COUNT];
+volatile uint32_t total_samples = 0;
+volatile uint32_t other_samples = 0;   // PC不在Flash中（RAM函数等）
+uint32_t configured_hz = 0;
+
+}  // namespace
+
+extern "C" void SamplingProfiler_OnTick(uint32_t* frame) {
+    TIM7->SR = (uint32_t)~TIM_SR_UIF;
+
+    uint32_t pc = frame[6];
+    uint32_t offset = pc - FLASH_START;
+    if (offset < FLASH_SPAN) {
+        uint16_t& bucket = buckets[offset >> PROFILER_BUCKET_SHIFT];
+        if (bucket != UINT16_MAX) {
+            bucket++;
+        }
+    } else {
+        other_samples++;
+    }
+    total_samples++;
+}
+
+namespace SamplingProfiler {
+
+void init(uint32_t sample_hz) {
+    if (sample_hz == 0) {
+        return;
+    }
+    configured_hz = sample_hz;
+    reset();
+
+    // TIM7：APB1定时器时钟72MHz，预分频到1MHz
+    __HAL_RCC_TIM7_CLK_ENABLE();
+    TIM7->CR1 = 0;
+    TIM7->PSC = (SystemCoreClock / 1000000u) - 1;
+    TIM7->ARR = (1000000u / sample_hz) - 1;
+    TIM7->EGR = TIM_EGR_UG;
+    TIM7->SR = 0;
+    TIM7->DIER = TIM_DIER_UIE;
+
+    HAL_NVIC_SetPriority(TIM7_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(TIM7_IRQn);
+
+    start();
+}
+
+void start() {
+    TIM7->CR1 |= TIM_CR1_CEN;
+}
+
+void stop() {
+    TIM7->CR1 &= ~TIM_CR1_CEN;
+}
+
+void reset() {
+    bool running = (TIM7->CR1 & TIM_CR1_CEN) != 0;
+    stop();
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] = 0;
+    }
+    total_samples = 0;
+    other_samples = 0;
+    if (running) {
+        start();
+    }
+}
+
+void dump() {
+    stop();
+
+    Debug_Print_Always("\r\nPROFILE BEGIN base=0x%08lX shift=%d hz=%lu samples=%lu other=%lu\r\n",
+                       (unsigned long)FLASH_START, PROFILER_BUCKET_SHIFT,
+                       (unsigned long)configured_hz, (unsigned long)total_samples,
+                       (unsigned long)other_samples);
+    for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+        if (buckets[i] != 0) {
+            // 每行等发送缓冲清空，避免上千行直方图被丢弃
+            Debug_Flush(100);
+            Debug_Print_Always("0x%08lX %u\r\n",
+                               (unsigned long)(FLASH_START + (i << PROFILER_BUCKET_SHIFT)),
+                               buckets[i]);
+        }
+    }
+    Debug_Print_Always("PROFILE END\r\n");
+
+    start();
+}
+
+}  // namespace SamplingProfiler
+
+#endif  // PROFILER_SAMPLING_ENABLE
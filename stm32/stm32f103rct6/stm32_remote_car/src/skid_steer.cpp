@@ -0,0 +1,81 @@
+/**
+ * @file    skid_steer.cpp
+ * @brief   四轮滑移转向混合实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "skid_steer.hpp"
+
+#include <cstdlib>
+
+#include "fixed_math.hpp"
+
+namespace skid_steer {
+
+namespace {
+
+/**
+ * @brief 车轮接地速度 sqrt(v_x² + v_y²)
+ */
+int64_t groundSpeed(int32_t vx, int32_t vy) {
+    const uint64_t sq = static_cast<uint64_t>(static_cast<int64_t>(vx) * vx) +
+                        static_cast<uint64_t>(static_cast<int64_t>(vy) * vy);
+    return fixed_math::isqrt64(sq);
+}
+
+/**
+ * @brief 同侧前后分配：两轮平均仍为 v_x，按各自接地速度 sqrt(v_x² + v_y²) 的比例拉开
+ *
+ * 差值与 v_x 成正比，v_x 过零时连续；前后 |v_y| 相同时不拉开。
+ */
+void splitAxles(int32_t vx, int32_t vy_front, int32_t vy_rear, int32_t blend_pct,
+                int32_t& front, int32_t& rear) {
+    const int64_t mag_front = groundSpeed(vx, vy_front);
+    const int64_t mag_rear = groundSpeed(vx, vy_rear);
+    const int64_t sum = mag_front + mag_rear;
+    if (sum == 0) {
+        front = rear = vx;
+        return;
+    }
+    const int32_t delta =
+        static_cast<int32_t>(static_cast<int64_t>(vx) * (mag_front - mag_rear) * blend_pct / (sum * 100));
+    front = vx + delta;
+    rear = vx - delta;
+}
+
+}  // namespace
+
+WheelSpeeds mix(const Geometry& geo, int32_t left_q8, int32_t right_q8) {
+    WheelSpeeds out = {left_q8, left_q8, right_q8, right_q8};
+    if (geo.blend_pct == 0 || geo.track_mm == 0 || left_q8 == right_q8) {
+        return out;
+    }
+
+    // ω·d = (v_r − v_l)·d / track，d 为车轮到 ICR 的纵向距离
+    const int32_t blend = geo.blend_pct > 100 ? 100 : geo.blend_pct;
+    const int64_t diff = static_cast<int64_t>(right_q8) - left_q8;
+    const int32_t front_arm = geo.wheelbase_mm / 2 - geo.icr_offset_mm;
+    const int32_t rear_arm = -static_cast<int32_t>(geo.wheelbase_mm / 2) - geo.icr_offset_mm;
+    const int32_t vy_front = static_cast<int32_t>(diff * front_arm / geo.track_mm);
+    const int32_t vy_rear = static_cast<int32_t>(diff * rear_arm / geo.track_mm);
+
+    splitAxles(left_q8, vy_front, vy_rear, blend, out.left_front, out.left_rear);
+    splitAxles(right_q8, vy_front, vy_rear, blend, out.right_front, out.right_rear);
+
+    // 超出量程时四轮等比缩小，保持转弯半径
+    const int32_t limit = 100 * fixed_math::Q8_ONE;
+    int32_t peak = std::abs(out.left_front);
+    if (std::abs(out.left_rear) > peak) peak = std::abs(out.left_rear);
+    if (std::abs(out.right_front) > peak) peak = std::abs(out.right_front);
+    if (std::abs(out.right_rear) > peak) peak = std::abs(out.right_rear);
+    if (peak > limit) {
+        out.left_front = static_cast<int32_t>(static_cast<int64_t>(out.left_front) * limit / peak);
+        out.left_rear = static_cast<int32_t>(static_cast<int64_t>(out.left_rear) * limit / peak);
+        out.right_front = static_cast<int32_t>(static_cast<int64_t>(out.right_front) * limit / peak);
+        out.right_rear = static_cast<int32_t>(static_cast<int64_t>(out.right_rear) * limit / peak);
+    }
+    return out;
+}
+
+}  // namespace skid_steer
@@ -0,0 +1,111 @@
+/**
+ * @file    spot_turn_calibration.cpp
+ * @brief   原地转向牵引力校准实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "spot_turn_calibration.hpp"
+
+#include <cstdlib>
+
+#include "debug.hpp"
+#include "fixed_math.hpp"
+
+bool SpotTurnCalibration::load(EEPROM& eeprom, SpotTurnCalibrationData& data) {
+    if (!eeprom.readStructCRC(EEPROM_ADDR, data)) {
+        LOG_W(DRIVE, "[SpotTurn] CRC校验失败或数据未初始化，使用默认参数\r\n");
+        return false;
+    }
+    if (!isValid(data)) {
+        LOG_W(DRIVE, "[SpotTurn] 魔术数字不匹配，使用默认参数\r\n");
+        return false;
+    }
+    LOG_I(DRIVE, "[SpotTurn] 原地转向模型加载成功\r\n");
+    return true;
+}
+
+bool SpotTurnCalibration::save(EEPROM& eeprom, const SpotTurnCalibrationData& data) {
+    if (!eeprom.writeStructCRC(EEPROM_ADDR, data)) {
+        LOG_E(DRIVE, "[SpotTurn] 原地转向模型保存失败！\r\n");
+        return false;
+    }
+    LOG_I(DRIVE, "[SpotTurn] 原地转向模型已保存（地址0x%02X，%d字节含CRC）\r\n", EEPROM_ADDR,
+                 sizeof(data) + 1);
+    return true;
+}
+
+void SpotTurnCalibration::apply(const SpotTurnCalibrationData& data, DriveTrain& drive) {
+    if (isValid(data)) {
+        drive.setMinSpotTurnSpeedQ8(data.min_speed_q8);
+    }
+}
+
+bool SpotTurnCalibration::fit(const uint8_t commands[], const uint16_t rates[], uint8_t count,
+                              SpotTurnCalibrationData& out) {
+    // 只用转动了的点做线性回归 rate = a·cmd + b
+    float n = 0.0f, sx = 0.0f, sy = 0.0f, sxx = 0.0f, sxy = 0.0f;
+    for (uint8_t i = 0; i < count; i++) {
+        if (rates[i] == 0) {
+            continue;
+        }
+        float x = commands[i];
+        float y = rates[i];
+        n += 1.0f;
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    if (n < 2.0f) {
+        return false;
+    }
+    float denom = n * sxx - sx * sx;
+    if (denom <= 0.0f) {
+        return false;
+    }
+    float a = (n * sxy - sx * sy) / denom;
+    float b = (sy - a * sx) / n;
+    if (a <= 0.0f) {
+        return false;
+    }
+
+    float min_speed = -b / a;
+    if (min_speed < 0.0f) min_speed = 0.0f;
+    if (min_speed > 90.0f) {
+        return false;
+    }
+
+    out.magic_number = MAGIC;
+    out.min_speed_q8 = static_cast<int16_t>(fixed_math::toQ8(min_speed));
+    out.gain_q8 = static_cast<uint16_t>(fixed_math::clamp(fixed_math::toQ8(a), 1, 65535));
+    return true;
+}
+
+uint16_t SpotTurnCalibration::crossingRate(uint8_t crossings, uint32_t elapsed_ms) {
+    if (crossings < 2 || elapsed_ms == 0) {
+        return 0;
+    }
+    uint32_t rate = 180u * 1000u * (crossings - 1u) / elapsed_ms;
+    return static_cast<uint16_t>(rate > 65535u ? 65535u : rate);
+}
+
+uint32_t SpotTurnCalibration::rateFor(const SpotTurnCalibrationData& data, int32_t command_q8) {
+    int32_t excess = std::abs(command_q8) - data.min_speed_q8;
+    if (excess <= 0) {
+        return 0;
+    }
+    // (1/256 deg/s 每 1%) × (1/256 %) → deg/s
+    return static_cast<uint32_t>((static_cast<uint64_t>(data.gain_q8) * excess) >> 16);
+}
+
+uint32_t SpotTurnCalibration::durationFor(const SpotTurnCalibrationData& data, int32_t command_q8,
+                                          uint16_t angle_deg) {
+    int32_t excess = std::abs(command_q8) - data.min_speed_q8;
+    if (!isValid(data) || excess <= 0) {
+        return 0;
+    }
+    // t = angle / ω，全程保留Q16精度
+    uint64_t rate_q16 = static_cast<uint64_t>(data.gain_q8) * excess;
+    return static_cast<uint32_t>((static_cast<uint64_t>(angle_deg) * 1000u << 16) / rate_q16);
+}
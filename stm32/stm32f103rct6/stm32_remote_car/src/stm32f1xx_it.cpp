@@ -9,6 +9,32 @@
 
 #include "../include/common.h"
 #include "../include/usart.h"
+#include "../include/debug.hpp"
+#include "../include/crash_dump.hpp"
+#include "../include/sampling_profiler.hpp"
+
+/**
+ * 故障入口前导（裸函数内使用）：
+ * 根据EXC_RETURN取出被打断代码的栈帧（MSP/PSP），把MSP复位到栈顶
+ * （栈溢出引起的故障也能继续运行C代码），然后跳转到 CrashDump_OnFault(frame, exc_return, cause)
+ */
+#define CRASH_FAULT_ENTRY(cause)                \
+    __asm volatile(                             \
+        "tst lr, #4                  \n"        \
+        "ite eq                      \n"        \
+        "mrseq r0, msp               \n"        \
+        "mrsne r0, psp               \n"        \
+        "mov r1, lr                  \n"        \
+        "ldr r2, =_estack            \n"        \
+        "mov sp, r2                  \n"        \
+        "movs r2, #" #cause "        \n"        \
+        "b CrashDump_OnFault         \n")
+
+static_assert(static_cast<int>(CrashCause::HARD_FAULT) == 1 &&
+              static_cast<int>(CrashCause::MEM_MANAGE) == 2 &&
+              static_cast<int>(CrashCause::BUS_FAULT) == 3 &&
+              static_cast<int>(CrashCause::USAGE_FAULT) == 4,
+              "CRASH_FAULT_ENTRY 的编号与 CrashCause 不一致");
 
 #ifdef __cplusplus
 extern "C" {
@@ -29,47 +55,39 @@ void NMI_Handler(void)
 
 /**
  * @brief  硬件错误中断处理函数
+ * @note   保存现场到 .noinit 后复位，下次启动时输出报告（见 crash_dump.hpp）
  * @retval None
  */
-void HardFault_Handler(void)
+__attribute__((naked)) void HardFault_Handler(void)
 {
-    /* 硬件错误处理：进入无限循环 */
-    while (1) {
-        /* 空循环 */
-    }
+    CRASH_FAULT_ENTRY(1);
 }
 
 /**
  * @brief  内存管理错误中断处理函数
  * @retval None
  */
-void MemManage_Handler(void)
+__attribute__((naked)) void MemManage_Handler(void)
 {
-    /* 内存管理错误处理：进入无限循环 */
-    while (1) {
-    }
+    CRASH_FAULT_ENTRY(2);
 }
 
 /**
  * @brief  总线错误中断处理函数
  * @retval None
  */
-void BusFault_Handler(void)
+__attribute__((naked)) void BusFault_Handler(void)
 {
-    /* 总线错误处理：进入无限循环 */
-    while (1) {
-    }
+    CRASH_FAULT_ENTRY(3);
 }
 
 /**
  * @brief  用法错误中断处理函数
  * @retval None
  */
-void UsageFault_Handler(void)
+__attribute__((naked)) void UsageFault_Handler(void)
 {
-    /* 用法错误处理：进入无限循环 */
-    while (1) {
-    }
+    CRASH_FAULT_ENTRY(4);
 }
 
 /**
@@ -117,6 +135,8 @@ void USART1_IRQHandler(void)
 {
     /* USART1中断处理：调用HAL库处理函数 */
     HAL_UART_IRQHandler(&huart1);
+    /* 调试输出：上一段发送完成或有新数据时启动下一段DMA */
+    Debug_TxService(&huart1);
 }
 
 /**
@@ -127,8 +147,54 @@ void USART2_IRQHandler(void)
 {
     /* USART2中断处理：调用HAL库处理函数 */
     HAL_UART_IRQHandler(&huart2);
+    Debug_TxService(&huart2);
 }
 
+/**
+ * @brief  DMA1通道4中断处理函数（USART1_TX）
+ * @retval None
+ */
+void DMA1_Channel4_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_usart1_tx);
+}
+
+/**
+ * @brief  DMA1通道6中断处理函数（USART2_RX，半满/满时交出已接收的数据）
+ * @retval None
+ */
+void DMA1_Channel6_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_usart2_rx);
+}
+
+/**
+ * @brief  DMA1通道7中断处理函数（USART2_TX）
+ * @retval None
+ */
+void DMA1_Channel7_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&hdma_usart2_tx);
+}
+
+#if PROFILER_SAMPLING_ENABLE
+/**
+ * @brief  TIM7中断处理函数（采样分析器）
+ * @note   裸函数：根据EXC_RETURN取出被打断代码使用的栈（MSP/PSP），
+ *         把栈帧地址作为参数交给 SamplingProfiler_OnTick，栈帧第7个字即被打断时的PC
+ * @retval None
+ */
+__attribute__((naked)) void TIM7_IRQHandler(void)
+{
+    __asm volatile(
+        "tst lr, #4                  \n"
+        "ite eq                      \n"
+        "mrseq r0, msp               \n"
+        "mrsne r0, psp               \n"
+        "b SamplingProfiler_OnTick   \n");
+}
+#endif
+
 #ifdef __cplusplus
 }
 #endif
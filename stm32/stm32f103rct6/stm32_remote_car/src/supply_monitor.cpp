@@ -0,0 +1,153 @@
+/**
+ * @file    supply_monitor.cpp
+ * @brief   电源电压监测与轮速补偿实现
+ * @author  AI Assistant
+ * @date    2024
+ */
+
+#include "supply_monitor.hpp"
+
+#include <cstdlib>
+
+#include "adc.h"
+#include "debug.hpp"
+#include "fixed_math.hpp"
+#include "stm32f1xx_hal.h"
+
+SupplyMonitor::SupplyMonitor()
+    : valid_(false),
+      compensation_enabled_(true),
+      last_sample_ms_(0),
+      vdda_acc_(0),
+      battery_acc_(0),
+      divider_top_kohm_(20),
+      divider_bottom_kohm_(10),
+      nominal_mv_(0),
+      gain_q8_(fixed_math::Q8_ONE) {}
+
+bool SupplyMonitor::init() {
+    uint16_t vdda_mv = 0;
+    uint16_t battery_mv = 0;
+    last_sample_ms_ = HAL_GetTick();
+    if (!sample(vdda_mv, battery_mv)) {
+        valid_ = false;
+        gain_q8_ = fixed_math::Q8_ONE;
+        LOG_W(POWER, "[电源] Vrefint 采样失败，不做电压补偿\r\n");
+        return false;
+    }
+
+    vdda_acc_ = static_cast<uint32_t>(vdda_mv) << FILTER_SHIFT;
+    battery_acc_ = static_cast<uint32_t>(battery_mv) << FILTER_SHIFT;
+    valid_ = true;
+    if (nominal_mv_ == 0) {
+        nominal_mv_ = getSupplyMillivolts();
+    }
+    updateGain();
+
+    LOG_I(POWER, "[电源] VDDA %dmV 电池 %dmV 标称 %dmV\r\n", getVddaMillivolts(),
+                 getBatteryMillivolts(), nominal_mv_);
+    return true;
+}
+
+void SupplyMonitor::update() {
+    const uint32_t now = HAL_GetTick();
+    if (now - last_sample_ms_ < SAMPLE_INTERVAL_MS) {
+        return;
+    }
+    last_sample_ms_ = now;
+
+    uint16_t vdda_mv = 0;
+    uint16_t battery_mv = 0;
+    if (!sample(vdda_mv, battery_mv)) {
+        return;  // 偶尔超时保持上次结果
+    }
+    if (!valid_) {
+        // init() 失败后首次采样成功：直接初始化滤波器
+        vdda_acc_ = static_cast<uint32_t>(vdda_mv) << FILTER_SHIFT;
+        battery_acc_ = static_cast<uint32_t>(battery_mv) << FILTER_SHIFT;
+        valid_ = true;
+        if (nominal_mv_ == 0) {
+            nominal_mv_ = getSupplyMillivolts();
+        }
+    } else {
+        // acc += x − acc/16
+        vdda_acc_ = vdda_acc_ - (vdda_acc_ >> FILTER_SHIFT) + vdda_mv;
+        battery_acc_ = battery_acc_ - (battery_acc_ >> FILTER_SHIFT) + battery_mv;
+    }
+    updateGain();
+}
+
+void SupplyMonitor::setBatteryDivider(uint16_t top_kohm, uint16_t bottom_kohm) {
+    if (bottom_kohm == 0) {
+        return;
+    }
+    divider_top_kohm_ = top_kohm;
+    divider_bottom_kohm_ = bottom_kohm;
+}
+
+void SupplyMonitor::setNominalMillivolts(uint16_t mv) {
+    nominal_mv_ = mv;
+    if (nominal_mv_ == 0 && valid_) {
+        nominal_mv_ = getSupplyMillivolts();
+    }
+    updateGain();
+}
+
+void SupplyMonitor::setCompensationEnabled(bool enable) {
+    compensation_enabled_ = enable;
+    updateGain();
+}
+
+uint16_t SupplyMonitor::getSupplyMillivolts() const {
+#if ADC_BATTERY_ENABLE
+    return getBatteryMillivolts();
+#else
+    return getVddaMillivolts();
+#endif
+}
+
+void SupplyMonitor::compensate(int32_t& left_q8, int32_t& right_q8) const {
+    if (gain_q8_ == fixed_math::Q8_ONE) {
+        return;
+    }
+    left_q8 = static_cast<int32_t>((static_cast<int64_t>(left_q8) * gain_q8_) / fixed_math::Q8_ONE);
+    right_q8 = static_cast<int32_t>((static_cast<int64_t>(right_q8) * gain_q8_) / fixed_math::Q8_ONE);
+
+    // 超出量程时等比缩小，保持左右比例（转弯半径）不变
+    const int32_t limit = 100 * fixed_math::Q8_ONE;
+    const int32_t peak = std::abs(left_q8) > std::abs(right_q8) ? std::abs(left_q8) : std::abs(right_q8);
+    if (peak > limit) {
+        left_q8 = static_cast<int32_t>(static_cast<int64_t>(left_q8) * limit / peak);
+        right_q8 = static_cast<int32_t>(static_cast<int64_t>(right_q8) * limit / peak);
+    }
+}
+
+bool SupplyMonitor::sample(uint16_t& vdda_mv, uint16_t& battery_mv) const {
+    uint16_t raw_vref = 0;
+    uint16_t raw_bat = 0;
+    if (!ADC_ReadSupply(&raw_vref, &raw_bat)) {
+        return false;
+    }
+    // VDDA 在 2.0~3.6V 之间时 raw_vrefint 约 1365~2457，超出视为读数异常
+    if (raw_vref < 1000 || raw_vref > 3000) {
+        return false;
+    }
+
+    vdda_mv = static_cast<uint16_t>(static_cast<uint32_t>(VREFINT_MV) * 4095u / raw_vref);
+
+    // 分压点电压 = raw_bat × 1200 / raw_vref，VDDA 的误差在这里抵消
+    const uint32_t pin_mv = static_cast<uint32_t>(raw_bat) * VREFINT_MV / raw_vref;
+    const uint32_t bat_mv = pin_mv * (divider_top_kohm_ + divider_bottom_kohm_) / divider_bottom_kohm_;
+    battery_mv = static_cast<uint16_t>(bat_mv > 0xFFFFu ? 0xFFFFu : bat_mv);
+    return true;
+}
+
+void SupplyMonitor::updateGain() {
+    const uint16_t supply_mv = getSupplyMillivolts();
+    if (!compensation_enabled_ || !valid_ || nominal_mv_ == 0 || supply_mv == 0) {
+        gain_q8_ = fixed_math::Q8_ONE;
+        return;
+    }
+    const int32_t gain = static_cast<int32_t>(static_cast<uint32_t>(nominal_mv_) * fixed_math::Q8_ONE / supply_mv);
+    gain_q8_ = fixed_math::clamp(gain, MIN_GAIN_Q8, MAX_GAIN_Q8);
+}
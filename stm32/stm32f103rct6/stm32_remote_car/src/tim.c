@@ -22,6 +22,45 @@
 
 /* USER CODE BEGIN 0 */
 
+/* 命令到脉冲延迟统计（单位：定时器tick） */
+static volatile uint32_t pwm_latency_count;
+static volatile uint64_t pwm_latency_sum;  /* 32位累加约24分钟即回绕 */
+static volatile uint32_t pwm_latency_max;
+static volatile uint32_t pwm_latency_last;
+
+/**
+ * @brief TIM3 counter clock (APB1 timer clock)
+ */
+static uint32_t TIM3_ClockHz(void)
+{
+  uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+  /* APB1 prescaler != 1 doubles the timer clock */
+  if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1)
+  {
+    pclk1 *= 2U;
+  }
+  return pclk1;
+}
+
+/**
+ * @brief Pick the finest tick that still fits one frame into the 16-bit ARR
+ * @param clock_hz Timer clock
+ * @param frame_hz Servo frame rate
+ * @return Ticks per microsecond (a divisor of clock_hz / 1MHz)
+ */
+static uint32_t TIM3_TicksPerUs(uint32_t clock_hz, uint32_t frame_hz)
+{
+  uint32_t clock_mhz = clock_hz / 1000000U;
+  uint32_t frame_us = 1000000U / frame_hz;
+  uint32_t ticks = clock_mhz;
+
+  while (ticks > 1U && (frame_us * ticks > 65536U || (clock_mhz % ticks) != 0U))
+  {
+    ticks--;
+  }
+  return ticks;
+}
+
 /* USER CODE END 0 */
 
 TIM_HandleTypeDef htim3;
@@ -39,14 +78,15 @@ void MX_TIM3_Init(void)
   TIM_OC_InitTypeDef sConfigOC = {0};
 
   /* USER CODE BEGIN TIM3_Init 1 */
-
+  uint32_t clock_mhz = TIM3_ClockHz() / 1000000U;
+  uint32_t ticks_per_us = TIM3_TicksPerUs(TIM3_ClockHz(), SERVO_PWM_FRAME_HZ);
   /* USER CODE END TIM3_Init 1 */
   htim3.Instance = TIM3;
-  htim3.Init.Prescaler = 71;
+  htim3.Init.Prescaler = clock_mhz / ticks_per_us - 1U;
   htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim3.Init.Period = 20000;
+  htim3.Init.Period = (1000000U / SERVO_PWM_FRAME_HZ) * ticks_per_us - 1U;
   htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-  htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
   if (HAL_TIM_Base_Init(&htim3) != HAL_OK)
   {
     Error_Handler();
@@ -67,7 +107,7 @@ void MX_TIM3_Init(void)
     Error_Handler();
   }
   sConfigOC.OCMode = TIM_OCMODE_PWM1;
-  sConfigOC.Pulse = 1500;
+  sConfigOC.Pulse = 1500U * ticks_per_us;
   sConfigOC.OCPolarity = TIM_OCPOLARITY_LOW;
   sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
   if (HAL_TIM_PWM_ConfigChannel(&htim3, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
@@ -157,4 +197,69 @@ void HAL_TIM_Base_MspDeInit(TIM_HandleTypeDef* tim_baseHandle)
 
 /* USER CODE BEGIN 1 */
 
+/**
+ * @brief Write CCR1..CCR4 in one burst that latches at a single update event
+ * @param htim Pointer to TIM handle (channels configured with OC preload)
+ * @param pulses Compare values for CH1..CH4
+ *
+ * With OCxPE set the writes go to the preload registers. UDIS is held while
+ * the four stores run, so an update event landing mid-burst cannot latch a
+ * mix of old and new values; at worst the whole set is applied one frame
+ * later. CCR1..CCR4 are consecutive registers, so this is four back-to-back
+ * stores with no HAL channel dispatch.
+ */
+void TIM_PWM_CommitPulses(TIM_HandleTypeDef *htim, const uint16_t pulses[4])
+{
+  TIM_TypeDef *tim = htim->Instance;
+  volatile uint32_t *ccr = &tim->CCR1;
+  uint32_t wait;
+
+  tim->CR1 |= TIM_CR1_UDIS;
+  ccr[0] = pulses[0];
+  ccr[1] = pulses[1];
+  ccr[2] = pulses[2];
+  ccr[3] = pulses[3];
+  /* 距下一个更新事件（新脉宽开始输出）的剩余tick */
+  wait = tim->ARR + 1U - tim->CNT;
+  tim->CR1 &= ~TIM_CR1_UDIS;
+
+  pwm_latency_last = wait;
+  pwm_latency_sum += wait;
+  pwm_latency_count++;
+  if (wait > pwm_latency_max)
+  {
+    pwm_latency_max = wait;
+  }
+}
+
+uint32_t TIM_PWM_TicksPerUs(const TIM_HandleTypeDef *htim)
+{
+  return TIM3_ClockHz() / (htim->Instance->PSC + 1U) / 1000000U;
+}
+
+uint32_t TIM_PWM_FrameUs(const TIM_HandleTypeDef *htim)
+{
+  return (htim->Instance->ARR + 1U) / TIM_PWM_TicksPerUs(htim);
+}
+
+void TIM_PWM_GetLatency(const TIM_HandleTypeDef *htim, TIM_PWM_Latency *out)
+{
+  uint32_t ticks_per_us = TIM_PWM_TicksPerUs(htim);
+  uint32_t count = pwm_latency_count;
+
+  out->count = count;
+  out->last_us = pwm_latency_last / ticks_per_us;
+  out->max_us = pwm_latency_max / ticks_per_us;
+  out->avg_us = (count != 0U) ? (uint32_t)(pwm_latency_sum / count) / ticks_per_us : 0U;
+  out->frame_us = TIM_PWM_FrameUs(htim);
+}
+
+void TIM_PWM_ResetLatency(void)
+{
+  pwm_latency_count = 0U;
+  pwm_latency_sum = 0U;
+  pwm_latency_max = 0U;
+  pwm_latency_last = 0U;
+}
+
 /* USER CODE END 1 */
@@ -10,10 +10,11 @@
  * - PA10 (USART1_RX) -> E49 TXD
  * - 波特率：9600, 8N1
  * 
- * USART2 (调试串口输出):
+ * USART2 (调试串口输出 / ESP32-S3蓝牙模块):
  * - PA2  (USART2_TX) -> USB转TTL RXD
  * - PA3  (USART2_RX) -> USB转TTL TXD
  * - 波特率：115200, 8N1
+ * - RX DMA: DMA1_Channel6（循环模式，配合空闲线中断整段接收，见 BluetoothControl）
  */
 
 #include "usart.h"
@@ -25,6 +26,74 @@
 UART_HandleTypeDef huart1;
 UART_HandleTypeDef huart2;
 
+/* TX DMA 句柄（调试输出非阻塞发送） */
+DMA_HandleTypeDef hdma_usart1_tx;
+DMA_HandleTypeDef hdma_usart2_tx;
+
+/* RX DMA 句柄（蓝牙指令整段接收） */
+DMA_HandleTypeDef hdma_usart2_rx;
+
+/**
+ * @brief 配置串口TX DMA（内存到外设，单次模式）
+ * @param uartHandle 串口句柄
+ * @param hdma DMA句柄
+ * @param channel DMA通道（USART1_TX=DMA1_Channel4，USART2_TX=DMA1_Channel7）
+ * @param irq 该通道的中断号
+ */
+static void UART_TxDmaInit(UART_HandleTypeDef* uartHandle, DMA_HandleTypeDef* hdma,
+                           DMA_Channel_TypeDef* channel, IRQn_Type irq)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    
+    hdma->Instance = channel;
+    hdma->Init.Direction = DMA_MEMORY_TO_PERIPH;
+    hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma->Init.MemInc = DMA_MINC_ENABLE;
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma->Init.Mode = DMA_NORMAL;
+    hdma->Init.Priority = DMA_PRIORITY_LOW;               // 低于ADC采样
+    
+    if (HAL_DMA_Init(hdma) != HAL_OK) {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(uartHandle, hdmatx, *hdma);
+    
+    HAL_NVIC_SetPriority(irq, 2, 0);
+    HAL_NVIC_EnableIRQ(irq);
+}
+
+/**
+ * @brief 配置串口RX DMA（外设到内存，循环模式）
+ * @param uartHandle 串口句柄
+ * @param hdma DMA句柄
+ * @param channel DMA通道（USART2_RX=DMA1_Channel6）
+ * @param irq 该通道的中断号
+ * @note 中断优先级与串口中断相同，半满/满（DMA）和空闲线（USART）回调不会互相打断
+ */
+static void UART_RxDmaInit(UART_HandleTypeDef* uartHandle, DMA_HandleTypeDef* hdma,
+                           DMA_Channel_TypeDef* channel, IRQn_Type irq)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+    
+    hdma->Instance = channel;
+    hdma->Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma->Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma->Init.MemInc = DMA_MINC_ENABLE;
+    hdma->Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdma->Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+    hdma->Init.Mode = DMA_CIRCULAR;
+    hdma->Init.Priority = DMA_PRIORITY_MEDIUM;            // 高于TX，低于ADC采样
+    
+    if (HAL_DMA_Init(hdma) != HAL_OK) {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(uartHandle, hdmarx, *hdma);
+    
+    HAL_NVIC_SetPriority(irq, 1, 0);
+    HAL_NVIC_EnableIRQ(irq);
+}
+
 /**
  * @brief USART1初始化
  */
@@ -100,6 +169,9 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
         /* USART1 中断配置 */
         HAL_NVIC_SetPriority(USART1_IRQn, 0, 0);
         HAL_NVIC_EnableIRQ(USART1_IRQn);
+        
+        /* TX DMA: DMA1_Channel4 */
+        UART_TxDmaInit(uartHandle, &hdma_usart1_tx, DMA1_Channel4, DMA1_Channel4_IRQn);
     }
     else if(uartHandle->Instance == USART2)
     {
@@ -128,6 +200,12 @@ void HAL_UART_MspInit(UART_HandleTypeDef* uartHandle)
         /* USART2 中断配置（如果需要接收） */
         HAL_NVIC_SetPriority(USART2_IRQn, 1, 0);
         HAL_NVIC_EnableIRQ(USART2_IRQn);
+        
+        /* TX DMA: DMA1_Channel7 */
+        UART_TxDmaInit(uartHandle, &hdma_usart2_tx, DMA1_Channel7, DMA1_Channel7_IRQn);
+        
+        /* RX DMA: DMA1_Channel6 */
+        UART_RxDmaInit(uartHandle, &hdma_usart2_rx, DMA1_Channel6, DMA1_Channel6_IRQn);
     }
 }
 
@@ -145,8 +223,10 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
         /* 反初始化GPIO */
         HAL_GPIO_DeInit(GPIOA, GPIO_PIN_9|GPIO_PIN_10);
         
-        /* 禁用中断 */
+        /* 禁用中断和DMA */
         HAL_NVIC_DisableIRQ(USART1_IRQn);
+        HAL_DMA_DeInit(uartHandle->hdmatx);
+        HAL_NVIC_DisableIRQ(DMA1_Channel4_IRQn);
     }
     else if(uartHandle->Instance == USART2)
     {
@@ -156,8 +236,12 @@ void HAL_UART_MspDeInit(UART_HandleTypeDef* uartHandle)
         /* 反初始化GPIO */
         HAL_GPIO_DeInit(GPIOA, GPIO_PIN_2|GPIO_PIN_3);
         
-        /* 禁用中断 */
+        /* 禁用中断和DMA */
         HAL_NVIC_DisableIRQ(USART2_IRQn);
+        HAL_DMA_DeInit(uartHandle->hdmatx);
+        HAL_NVIC_DisableIRQ(DMA1_Channel7_IRQn);
+        HAL_DMA_DeInit(uartHandle->hdmarx);
+        HAL_NVIC_DisableIRQ(DMA1_Channel6_IRQn);
     }
 }
 
@@ -0,0 +1,225 @@
+/**
+ * @file    test_bt_protocol.cpp
+ * @brief   蓝牙二进制帧解析单元测试（主机端）
+ * @author  AI Assistant
+ * @date    2024
+ *
+ * @description
+ * FrameParser 是纯逻辑，不依赖HAL，直接在PC上编译运行：
+ *
+ *     g++ -std=c++14 -Iinclude tests/test_bt_protocol.cpp src/bt_protocol.cpp src/crc.cpp -o test_bt_protocol
+ *     ./test_bt_protocol
+ *
+ * 测试：
+ * 1. 正常帧、重发、序号跳变
+ * 2. CRC错误的帧不连带丢失紧随其后的帧
+ * 3. 丢失 LEN 字节（类型/序号字节被当作长度）后重新同步
+ * 4. 杂散 0xAA 之后线路空闲，flushIdle() 丢弃未完成的帧，下一帧正常
+ * 5. 截断的帧后面紧跟完整帧
+ * 6. 帧头后长度非法的字节交还给文本协议
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bt_protocol.hpp"
+
+using bt_protocol::FrameParser;
+using bt_protocol::MsgType;
+
+/* ========== 测试辅助函数 ========== */
+
+/**
+ * @brief 输入结果统计
+ */
+struct FeedLog {
+    int frames;
+    int rejected;
+    int8_t last_straight;
+    uint8_t last_seq;
+};
+
+/**
+ * @brief 逐字节输入，统计得到的帧和交还给文本协议的字节
+ */
+FeedLog feedAll(FrameParser& parser, const uint8_t* data, int len) {
+    FeedLog log = {0, 0, 0, 0};
+    for (int i = 0; i < len; i++) {
+        FrameParser::Result r = parser.feed(data[i]);
+        if (r == FrameParser::Result::FRAME) {
+            log.frames++;
+            log.last_straight = static_cast<int8_t>(parser.frame().payload[0]);
+            log.last_seq = parser.frame().seq;
+        } else if (r == FrameParser::Result::REJECTED) {
+            log.rejected++;
+        }
+    }
+    return log;
+}
+
+/**
+ * @brief 编码一个摇杆帧
+ */
+int joystick(uint8_t seq, int8_t straight, int8_t turn, uint8_t* out) {
+    const uint8_t payload[2] = {static_cast<uint8_t>(straight), static_cast<uint8_t>(turn)};
+    return bt_protocol::encode(MsgType::JOYSTICK, seq, payload, 2, out);
+}
+
+/**
+ * @brief 打印测试结果
+ */
+void print_test_result(const char* test_name, bool passed) {
+    if (passed) {
+        printf("[✓] %s\n", test_name);
+    } else {
+        printf("[✗] %s - FAILED\n", test_name);
+    }
+}
+
+/* ========== 测试用例 ========== */
+
+/**
+ * @brief 测试1: 正常帧、重发、序号跳变
+ */
+bool test_normal_frames() {
+    FrameParser parser;
+    uint8_t buf[64];
+    int n = 0;
+    n += joystick(1, 10, 0, buf + n);
+    n += joystick(1, 10, 0, buf + n);   // 重发
+    n += joystick(4, 40, 0, buf + n);   // 丢了2、3
+
+    FeedLog log = feedAll(parser, buf, n);
+    bool passed = log.frames == 2 && log.last_straight == 40 &&
+                  parser.getDuplicates() == 1 && parser.getLostFrames() == 2 &&
+                  parser.getCrcErrors() == 0 && !parser.busy();
+    print_test_result("正常帧/重发/序号跳变", passed);
+    return passed;
+}
+
+/**
+ * @brief 测试2: CRC错误的帧后面紧跟的帧不丢
+ */
+bool test_crc_error_keeps_next_frame() {
+    FrameParser parser;
+    uint8_t buf[64];
+    int n = 0;
+    n += joystick(1, 10, 0, buf + n);
+    buf[3] ^= 0x01;                     // 损坏载荷
+    n += joystick(2, 20, 0, buf + n);
+
+    FeedLog log = feedAll(parser, buf, n);
+    bool passed = log.frames == 1 && log.last_straight == 20 && parser.getCrcErrors() == 1 && !parser.busy();
+    print_test_result("CRC错误不连带丢帧", passed);
+    return passed;
+}
+
+/**
+ * @brief 测试3: 丢失 LEN 字节后重新同步
+ *
+ * 类型/序号字节 0x13 被当作长度 19：超过 MAX_PAYLOAD+1 时立即丢弃帧头，
+ * 否则解析器等待22个字节才校验CRC，失败后从已收字节中的下一个帧头继续。
+ * 两种情况下之后的四帧都能解出。
+ */
+bool test_lost_length_byte() {
+    FrameParser parser;
+    uint8_t buf[96];
+    int n = 0;
+    uint8_t frame[16];
+    int len = joystick(3, 30, 0, frame);
+    buf[n++] = frame[0];
+    memcpy(buf + n, frame + 2, len - 2);  // 去掉 LEN
+    n += len - 2;
+    for (int i = 0; i < 4; i++) {
+        n += joystick(static_cast<uint8_t>(4 + i), static_cast<int8_t>(40 + i * 10), 0, buf + n);
+    }
+
+    FeedLog log = feedAll(parser, buf, n);
+    bool passed = log.frames == 4 && log.last_straight == 70 && log.last_seq == 7 &&
+                  !parser.busy();
+    printf("  frames=%d crc_errors=%lu\n", log.frames, (unsigned long)parser.getCrcErrors());
+    print_test_result("丢失LEN字节后重新同步", passed);
+    return passed;
+}
+
+/**
+ * @brief 测试4: 杂散 0xAA 后线路空闲，下一帧不被吞掉
+ */
+bool test_stray_sync_then_idle() {
+    FrameParser parser;
+    const uint8_t stray[] = {bt_protocol::FRAME_SYNC, 0x05};
+    FeedLog log = feedAll(parser, stray, sizeof(stray));
+    bool busy_before = parser.busy();
+
+    FrameParser::Result r = parser.flushIdle();
+
+    uint8_t buf[16];
+    int n = joystick(1, 25, 0, buf);
+    FeedLog log2 = feedAll(parser, buf, n);
+
+    bool passed = log.frames == 0 && busy_before && r == FrameParser::Result::PENDING &&
+                  !parser.busy() && parser.getTruncated() == 1 &&
+                  log2.frames == 1 && log2.last_straight == 25;
+    print_test_result("杂散帧头 + 空闲超时", passed);
+    return passed;
+}
+
+/**
+ * @brief 测试5: 截断的帧后面紧跟完整帧（同一次突发中）
+ */
+bool test_truncated_then_frame() {
+    FrameParser parser;
+    uint8_t buf[64];
+    uint8_t frame[16];
+    int len = joystick(1, 10, 0, frame);
+    int n = 0;
+    memcpy(buf, frame, len - 2);          // 只有前半帧
+    n += len - 2;
+    n += joystick(2, 20, 0, buf + n);
+    n += joystick(3, 30, 0, buf + n);
+
+    FeedLog log = feedAll(parser, buf, n);
+    // 截断帧吃掉了第二帧的开头，CRC失败后从缓冲中重新同步；
+    // 第二帧若被整帧留在缓冲里，由下一字节或 flushIdle() 交出
+    int frames = log.frames;
+    while (parser.flushIdle() == FrameParser::Result::FRAME) {
+        frames++;
+    }
+    bool passed = frames == 2 && parser.getCrcErrors() == 1 && !parser.busy();
+    printf("  frames=%d crc_errors=%lu\n", frames, (unsigned long)parser.getCrcErrors());
+    print_test_result("截断帧后紧跟完整帧", passed);
+    return passed;
+}
+
+/**
+ * @brief 测试6: 帧头后长度非法的字节交还给文本协议
+ */
+bool test_invalid_length_rejected() {
+    FrameParser parser;
+    const uint8_t data[] = {bt_protocol::FRAME_SYNC, 'F', '\n'};
+    FeedLog log = feedAll(parser, data, sizeof(data));
+    bool passed = log.frames == 0 && log.rejected == 2 && !parser.busy();
+    print_test_result("非法长度交还文本协议", passed);
+    return passed;
+}
+
+/* ========== 主测试函数 ========== */
+
+int main() {
+    printf("========================================\n");
+    printf("     蓝牙二进制帧解析单元测试\n");
+    printf("========================================\n");
+
+    int passed = 0;
+    const int total = 6;
+
+    if (test_normal_frames()) passed++;
+    if (test_crc_error_keeps_next_frame()) passed++;
+    if (test_lost_length_byte()) passed++;
+    if (test_stray_sync_then_idle()) passed++;
+    if (test_truncated_then_frame()) passed++;
+    if (test_invalid_length_rejected()) passed++;
+
+    printf("测试完成: %d/%d 通过\n", passed, total);
+    return passed == total ? 0 : 1;
+}
@@ -14,6 +14,7 @@
  * 6. 微分滤波
  * 7. 模式切换
  * 8. 方向控制
+ * 9. 外部变化率微分（状态估计器给出 input_rate）
  */
 
 #include "stm32f1xx_hal.h"
@@ -378,6 +379,43 @@ bool test_system_simulation() {
     return converged;
 }
 
+/**
+ * @brief 测试11: 外部变化率微分
+ *
+ * compute(setpoint, input, input_rate, dt) 的D项直接取 -Kd × input_rate：
+ * 第一次调用就生效，不经过微分滤波，setpoint突变也不产生微分冲击。
+ */
+bool test_measured_rate_derivative() {
+    Debug_Printf("\r\n========== 测试11: 外部变化率微分 ==========\r\n");
+    
+    PIDController pid(1.0f, 0.0f, 0.5f);
+    pid.setOutputLimits(-100.0f, 100.0f);
+    pid.setDerivativeFilter(0.5f);  // 外部变化率不应经过滤波
+    
+    const float dt = 0.02f;
+    
+    // 第一次调用：D = -0.5 × 20 = -10，P = 1.0 × (100 - 50) = 50
+    float output1 = pid.compute(100.0f, 50.0f, 20.0f, dt);
+    float d1 = pid.getDerivative();
+    Debug_Printf("  First call - D: %.2f (expect -10.00), Output: %.2f (expect 40.00)\r\n", d1, output1);
+    
+    // setpoint 突变、测量值跳变：D 只跟随 input_rate
+    float output2 = pid.compute(20.0f, 80.0f, 20.0f, dt);
+    float d2 = pid.getDerivative();
+    Debug_Printf("  Setpoint step - D: %.2f (expect -10.00), Output: %.2f (expect -70.00)\r\n", d2, output2);
+    
+    // 变化率反向
+    pid.compute(20.0f, 80.0f, -40.0f, dt);
+    float d3 = pid.getDerivative();
+    Debug_Printf("  Rate -40 - D: %.2f (expect 20.00)\r\n", d3);
+    
+    bool passed = is_close(d1, -10.0f) && is_close(output1, 40.0f) &&
+                  is_close(d2, -10.0f) && is_close(output2, -70.0f) &&
+                  is_close(d3, 20.0f);
+    print_test_result("外部变化率微分", passed);
+    return passed;
+}
+
 /* ========== 主测试函数 ========== */
 
 extern "C" {
@@ -399,7 +437,7 @@ int main(void) {
     Debug_Printf("========================================\r\n");
     
     int passed = 0;
-    int total = 10;
+    int total = 11;
     
     // 运行所有测试
     if (test_proportional_only()) passed++;
@@ -432,6 +470,9 @@ int main(void) {
     if (test_system_simulation()) passed++;
     HAL_Delay(500);
     
+    if (test_measured_rate_derivative()) passed++;
+    HAL_Delay(500);
+    
     // 打印总结
     Debug_Printf("\r\n========================================\r\n");
     Debug_Printf("测试完成: %d/%d 通过\r\n", passed, total);
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""
+蓝牙二进制控制帧工具 - 生成/发送 bt_protocol.hpp 定义的帧
+
+功能：
+1. 按命令行生成帧：0xAA | LEN | TYPE<<4|SEQ | 载荷 | CRC8
+2. 打印十六进制（可粘贴到蓝牙调试APP的HEX发送框），或经串口直接发送
+3. 发送后读取并解析小车的回复（ACK / TELEMETRY）
+
+使用方法：
+python tools/bt_frame.py joy 60 -20                 # 打印摇杆帧
+python tools/bt_frame.py --seq 3 key F
+python tools/bt_frame.py --port COM6 param 1 40     # 设置基础速度40并等待ACK
+python tools/bt_frame.py --port COM6 telemetry      # 读取链路统计和供电电压
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+FRAME_SYNC = 0xAA
+MAX_PAYLOAD = 22
+
+MSG_JOYSTICK = 1
+MSG_KEY = 2
+MSG_PARAM_SET = 3
+MSG_TELEMETRY_REQ = 4
+MSG_TELEMETRY = 8
+MSG_ACK = 9
+MSG_LATENCY = 10
+
+ACK_NAMES = {0: "OK", 1: "参数号未知", 2: "值无效"}
+
+
+def crc8(data, crc=0):
+    """CRC-8，多项式 0x07，与 crc::crc8() 一致"""
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def encode(msg_type, seq, payload=b""):
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("载荷超过 %d 字节" % MAX_PAYLOAD)
+    body = bytes([len(payload) + 1, ((msg_type & 0x0F) << 4) | (seq & 0x0F)]) + bytes(payload)
+    return bytes([FRAME_SYNC]) + body + bytes([crc8(body)])
+
+
+def parse_frames(data):
+    """从字节流中解出所有完整帧，返回 [(类型, 序号, 载荷)]"""
+    frames = []
+    pos = 0
+    while True:
+        pos = data.find(FRAME_SYNC, pos)
+        if pos < 0 or pos + 2 > len(data):
+            return frames
+        length = data[pos + 1]
+        end = pos + length + 3
+        if length < 1 or length > MAX_PAYLOAD + 1 or end > len(data):
+            pos += 1
+            continue
+        if crc8(data[pos + 1:end - 1]) != data[end - 1]:
+            pos += 1
+            continue
+        header = data[pos + 2]
+        frames.append((header >> 4, header & 0x0F, data[pos + 3:end - 1]))
+        pos = end
+
+
+def describe(msg_type, seq, payload):
+    if msg_type == MSG_ACK and len(payload) >= 2:
+        return "ACK seq=%d %s" % (payload[0], ACK_NAMES.get(payload[1], payload[1]))
+    if msg_type == MSG_TELEMETRY and len(payload) >= 10:
+        ok, crc_err, lost, dup, dropped = struct.unpack_from("<5H", payload)
+        text = "TELEMETRY 有效帧=%d CRC错误=%d 丢失=%d 重复=%d 队列丢弃=%d字节" % (ok, crc_err, lost, dup, dropped)
+        if len(payload) >= 14:
+            supply_mv, gain_q8 = struct.unpack_from("<2H", payload, 10)
+            text += " 供电=%dmV 增益=%.2f" % (supply_mv, gain_q8 / 256.0)
+        return text
+    if msg_type == MSG_LATENCY and len(payload) >= 22:
+        sender, rx_us, tx_us, parse, accept, ccr, edge, settle = struct.unpack_from("<3I5H", payload)
+        return "LATENCY ts=%d 到达=%dus 回传=%dus 解析=%d 仲裁=%d CCR=%d PWM沿=%dus 到位=%dms" % (
+            sender, rx_us, tx_us, parse, accept, ccr, edge, settle)
+    return "type=%d seq=%d payload=%s" % (msg_type, seq, payload.hex(" "))
+
+
+def build(args):
+    if args.cmd == "joy":
+        for v in (args.straight, args.turn):
+            if not -100 <= v <= 100:
+                sys.exit("摇杆值范围 -100 ~ 100")
+        return encode(MSG_JOYSTICK, args.seq, struct.pack("<bb", args.straight, args.turn))
+    if args.cmd == "key":
+        return encode(MSG_KEY, args.seq, args.key[:1].encode("ascii"))
+    if args.cmd == "param":
+        return encode(MSG_PARAM_SET, args.seq, struct.pack("<Bh", args.id, args.value))
+    return encode(MSG_TELEMETRY_REQ, args.seq)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="蓝牙二进制控制帧工具")
+    parser.add_argument("--seq", type=int, default=0, help="序号（0-15，连续发送时每帧加1）")
+    parser.add_argument("--port", help="经串口发送（需要 pyserial），不指定时只打印")
+    parser.add_argument("--baud", type=int, default=115200, help="波特率")
+    parser.add_argument("--wait", type=float, default=0.3, help="等待回复的时间（秒）")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    joy = sub.add_parser("joy", help="摇杆：直行 转向（-100 ~ 100）")
+    joy.add_argument("straight", type=int)
+    joy.add_argument("turn", type=int)
+
+    key = sub.add_parser("key", help="按键字符（F/B/L/R/W/X/Y/Z/U/S/D）")
+    key.add_argument("key")
+
+    param = sub.add_parser("param", help="设置参数：编号 值（0超时ms/1基础速度/2最大速度/3调速步进/4转向灵敏度/"
+                                        "5摇杆死区/6摇杆expo/7原地最大转向/8全速最大转向）")
+    param.add_argument("id", type=int)
+    param.add_argument("value", type=int)
+
+    sub.add_parser("telemetry", help="读取链路统计和供电电压")
+
+    args = parser.parse_args()
+    frame = build(args)
+    print(frame.hex(" ").upper())
+
+    if not args.port:
+        return
+    try:
+        import serial
+    except ImportError:
+        sys.exit("需要 pyserial：pip install pyserial")
+    with serial.Serial(args.port, args.baud, timeout=0.05) as ser:
+        ser.reset_input_buffer()
+        ser.write(frame)
+        data = bytearray()
+        deadline = time.time() + args.wait
+        while time.time() < deadline:
+            data += ser.read(64)
+        for msg_type, seq, payload in parse_frames(bytes(data)):
+            print(describe(msg_type, seq, payload))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+"""
+指令延迟统计工具 - 按阶段统计 上位机 → 蓝牙/串口 → 解析 → 仲裁 → PWM 的延迟分布
+
+功能：
+1. 按固定频率发送附带上位机微秒时间戳的摇杆帧（固件需 LATENCY_PROBE_ENABLE=1）
+2. 收集小车回传的 LATENCY 帧（到达/回传时刻 + 解析/仲裁/CCR/PWM沿/速度到位打点）
+3. 用每条样本的四个时刻（发送/到达/回传/接收）估计两边时钟的偏差和漂移：
+   每组取往返时间最短的样本，对偏差做线性拟合（斜率即晶振频差）
+4. 输出每一段的 最小/p50/p90/p99/最大，可保存原始样本为CSV，之后离线重新统计
+
+发送端接在 ESP32-S3 串口（或USB转串口直连 USART2）上，因此“上行”包含
+上位机串口 + 转发链路 + STM32 UART，手机APP侧的延迟需另行测量。
+
+使用方法：
+python tools/latency_report.py --port COM6                          # 10Hz 发送200帧，原地不动
+python tools/latency_report.py --port COM6 -n 500 --rate 20 --straight 30 --toggle 10
+python tools/latency_report.py --port COM6 --save lat.csv
+python tools/latency_report.py --load lat.csv                       # 离线统计
+"""
+
+import argparse
+import csv
+import struct
+import sys
+import time
+
+from bt_frame import MSG_JOYSTICK, MSG_LATENCY, encode, parse_frames
+
+MISSING = 0xFFFF
+WRAP = 1 << 32
+
+FIELDS = ["t0", "t1", "t2", "t3", "parse", "accept", "ccr", "edge", "settle_ms"]
+
+
+def host_us():
+    return time.perf_counter_ns() // 1000
+
+
+def unwrap(values):
+    """把回绕的 uint32 微秒计数展开成单调序列"""
+    out = []
+    base = 0
+    prev = None
+    for v in values:
+        if prev is not None and v + base < prev - WRAP // 2:
+            base += WRAP
+        prev = v + base
+        out.append(prev)
+    return out
+
+
+def collect(args):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("需要 pyserial：pip install pyserial")
+
+    sent = {}         # 时间戳低32位 -> 完整发送时刻
+    replies = {}      # 时间戳低32位 -> (接收时刻, 载荷)
+    buf = bytearray()
+    period = 1.0 / args.rate
+
+    with serial.Serial(args.port, args.baud, timeout=0) as ser:
+        ser.reset_input_buffer()
+
+        def drain():
+            data = ser.read(4096)
+            if not data:
+                return
+            now = host_us()
+            buf.extend(data)
+            for msg_type, _, payload in parse_frames(bytes(buf)):
+                if msg_type == MSG_LATENCY and len(payload) >= 22:
+                    ts = struct.unpack_from("<I", payload)[0]
+                    if ts in sent and ts not in replies:
+                        replies[ts] = (now, payload)
+            # 只保留末尾可能不完整的一帧
+            del buf[:max(0, len(buf) - 32)]
+
+        next_send = time.perf_counter()
+        for i in range(args.count):
+            straight = args.straight
+            if args.toggle and (i // args.toggle) % 2:
+                straight = 0
+            t0 = host_us()
+            ts = t0 % WRAP
+            frame = encode(MSG_JOYSTICK, i, struct.pack("<bbI", straight, args.turn, ts))
+            ser.write(frame)
+            sent[ts] = t0
+
+            next_send += period
+            while time.perf_counter() < next_send:
+                drain()
+                time.sleep(0.0005)
+
+        # 等最后一条的速度到位/超时回传
+        deadline = time.perf_counter() + args.wait
+        while time.perf_counter() < deadline:
+            drain()
+            time.sleep(0.001)
+        ser.write(encode(MSG_JOYSTICK, args.count, struct.pack("<bb", 0, 0)))
+
+    print("发送 %d 帧，收到回传 %d 条" % (len(sent), len(replies)))
+    if not replies:
+        sys.exit("没有回传：确认固件 LATENCY_PROBE_ENABLE=1，且已设置回复串口（setReplyUart() 或 startDmaReception()）")
+
+    rows = []
+    for ts, (t3, payload) in sorted(replies.items(), key=lambda kv: sent[kv[0]]):
+        _, rx_us, tx_us, parse, accept, ccr, edge, settle = struct.unpack_from("<3I5H", payload)
+        rows.append([sent[ts], rx_us, tx_us, t3, parse, accept, ccr, edge, settle])
+    # 小车时钟单独展开（到达与回传穿插在同一序列中）
+    mcu = unwrap([v for r in rows for v in (r[1], r[2])])
+    for k, r in enumerate(rows):
+        r[1], r[2] = mcu[2 * k], mcu[2 * k + 1]
+    return rows
+
+
+def load(path):
+    with open(path, newline="") as f:
+        return [[int(r[k]) for k in FIELDS] for r in csv.DictReader(f)]
+
+
+def save(path, rows):
+    with open(path, "w", newline="") as f:
+        w = csv.writer(f)
+        w.writerow(FIELDS)
+        w.writerows(rows)
+    print("样本已保存到 %s" % path)
+
+
+def estimate_clock(rows, group):
+    """
+    估计 小车时钟 - 上位机时钟 = a + b*(t0 - t_ref)
+
+    单条样本：offset = ((t1-t0) + (t2-t3)) / 2，往返 delay = (t3-t0) - (t2-t1)，
+    上下行不对称时 offset 误差不超过 delay/2，所以每组只取 delay 最小的样本。
+    """
+    best = []
+    for k in range(0, len(rows), group):
+        chunk = rows[k:k + group]
+        t0, t1, t2, t3 = min(chunk, key=lambda r: (r[3] - r[0]) - (r[2] - r[1]))[:4]
+        best.append((t0, ((t1 - t0) + (t2 - t3)) / 2.0, (t3 - t0) - (t2 - t1)))
+
+    t_ref = best[0][0]
+    if len(best) < 2:
+        return t_ref, best[0][1], 0.0, best
+    xs = [b[0] - t_ref for b in best]
+    ys = [b[1] for b in best]
+    mx = sum(xs) / len(xs)
+    my = sum(ys) / len(ys)
+    sxx = sum((x - mx) ** 2 for x in xs)
+    slope = sum((x - mx) * (y - my) for x, y in zip(xs, ys)) / sxx if sxx else 0.0
+    return t_ref, my - slope * mx, slope, best
+
+
+def percentile(sorted_values, p):
+    idx = min(len(sorted_values) - 1, int(round(p / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[idx]
+
+
+def report(rows, group):
+    t_ref, a, b, best = estimate_clock(rows, group)
+    print("\n时钟偏差：%.1f us（t=0时），漂移 %.1f ppm，取 %d 组最短往返样本（最短往返 %.2f ms）"
+          % (a, b * 1e6, len(best), min(x[2] for x in best) / 1000.0))
+
+    def offset(t0):
+        return a + b * (t0 - t_ref)
+
+    stages = [
+        ("上行（发送→到达）", lambda r: r[1] - offset(r[0]) - r[0]),
+        ("解析（到达→解析完成）", lambda r: r[4]),
+        ("仲裁（→仲裁器选中）", lambda r: None if r[5] == MISSING else r[5] - r[4]),
+        ("CCR写入（→Motor::commit）", lambda r: None if r[6] == MISSING else
+                                          r[6] - (r[4] if r[5] == MISSING else r[5])),
+        ("PWM帧等待（CCR→新脉宽）", lambda r: None if r[6] == MISSING else r[7] - r[6]),
+        ("端到端（发送→PWM沿）", lambda r: None if r[7] == MISSING else
+                                      r[1] - offset(r[0]) - r[0] + r[7]),
+        ("速度到位（发送→斜坡结束）", lambda r: None if r[8] == MISSING else
+                                        r[1] - offset(r[0]) - r[0] + r[8] * 1000),
+        ("下行（回传→接收）", lambda r: r[3] - (r[2] - offset(r[0]))),
+        ("往返（不含小车内处理）", lambda r: (r[3] - r[0]) - (r[2] - r[1])),
+    ]
+
+    print("\n%-28s %6s %9s %9s %9s %9s %9s  (ms)" % ("阶段", "样本", "最小", "p50", "p90", "p99", "最大"))
+    for name, fn in stages:
+        values = sorted(v for v in (fn(r) for r in rows) if v is not None)
+        if not values:
+            print("%-28s %6d   （未到达）" % (name, 0))
+            continue
+        print("%-28s %6d %9.2f %9.2f %9.2f %9.2f %9.2f" % (
+            name, len(values), values[0] / 1000.0, percentile(values, 50) / 1000.0,
+            percentile(values, 90) / 1000.0, percentile(values, 99) / 1000.0, values[-1] / 1000.0))
+
+    missing = sum(1 for r in rows if r[5] == MISSING)
+    if missing:
+        print("\n%d 条未被仲裁器选中（更高优先级指令源占用，或 RemoteControl 未接仲裁器）" % missing)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="指令端到端延迟统计")
+    parser.add_argument("--port", help="串口（接 ESP32-S3 或直连 USART2）")
+    parser.add_argument("--baud", type=int, default=115200, help="波特率")
+    parser.add_argument("-n", "--count", type=int, default=200, help="发送帧数")
+    parser.add_argument("--rate", type=float, default=10.0, help="发送频率（Hz）")
+    parser.add_argument("--straight", type=int, default=0, help="摇杆直行值（-100 ~ 100）")
+    parser.add_argument("--turn", type=int, default=0, help="摇杆转向值（-100 ~ 100）")
+    parser.add_argument("--toggle", type=int, default=0,
+                        help="每N帧在 --straight 与0之间切换，用于测量斜坡（0=不切换）")
+    parser.add_argument("--wait", type=float, default=1.5, help="发送结束后等待回传的时间（秒）")
+    parser.add_argument("--group", type=int, default=20, help="时钟估计每组样本数")
+    parser.add_argument("--save", help="保存原始样本到CSV")
+    parser.add_argument("--load", help="从CSV读取样本（不连接串口）")
+    args = parser.parse_args()
+
+    if args.load:
+        rows = load(args.load)
+    elif args.port:
+        for v in (args.straight, args.turn):
+            if not -100 <= v <= 100:
+                sys.exit("摇杆值范围 -100 ~ 100")
+        rows = collect(args)
+    else:
+        sys.exit("需要 --port 或 --load")
+
+    if args.save:
+        save(args.save, rows)
+    report(rows, max(1, args.group))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+"""
+延迟格式化日志解码工具 - 把 DLOG() 二进制帧还原为文本
+
+功能：
+1. 从固件ELF的 .logfmt 段读出全部格式字符串（地址低16位即帧中的ID）
+2. 解析串口数据流：0xA5 | LEN | ID(2) | 参数... | CRC8，CRC错误的帧按普通字节处理
+3. 按格式字符串中的转换说明符依次解码参数（zigzag变长整数 / float / 字符串）并格式化
+4. 非帧数据（Debug_Printf 文本、启动信息）原样输出
+
+使用方法：
+python tools/log_decoder.py .pio/build/dev/firmware.elf capture.bin
+python tools/log_decoder.py .pio/build/dev/firmware.elf --port COM5 --baud 115200
+python tools/log_decoder.py firmware.elf --list          # 列出所有格式字符串及ID
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+MAX_PAYLOAD = 64
+
+# 转换说明符：标志、宽度、精度、长度修饰、类型
+SPEC_RE = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|j|z|t|L)?([diouxXeEfFgGcspn%])")
+
+
+def crc8(data, crc=0):
+    """CRC-8，多项式 0x07，与 crc::crc8() 一致"""
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+def load_formats(elf_path):
+    """读取ELF32的 .logfmt 段，返回 {ID: 格式字符串}"""
+    with open(elf_path, "rb") as f:
+        elf = f.read()
+    if elf[:4] != b"\x7fELF" or elf[4] != 1:
+        sys.exit("%s 不是ELF32文件" % elf_path)
+    endian = "<" if elf[5] == 1 else ">"
+    shoff, = struct.unpack_from(endian + "I", elf, 0x20)
+    shentsize, shnum, shstrndx = struct.unpack_from(endian + "HHH", elf, 0x2E)
+
+    sections = []
+    for i in range(shnum):
+        name, _, _, addr, offset, size = struct.unpack_from(endian + "IIIIII", elf, shoff + i * shentsize)
+        sections.append((name, addr, offset, size))
+    strtab_off = sections[shstrndx][2]
+
+    formats = {}
+    for name, addr, offset, size in sections:
+        end = elf.index(b"\0", strtab_off + name)
+        if elf[strtab_off + name:end] != b".logfmt":
+            continue
+        data = elf[offset:offset + size]
+        pos = 0
+        while pos < len(data):
+            if data[pos] == 0:  # 对齐填充
+                pos += 1
+                continue
+            end = data.index(b"\0", pos)
+            fid = (addr + pos) & 0xFFFF
+            if fid in formats:
+                print("警告: ID 0x%04X 重复（.logfmt 超过64KB？）" % fid, file=sys.stderr)
+            formats[fid] = data[pos:end].decode("utf-8", errors="replace")
+            pos = end + 1
+    if not formats:
+        sys.exit("%s 中没有 .logfmt 段（固件未启用 DEBUG_LOG_DEFERRED？）" % elf_path)
+    return formats
+
+
+class ArgReader:
+    """按编码规则从参数字节中读取值"""
+
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            b = self.data[self.pos]
+            self.pos += 1
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                break
+        return (value >> 1) ^ -(value & 1)  # zigzag
+
+    def float32(self):
+        value, = struct.unpack_from("<f", self.data, self.pos)
+        self.pos += 4
+        return value
+
+    def string(self):
+        n = self.data[self.pos]
+        text = self.data[self.pos + 1:self.pos + 1 + n].decode("utf-8", errors="replace")
+        self.pos += 1 + n
+        return text
+
+
+def render(fmt, args):
+    """按C语义解码参数并格式化"""
+    reader = ArgReader(args)
+    out = []
+    last = 0
+    for m in SPEC_RE.finditer(fmt):
+        out.append(fmt[last:m.start()])
+        last = m.end()
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if width == "*":
+            width = str(reader.varint())
+        if prec == "*":
+            prec = str(reader.varint())
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+
+        if conv in "eEfFgG":
+            value = reader.float32()
+        elif conv == "s":
+            value = reader.string()
+        elif conv == "p":
+            value = reader.varint() & 0xFFFFFFFF
+            spec, conv = "0x%08", "X"
+        else:
+            value = reader.varint()
+            if conv in "ouxX":
+                value &= 0xFFFFFFFFFFFFFFFF if length in ("ll", "j") else 0xFFFFFFFF
+            elif conv == "c":
+                value = chr(value & 0xFF)
+            elif conv == "n":
+                continue
+        out.append((spec + conv) % value)
+    out.append(fmt[last:])
+    if reader.pos != len(args):
+        out.append(" <参数长度不符 %d/%d>" % (reader.pos, len(args)))
+    return "".join(out)
+
+
+def decode_stream(chunks, formats, write):
+    """解析数据流，chunks 为字节块迭代器，write 接收解码后的文本"""
+    buf = bytearray()
+    text = bytearray()  # 非帧字节；0xA5 可能是中文UTF-8的中间字节，攒到换行再解码
+
+    def flush_text(all_bytes=False):
+        cut = len(text) if all_bytes else text.rfind(b"\n") + 1
+        if cut > 0:
+            write(text[:cut].decode("utf-8", errors="replace"))
+            del text[:cut]
+
+    for chunk in chunks:
+        buf += chunk
+        while buf:
+            start = buf.find(FRAME_SYNC)
+            if start < 0:
+                text += buf
+                buf.clear()
+                break
+            text += buf[:start]
+            del buf[:start]
+            if len(buf) < 2:
+                break
+            length = buf[1]
+            if length < 2 or length > MAX_PAYLOAD:
+                text += buf[:1]
+                del buf[:1]
+                continue
+            if len(buf) < length + 3:
+                break  # 等待后续数据
+            frame = bytes(buf[:length + 3])
+            if crc8(frame[1:-1]) != frame[-1]:
+                text += buf[:1]
+                del buf[:1]
+                continue
+            del buf[:length + 3]
+            flush_text(all_bytes=True)
+            fid = frame[2] | (frame[3] << 8)
+            fmt = formats.get(fid)
+            if fmt is None:
+                write("<未知日志ID 0x%04X>\r\n" % fid)
+                continue
+            try:
+                write(render(fmt, frame[4:-1]))
+            except (IndexError, struct.error, TypeError, ValueError) as e:
+                write("<解码失败 0x%04X: %s>\r\n" % (fid, e))
+        flush_text()
+    text += buf
+    flush_text(all_bytes=True)
+
+
+def file_chunks(path):
+    with open(path, "rb") as f:
+        while True:
+            chunk = f.read(4096)
+            if not chunk:
+                return
+            yield chunk
+
+
+def serial_chunks(port, baud):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("需要 pyserial：pip install pyserial")
+    with serial.Serial(port, baud, timeout=0.1) as ser:
+        while True:
+            chunk = ser.read(ser.in_waiting or 1)
+            if chunk:
+                yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description="延迟格式化日志解码工具")
+    parser.add_argument("elf", help="固件ELF（例如 .pio/build/dev/firmware.elf）")
+    parser.add_argument("capture", nargs="?", help="串口原始数据文件（二进制）")
+    parser.add_argument("--port", help="直接从串口读取（需要 pyserial）")
+    parser.add_argument("--baud", type=int, default=115200, help="波特率")
+    parser.add_argument("--list", action="store_true", help="列出所有格式字符串及ID")
+    args = parser.parse_args()
+
+    formats = load_formats(args.elf)
+    if args.list:
+        for fid, fmt in sorted(formats.items()):
+            print("0x%04X  %r" % (fid, fmt))
+        return
+
+    if args.port:
+        chunks = serial_chunks(args.port, args.baud)
+    elif args.capture:
+        chunks = file_chunks(args.capture)
+    else:
+        sys.exit("需要指定 capture 文件或 --port")
+
+    def write(text):
+        sys.stdout.write(text.replace("\r\n", "\n"))
+        sys.stdout.flush()
+
+    try:
+        decode_stream(chunks, formats, write)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+"""
+运动脚本汇编器 - 把文本脚本编译成 MotionScript 字节码
+
+功能：
+1. 每行一条指令，# 之后为注释，助记符不区分大小写
+2. 输出串口上传命令（$SC / $S+hex / $SR），或C数组（--c-array，用于写进Flash）
+3. 可选直接通过串口发送（--port，需要 pyserial）
+
+指令（速度单位 %，转向正值左转）：
+    DRIVE_TIME  straight turn ms
+    DRIVE_DIST  straight turn mm
+    ARC         speed radius_cm deg      # radius_cm 正值向左、负值向右
+    SPOT_UNTIL_LINE turn [timeout_ms]
+    SPOT_ANGLE  turn deg                  # 需要先完成原地转向校准
+    FOLLOW_TO_MARKER [timeout_ms]
+    WAIT        ms
+    REPEAT      [count]                   # 0或省略 = 无限
+    NEXT
+    END
+
+使用方法：
+python tools/motion_script_asm.py square.ms
+python tools/motion_script_asm.py square.ms --c-array
+python tools/motion_script_asm.py square.ms --port COM5 --save --run
+"""
+
+import argparse
+import struct
+import sys
+
+MAX_LENGTH = 60   # 与 MotionScript::MAX_LENGTH 一致
+MAX_CHUNK = 28    # 与 BluetoothControl::MAX_SCRIPT_CHUNK 一致
+MAX_LOOP_DEPTH = 4
+
+# 助记符: (操作码, 参数格式, 参数个数下限)
+OPCODES = {
+    "END": (0x00, "", 0),
+    "DRIVE_TIME": (0x01, "bbH", 3),
+    "DRIVE_DIST": (0x02, "bbH", 3),
+    "ARC": (0x03, "bbH", 3),
+    "SPOT_UNTIL_LINE": (0x04, "bH", 1),
+    "FOLLOW_TO_MARKER": (0x05, "H", 0),
+    "WAIT": (0x06, "H", 1),
+    "REPEAT": (0x07, "B", 0),
+    "NEXT": (0x08, "", 0),
+    "SPOT_ANGLE": (0x09, "bH", 2),
+}
+
+
+class AsmError(Exception):
+    pass
+
+
+def assemble_line(line, lineno):
+    """编译一行，返回字节码（空行返回 b''）"""
+    text = line.split("#", 1)[0].strip()
+    if not text:
+        return b""
+    parts = text.replace(",", " ").split()
+    name = parts[0].upper()
+    if name not in OPCODES:
+        raise AsmError(f"第{lineno}行: 未知指令 {parts[0]}")
+    op, fmt, required = OPCODES[name]
+
+    try:
+        args = [int(p, 0) for p in parts[1:]]
+    except ValueError:
+        raise AsmError(f"第{lineno}行: 参数必须是整数")
+    if len(args) < required or len(args) > len(fmt):
+        raise AsmError(f"第{lineno}行: {name} 需要 {required}~{len(fmt)} 个参数")
+    args += [0] * (len(fmt) - len(args))
+
+    if name in ("DRIVE_TIME", "DRIVE_DIST", "ARC", "SPOT_UNTIL_LINE", "SPOT_ANGLE"):
+        if not -100 <= args[0] <= 100:
+            raise AsmError(f"第{lineno}行: 速度超出 -100~100")
+    if name in ("DRIVE_TIME", "DRIVE_DIST") and not -100 <= args[1] <= 100:
+        raise AsmError(f"第{lineno}行: 转向超出 -100~100")
+    if name == "ARC" and args[1] == 0:
+        raise AsmError(f"第{lineno}行: ARC 半径不能为0（原地转向用 SPOT_UNTIL_LINE）")
+
+    try:
+        return bytes([op]) + struct.pack("<" + fmt, *args)
+    except struct.error:
+        raise AsmError(f"第{lineno}行: 参数超出范围")
+
+
+def assemble(source):
+    """编译整个脚本，检查 REPEAT/NEXT 配对与总长度"""
+    code = bytearray()
+    depth = 0
+    last_op = None
+    for lineno, line in enumerate(source.splitlines(), 1):
+        chunk = assemble_line(line, lineno)
+        if chunk[:1] == b"\x07":
+            depth += 1
+            if depth > MAX_LOOP_DEPTH:
+                raise AsmError(f"第{lineno}行: REPEAT 嵌套超过 {MAX_LOOP_DEPTH} 层")
+        elif chunk[:1] == b"\x08":
+            if depth == 0:
+                raise AsmError(f"第{lineno}行: NEXT 没有对应的 REPEAT")
+            if last_op == 0x07:
+                raise AsmError(f"第{lineno}行: 循环体为空")
+            depth -= 1
+        if chunk:
+            last_op = chunk[0]
+        code += chunk
+    if depth != 0:
+        raise AsmError("REPEAT 缺少 NEXT")
+    if last_op != 0x00:
+        code.append(0x00)
+    if len(code) > MAX_LENGTH:
+        raise AsmError(f"脚本 {len(code)} 字节，超过上限 {MAX_LENGTH}")
+    return bytes(code)
+
+
+def upload_lines(code, save=False, run=False):
+    """生成串口上传命令"""
+    lines = ["$SC"]
+    for i in range(0, len(code), MAX_CHUNK):
+        lines.append("$S+" + code[i:i + MAX_CHUNK].hex().upper())
+    if save:
+        lines.append("$SW")
+    if run:
+        lines.append("$SR")
+    return lines
+
+
+def c_array(code, name):
+    body = ", ".join(f"0x{b:02X}" for b in code)
+    return f"static const uint8_t {name}[] = {{{body}}};  // {len(code)} 字节"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="运动脚本汇编器")
+    parser.add_argument("source", help="脚本文件（- 表示标准输入）")
+    parser.add_argument("--c-array", metavar="NAME", nargs="?", const="kScript",
+                        help="输出C数组而不是上传命令")
+    parser.add_argument("--save", action="store_true", help="上传后保存到EEPROM（$SW）")
+    parser.add_argument("--run", action="store_true", help="上传后立即运行（$SR）")
+    parser.add_argument("--port", help="直接发送到串口（如 COM5 或 /dev/ttyUSB0）")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    source = sys.stdin.read() if args.source == "-" else open(args.source, encoding="utf-8").read()
+    try:
+        code = assemble(source)
+    except AsmError as e:
+        print(f"错误: {e}", file=sys.stderr)
+        return 1
+
+    if args.c_array:
+        print(c_array(code, args.c_array))
+        return 0
+
+    lines = upload_lines(code, args.save, args.run)
+    if args.port:
+        import time
+        import serial
+        with serial.Serial(args.port, args.baud, timeout=1) as port:
+            for line in lines:
+                port.write((line + "\n").encode("ascii"))
+                time.sleep(0.05)
+        print(f"已发送 {len(code)} 字节到 {args.port}")
+    else:
+        print("\n".join(lines))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
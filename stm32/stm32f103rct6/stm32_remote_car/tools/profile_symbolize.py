@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+采样分析器符号化工具 - 把PC地址直方图映射为函数级统计
+
+功能：
+1. 从串口日志中提取 PROFILE BEGIN ... PROFILE END 段
+2. 通过 arm-none-eabi-nm 读取ELF中的函数符号（地址、大小）
+3. 按地址桶与函数的重叠比例分摊采样数，输出按占比排序的扁平统计
+
+使用方法：
+python tools/profile_symbolize.py capture.log .pio/build/dev/firmware.elf
+python tools/profile_symbolize.py capture.log firmware.elf --top 30 --nm /opt/gcc/bin/arm-none-eabi-nm
+"""
+
+import argparse
+import bisect
+import re
+import subprocess
+import sys
+from collections import defaultdict
+
+HEADER_RE = re.compile(
+    r"PROFILE BEGIN base=0x([0-9A-Fa-f]+) shift=(\d+) hz=(\d+) samples=(\d+) other=(\d+)")
+BUCKET_RE = re.compile(r"^\s*0x([0-9A-Fa-f]+)\s+(\d+)\s*$")
+
+
+def parse_capture(path):
+    """解析最后一段 PROFILE 输出，返回 (header, {地址: 次数})"""
+    header = None
+    buckets = {}
+    in_block = False
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            m = HEADER_RE.search(line)
+            if m:
+                header = {
+                    "base": int(m.group(1), 16),
+                    "shift": int(m.group(2)),
+                    "hz": int(m.group(3)),
+                    "samples": int(m.group(4)),
+                    "other": int(m.group(5)),
+                }
+                buckets = {}
+                in_block = True
+                continue
+            if not in_block:
+                continue
+            if "PROFILE END" in line:
+                in_block = False
+                continue
+            m = BUCKET_RE.match(line)
+            if m:
+                buckets[int(m.group(1), 16)] = int(m.group(2))
+    if header is None:
+        sys.exit("未找到 PROFILE BEGIN 段")
+    return header, buckets
+
+
+def load_symbols(elf, nm):
+    """读取函数符号，返回按地址排序的 [(start, end, name)]"""
+    try:
+        out = subprocess.run([nm, "-C", "-S", "-n", "--defined-only", elf],
+                             check=True, capture_output=True, text=True).stdout
+    except (OSError, subprocess.CalledProcessError) as e:
+        sys.exit("运行 %s 失败: %s" % (nm, e))
+
+    symbols = []
+    for line in out.splitlines():
+        parts = line.split(None, 3)
+        if len(parts) < 4 or parts[2] not in "tTwW":
+            continue
+        addr = int(parts[0], 16) & ~1  # 去掉Thumb位
+        size = int(parts[1], 16)
+        if size == 0:
+            continue
+        symbols.append((addr, addr + size, parts[3]))
+    symbols.sort()
+    return symbols
+
+
+def attribute(buckets, bucket_size, symbols):
+    """按地址桶与函数区间的重叠字节数分摊采样"""
+    starts = [s[0] for s in symbols]
+    per_func = defaultdict(float)
+    for base, count in buckets.items():
+        end = base + bucket_size
+        i = max(bisect.bisect_right(starts, base) - 1, 0)
+        covered = 0
+        hits = []
+        while i < len(symbols) and symbols[i][0] < end:
+            lo = max(base, symbols[i][0])
+            hi = min(end, symbols[i][1])
+            if hi > lo:
+                hits.append((symbols[i][2], hi - lo))
+                covered += hi - lo
+            i += 1
+        if covered == 0:
+            per_func["<unknown 0x%08X>" % base] += count
+            continue
+        for name, overlap in hits:
+            per_func[name] += count * overlap / covered
+    return per_func
+
+
+def main():
+    parser = argparse.ArgumentParser(description="采样分析器符号化工具")
+    parser.add_argument("capture", help="包含 PROFILE 输出的串口日志")
+    parser.add_argument("elf", help="固件ELF（例如 .pio/build/dev/firmware.elf）")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm 可执行文件")
+    parser.add_argument("--top", type=int, default=40, help="显示前N个函数")
+    args = parser.parse_args()
+
+    header, buckets = parse_capture(args.capture)
+    symbols = load_symbols(args.elf, args.nm)
+    per_func = attribute(buckets, 1 << header["shift"], symbols)
+
+    total = header["samples"]
+    if total == 0:
+        sys.exit("没有采样数据")
+
+    print("采样频率 %d Hz，总采样 %d（约 %.1f 秒），Flash之外 %d" %
+          (header["hz"], total, total / max(header["hz"], 1), header["other"]))
+    print("%8s %7s %7s  %s" % ("samples", "self%", "cum%", "function"))
+    cum = 0.0
+    for name, count in sorted(per_func.items(), key=lambda kv: -kv[1])[:args.top]:
+        cum += count
+        print("%8.0f %6.2f%% %6.2f%%  %s" % (count, 100.0 * count / total, 100.0 * cum / total, name))
+
+
+if __name__ == "__main__":
+    main()